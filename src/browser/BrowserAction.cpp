@@ -19,7 +19,6 @@
 
 #include "BrowserService.h"
 #include "BrowserSettings.h"
-#include "BrowserShared.h"
 #include "config-keepassx.h"
 #include "core/Global.h"
 
@@ -53,6 +52,25 @@ namespace
         ERROR_KEEPASS_NO_GROUPS_FOUND = 16,
         ERROR_KEEPASS_CANNOT_CREATE_NEW_GROUP = 17
     };
+
+    // Upper bound for the number of passwords a single generate-password request can ask for
+    constexpr int MaxGeneratedPasswords = 1000;
+
+    // Requests are handled on a worker thread, the databases and settings are only accessed on the GUI thread
+    template <typename T> T onGuiThread(const std::function<T()>& call)
+    {
+        return browserService()->runOnGuiThread(call);
+    }
+
+    QString databaseHash(bool legacy = false)
+    {
+        return onGuiThread<QString>([legacy] { return browserService()->getDatabaseHash(legacy); });
+    }
+}
+
+BrowserAction::~BrowserAction()
+{
+    resetSession();
 }
 
 QJsonObject BrowserAction::processClientMessage(const QJsonObject& json)
@@ -72,10 +90,11 @@ QJsonObject BrowserAction::processClientMessage(const QJsonObject& json)
         return getErrorReply(action, ERROR_KEEPASS_INCORRECT_ACTION);
     }
 
-    if (action.compare("change-public-keys", Qt::CaseSensitive) != 0 && !browserService()->isDatabaseOpened()) {
+    if (action.compare("change-public-keys", Qt::CaseSensitive) != 0
+        && !onGuiThread<bool>([] { return browserService()->isDatabaseOpened(); })) {
         if (m_clientPublicKey.isEmpty()) {
             return getErrorReply(action, ERROR_KEEPASS_CLIENT_PUBLIC_KEY_NOT_RECEIVED);
-        } else if (!browserService()->openDatabase(triggerUnlock)) {
+        } else if (!onGuiThread<bool>([triggerUnlock] { return browserService()->openDatabase(triggerUnlock); })) {
             return getErrorReply(action, ERROR_KEEPASS_DATABASE_NOT_OPENED);
         }
     }
@@ -138,6 +157,7 @@ QJsonObject BrowserAction::handleChangePublicKeys(const QJsonObject& json, const
         return getErrorReply(action, ERROR_KEEPASS_ENCRYPTION_KEY_UNRECOGNIZED);
     }
 
+    resetSession();
     m_clientPublicKey = clientPublicKey;
     m_publicKey = publicKey;
     m_secretKey = secretKey;
@@ -151,7 +171,7 @@ QJsonObject BrowserAction::handleChangePublicKeys(const QJsonObject& json, const
 
 QJsonObject BrowserAction::handleGetDatabaseHash(const QJsonObject& json, const QString& action)
 {
-    const QString hash = browserService()->getDatabaseHash();
+    const QString hash = databaseHash();
     const QString nonce = json.value("nonce").toString();
     const QString encrypted = json.value("message").toString();
     const QJsonObject decrypted = decryptMessage(encrypted, nonce);
@@ -174,7 +194,7 @@ QJsonObject BrowserAction::handleGetDatabaseHash(const QJsonObject& json, const
         // Update a legacy database hash if found
         const QJsonArray hashes = decrypted.value("connectedKeys").toArray();
         if (!hashes.isEmpty()) {
-            const QString legacyHash = browserService()->getDatabaseHash(true);
+            const QString legacyHash = databaseHash(true);
             if (hashes.contains(legacyHash)) {
                 message["oldHash"] = legacyHash;
             }
@@ -188,7 +208,7 @@ QJsonObject BrowserAction::handleGetDatabaseHash(const QJsonObject& json, const
 
 QJsonObject BrowserAction::handleAssociate(const QJsonObject& json, const QString& action)
 {
-    const QString hash = browserService()->getDatabaseHash();
+    const QString hash = databaseHash();
     const QString nonce = json.value("nonce").toString();
     const QString encrypted = json.value("message").toString();
     const QJsonObject decrypted = decryptMessage(encrypted, nonce);
@@ -206,7 +226,8 @@ QJsonObject BrowserAction::handleAssociate(const QJsonObject& json, const QStrin
         // Check for identification key. If it's not found, ensure backwards compatibility and use the current public
         // key
         const QString idKey = decrypted.value("idKey").toString();
-        const QString id = browserService()->storeKey((idKey.isEmpty() ? key : idKey));
+        const QString storedKey = idKey.isEmpty() ? key : idKey;
+        const QString id = onGuiThread<QString>([&storedKey] { return browserService()->storeKey(storedKey); });
         if (id.isEmpty()) {
             return getErrorReply(action, ERROR_KEEPASS_ACTION_CANCELLED_OR_DENIED);
         }
@@ -225,7 +246,7 @@ QJsonObject BrowserAction::handleAssociate(const QJsonObject& json, const QStrin
 
 QJsonObject BrowserAction::handleTestAssociate(const QJsonObject& json, const QString& action)
 {
-    const QString hash = browserService()->getDatabaseHash();
+    const QString hash = databaseHash();
     const QString nonce = json.value("nonce").toString();
     const QString encrypted = json.value("message").toString();
     const QJsonObject decrypted = decryptMessage(encrypted, nonce);
@@ -240,7 +261,7 @@ QJsonObject BrowserAction::handleTestAssociate(const QJsonObject& json, const QS
         return getErrorReply(action, ERROR_KEEPASS_DATABASE_NOT_OPENED);
     }
 
-    const QString key = browserService()->getKey(id);
+    const QString key = onGuiThread<QString>([&id] { return browserService()->getKey(id); });
     if (key.isEmpty() || key.compare(responseKey, Qt::CaseSensitive) != 0) {
         return getErrorReply(action, ERROR_KEEPASS_ASSOCIATION_FAILED);
     }
@@ -257,7 +278,7 @@ QJsonObject BrowserAction::handleTestAssociate(const QJsonObject& json, const QS
 
 QJsonObject BrowserAction::handleGetLogins(const QJsonObject& json, const QString& action)
 {
-    const QString hash = browserService()->getDatabaseHash();
+    const QString hash = databaseHash();
     const QString nonce = json.value("nonce").toString();
     const QString encrypted = json.value("message").toString();
 
@@ -287,7 +308,8 @@ QJsonObject BrowserAction::handleGetLogins(const QJsonObject& json, const QStrin
     const QString formUrl = decrypted.value("submitUrl").toString();
     const QString auth = decrypted.value("httpAuth").toString();
     const bool httpAuth = auth.compare(TRUE_STR, Qt::CaseSensitive) == 0;
-    const QJsonArray users = browserService()->findMatchingEntries(id, siteUrl, formUrl, "", keyList, httpAuth);
+    const QJsonArray users = onGuiThread<QJsonArray>(
+        [&] { return browserService()->findMatchingEntries(id, siteUrl, formUrl, "", keyList, httpAuth); });
 
     if (users.isEmpty()) {
         return getErrorReply(action, ERROR_KEEPASS_NO_LOGINS_FOUND);
@@ -307,17 +329,20 @@ QJsonObject BrowserAction::handleGetLogins(const QJsonObject& json, const QStrin
 QJsonObject BrowserAction::handleGeneratePassword(const QJsonObject& json, const QString& action)
 {
     auto nonce = json.value("nonce").toString();
-    auto password = browserSettings()->generatePassword();
+    const auto count = qBound(1, json.value("count").toInt(1), MaxGeneratedPasswords);
+    auto passwords = onGuiThread<QJsonArray>([count] { return browserSettings()->generatePasswords(count); });
 
-    if (nonce.isEmpty() || password.isEmpty()) {
+    if (nonce.isEmpty() || passwords.isEmpty()) {
         return QJsonObject();
     }
 
     // For backwards compatibility
-    password["login"] = password["entropy"];
-
     QJsonArray arr;
-    arr.append(password);
+    for (const auto& value : asConst(passwords)) {
+        auto password = value.toObject();
+        password["login"] = password["entropy"];
+        arr.append(password);
+    }
 
     const QString newNonce = incrementNonce(nonce);
 
@@ -329,7 +354,7 @@ QJsonObject BrowserAction::handleGeneratePassword(const QJsonObject& json, const
 
 QJsonObject BrowserAction::handleSetLogin(const QJsonObject& json, const QString& action)
 {
-    const QString hash = browserService()->getDatabaseHash();
+    const QString hash = databaseHash();
     const QString nonce = json.value("nonce").toString();
     const QString encrypted = json.value("message").toString();
 
@@ -356,12 +381,13 @@ QJsonObject BrowserAction::handleSetLogin(const QJsonObject& json, const QString
     const QString groupUuid = decrypted.value("groupUuid").toString();
     const QString realm;
 
-    bool result = true;
-    if (uuid.isEmpty()) {
-        browserService()->addEntry(id, login, password, url, submitUrl, realm, group, groupUuid);
-    } else {
-        result = browserService()->updateEntry(id, uuid, login, password, url, submitUrl);
-    }
+    const bool result = onGuiThread<bool>([&] {
+        if (uuid.isEmpty()) {
+            browserService()->addEntry(id, login, password, url, submitUrl, realm, group, groupUuid);
+            return true;
+        }
+        return browserService()->updateEntry(id, uuid, login, password, url, submitUrl);
+    });
 
     const QString newNonce = incrementNonce(nonce);
 
@@ -376,7 +402,7 @@ QJsonObject BrowserAction::handleSetLogin(const QJsonObject& json, const QString
 
 QJsonObject BrowserAction::handleLockDatabase(const QJsonObject& json, const QString& action)
 {
-    const QString hash = browserService()->getDatabaseHash();
+    const QString hash = databaseHash();
     const QString nonce = json.value("nonce").toString();
     const QString encrypted = json.value("message").toString();
     const QJsonObject decrypted = decryptMessage(encrypted, nonce);
@@ -391,7 +417,10 @@ QJsonObject BrowserAction::handleLockDatabase(const QJsonObject& json, const QSt
 
     QString command = decrypted.value("action").toString();
     if (!command.isEmpty() && command.compare("lock-database", Qt::CaseSensitive) == 0) {
-        browserService()->lockDatabase();
+        onGuiThread<bool>([] {
+            browserService()->lockDatabase();
+            return true;
+        });
 
         const QString newNonce = incrementNonce(nonce);
         QJsonObject message = buildMessage(newNonce);
@@ -404,7 +433,7 @@ QJsonObject BrowserAction::handleLockDatabase(const QJsonObject& json, const QSt
 
 QJsonObject BrowserAction::handleGetDatabaseGroups(const QJsonObject& json, const QString& action)
 {
-    const QString hash = browserService()->getDatabaseHash();
+    const QString hash = databaseHash();
     const QString nonce = json.value("nonce").toString();
     const QString encrypted = json.value("message").toString();
 
@@ -422,7 +451,7 @@ QJsonObject BrowserAction::handleGetDatabaseGroups(const QJsonObject& json, cons
         return getErrorReply(action, ERROR_KEEPASS_INCORRECT_ACTION);
     }
 
-    const QJsonObject groups = browserService()->getDatabaseGroups();
+    const QJsonObject groups = onGuiThread<QJsonObject>([] { return browserService()->getDatabaseGroups(); });
     if (groups.isEmpty()) {
         return getErrorReply(action, ERROR_KEEPASS_NO_GROUPS_FOUND);
     }
@@ -437,7 +466,7 @@ QJsonObject BrowserAction::handleGetDatabaseGroups(const QJsonObject& json, cons
 
 QJsonObject BrowserAction::handleCreateNewGroup(const QJsonObject& json, const QString& action)
 {
-    const QString hash = browserService()->getDatabaseHash();
+    const QString hash = databaseHash();
     const QString nonce = json.value("nonce").toString();
     const QString encrypted = json.value("message").toString();
 
@@ -456,7 +485,8 @@ QJsonObject BrowserAction::handleCreateNewGroup(const QJsonObject& json, const Q
     }
 
     QString group = decrypted.value("groupName").toString();
-    const QJsonObject newGroup = browserService()->createNewGroup(group);
+    const QJsonObject newGroup =
+        onGuiThread<QJsonObject>([&group] { return browserService()->createNewGroup(group); });
     if (newGroup.isEmpty() || newGroup["name"].toString().isEmpty() || newGroup["uuid"].toString().isEmpty()) {
         return getErrorReply(action, ERROR_KEEPASS_CANNOT_CREATE_NEW_GROUP);
     }
@@ -492,7 +522,7 @@ QJsonObject BrowserAction::handleGetTotp(const QJsonObject& json, const QString&
     const QString uuid = decrypted.value("uuid").toString();
 
     // Get the current TOTP
-    const auto totp = browserService()->getCurrentTotp(uuid);
+    const auto totp = onGuiThread<QString>([&uuid] { return browserService()->getCurrentTotp(uuid); });
     const QString newNonce = incrementNonce(nonce);
 
     QJsonObject message = buildMessage(newNonce);
@@ -601,24 +631,20 @@ QString BrowserAction::encrypt(const QString& plaintext, const QString& nonce)
 {
     const QByteArray ma = plaintext.toUtf8();
     const QByteArray na = base64Decode(nonce);
-    const QByteArray ca = base64Decode(m_clientPublicKey);
-    const QByteArray sa = base64Decode(m_secretKey);
-
-    std::vector<unsigned char> m(ma.cbegin(), ma.cend());
-    std::vector<unsigned char> n(na.cbegin(), na.cend());
-    std::vector<unsigned char> ck(ca.cbegin(), ca.cend());
-    std::vector<unsigned char> sk(sa.cbegin(), sa.cend());
-
-    std::vector<unsigned char> e;
-    e.resize(BrowserShared::NATIVEMSG_MAX_LENGTH);
+    const auto& key = sharedKey();
 
-    if (m.empty() || n.empty() || ck.empty() || sk.empty()) {
+    if (ma.isEmpty() || na.size() != static_cast<int>(crypto_box_NONCEBYTES) || key.empty()) {
         return QString();
     }
 
-    if (crypto_box_easy(e.data(), m.data(), m.size(), n.data(), ck.data(), sk.data()) == 0) {
-        QByteArray res = getQByteArray(e.data(), (crypto_box_MACBYTES + ma.length()));
-        return res.toBase64();
+    m_buffer.resize(crypto_box_MACBYTES + ma.size());
+    if (crypto_box_easy_afternm(m_buffer.data(),
+                                reinterpret_cast<const unsigned char*>(ma.constData()),
+                                ma.size(),
+                                reinterpret_cast<const unsigned char*>(na.constData()),
+                                key.data())
+        == 0) {
+        return getQByteArray(m_buffer.data(), m_buffer.size()).toBase64();
     }
 
     return QString();
@@ -628,26 +654,66 @@ QByteArray BrowserAction::decrypt(const QString& encrypted, const QString& nonce
 {
     const QByteArray ma = base64Decode(encrypted);
     const QByteArray na = base64Decode(nonce);
-    const QByteArray ca = base64Decode(m_clientPublicKey);
-    const QByteArray sa = base64Decode(m_secretKey);
+    const auto& key = sharedKey();
+
+    if (ma.size() <= static_cast<int>(crypto_box_MACBYTES) || na.size() != static_cast<int>(crypto_box_NONCEBYTES)
+        || key.empty()) {
+        return QByteArray();
+    }
 
-    std::vector<unsigned char> m(ma.cbegin(), ma.cend());
-    std::vector<unsigned char> n(na.cbegin(), na.cend());
-    std::vector<unsigned char> ck(ca.cbegin(), ca.cend());
-    std::vector<unsigned char> sk(sa.cbegin(), sa.cend());
+    QByteArray result;
+    m_buffer.resize(ma.size() - crypto_box_MACBYTES);
+    if (crypto_box_open_easy_afternm(m_buffer.data(),
+                                     reinterpret_cast<const unsigned char*>(ma.constData()),
+                                     ma.size(),
+                                     reinterpret_cast<const unsigned char*>(na.constData()),
+                                     key.data())
+        == 0) {
+        result = getQByteArray(m_buffer.data(), m_buffer.size());
+    }
 
-    std::vector<unsigned char> d;
-    d.resize(BrowserShared::NATIVEMSG_MAX_LENGTH);
+    // The buffer is reused for the next message, don't leave the plaintext behind
+    sodium_memzero(m_buffer.data(), m_buffer.size());
+    return result;
+}
 
-    if (m.empty() || n.empty() || ck.empty() || sk.empty()) {
-        return QByteArray();
+/**
+ * Shared key of the client and our key pair. It is computed once per key
+ * exchange instead of repeating the scalar multiplication for every message.
+ */
+const std::vector<unsigned char>& BrowserAction::sharedKey()
+{
+    if (!m_sharedKey.empty()) {
+        return m_sharedKey;
     }
 
-    if (crypto_box_open_easy(d.data(), m.data(), ma.length(), n.data(), ck.data(), sk.data()) == 0) {
-        return getQByteArray(d.data(), std::char_traits<char>::length(reinterpret_cast<const char*>(d.data())));
+    const QByteArray ca = base64Decode(m_clientPublicKey);
+    const QByteArray sa = base64Decode(m_secretKey);
+    if (ca.size() != static_cast<int>(crypto_box_PUBLICKEYBYTES)
+        || sa.size() != static_cast<int>(crypto_box_SECRETKEYBYTES)) {
+        return m_sharedKey;
     }
 
-    return QByteArray();
+    std::vector<unsigned char> key(crypto_box_BEFORENMBYTES);
+    if (crypto_box_beforenm(key.data(),
+                            reinterpret_cast<const unsigned char*>(ca.constData()),
+                            reinterpret_cast<const unsigned char*>(sa.constData()))
+        == 0) {
+        m_sharedKey.swap(key);
+    } else {
+        sodium_memzero(key.data(), key.size());
+    }
+    return m_sharedKey;
+}
+
+void BrowserAction::resetSession()
+{
+    if (!m_sharedKey.empty()) {
+        sodium_memzero(m_sharedKey.data(), m_sharedKey.size());
+        m_sharedKey.clear();
+    }
+    m_buffer.clear();
+    m_buffer.shrink_to_fit();
 }
 
 QString BrowserAction::getBase64FromKey(const uchar* array, const uint len)
@@ -657,12 +723,7 @@ QString BrowserAction::getBase64FromKey(const uchar* array, const uint len)
 
 QByteArray BrowserAction::getQByteArray(const uchar* array, const uint len) const
 {
-    QByteArray qba;
-    qba.reserve(len);
-    for (uint i = 0; i < len; ++i) {
-        qba.append(static_cast<char>(array[i]));
-    }
-    return qba;
+    return QByteArray(reinterpret_cast<const char*>(array), static_cast<int>(len));
 }
 
 QJsonObject BrowserAction::getJsonObject(const uchar* pArray, const uint len) const
@@ -20,13 +20,15 @@
 
 #include <QString>
 
+#include <vector>
+
 class QJsonObject;
 
 class BrowserAction
 {
 public:
     explicit BrowserAction() = default;
-    ~BrowserAction() = default;
+    ~BrowserAction();
 
     QJsonObject processClientMessage(const QJsonObject& json);
 
@@ -53,6 +55,8 @@ private:
     QJsonObject decryptMessage(const QString& message, const QString& nonce);
     QString encrypt(const QString& plaintext, const QString& nonce);
     QByteArray decrypt(const QString& encrypted, const QString& nonce);
+    const std::vector<unsigned char>& sharedKey();
+    void resetSession();
 
     QString getBase64FromKey(const uchar* array, const uint len);
     QByteArray getQByteArray(const uchar* array, const uint len) const;
@@ -66,6 +70,9 @@ private:
     QString m_publicKey;
     QString m_secretKey;
     bool m_associated = false;
+    // Precomputed key of the current key exchange, see sharedKey()
+    std::vector<unsigned char> m_sharedKey;
+    std::vector<unsigned char> m_buffer;
 
     friend class TestBrowser;
 };
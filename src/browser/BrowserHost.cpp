@@ -17,6 +17,7 @@
 
 #include "BrowserHost.h"
 #include "BrowserShared.h"
+#include "core/Global.h"
 
 #include <QJsonDocument>
 #include <QLocalServer>
@@ -54,6 +55,8 @@ void BrowserHost::start()
 void BrowserHost::stop()
 {
     m_socketList.clear();
+    m_readBuffers.clear();
+    m_unframedSockets.clear();
     m_localServer->close();
 }
 
@@ -61,6 +64,13 @@ void BrowserHost::proxyConnected()
 {
     auto socket = m_localServer->nextPendingConnection();
     if (socket) {
+        socket->setReadBufferSize(BrowserShared::NATIVEMSG_MAX_LENGTH);
+        int socketDesc = socket->socketDescriptor();
+        if (socketDesc) {
+            int max = BrowserShared::NATIVEMSG_MAX_LENGTH;
+            setsockopt(socketDesc, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<char*>(&max), sizeof(max));
+        }
+
         m_socketList.append(socket);
         connect(socket, SIGNAL(readyRead()), this, SLOT(readProxyMessage()));
         connect(socket, SIGNAL(disconnected()), this, SLOT(proxyDisconnected()));
@@ -74,15 +84,37 @@ void BrowserHost::readProxyMessage()
         return;
     }
 
-    socket->setReadBufferSize(BrowserShared::NATIVEMSG_MAX_LENGTH);
-    int socketDesc = socket->socketDescriptor();
-    if (socketDesc) {
-        int max = BrowserShared::NATIVEMSG_MAX_LENGTH;
-        setsockopt(socketDesc, SOL_SOCKET, SO_SNDBUF, reinterpret_cast<char*>(&max), sizeof(max));
+    QByteArray buffer = m_readBuffers.take(socket) + socket->readAll();
+
+    // Clients connecting directly to the socket may still send bare JSON
+    if (!m_unframedSockets.contains(socket) && !BrowserShared::isFramed(buffer)) {
+        m_unframedSockets.insert(socket);
     }
 
+    QList<QByteArray> messages;
+    if (m_unframedSockets.contains(socket)) {
+        messages << buffer;
+    } else {
+        QByteArray message;
+        while (BrowserShared::takeFrame(buffer, message)) {
+            messages << message;
+        }
+        // Keep the start of an incomplete message until the rest arrives
+        if (!buffer.isEmpty()) {
+            m_readBuffers.insert(socket, buffer);
+        }
+    }
+
+    // Handling a message may show a dialog and read from the sockets again
+    for (const auto& message : asConst(messages)) {
+        processMessage(message);
+    }
+}
+
+void BrowserHost::processMessage(const QByteArray& message)
+{
     QJsonParseError error;
-    auto json = QJsonDocument::fromJson(socket->readAll(), &error);
+    auto json = QJsonDocument::fromJson(message, &error);
     if (json.isNull()) {
         qWarning() << "Failed to read proxy message: " << error.errorString();
         return;
@@ -93,11 +125,11 @@ void BrowserHost::readProxyMessage()
 
 void BrowserHost::sendClientMessage(const QJsonObject& json)
 {
-    QString reply(QJsonDocument(json).toJson(QJsonDocument::Compact));
+    const auto reply = QJsonDocument(json).toJson(QJsonDocument::Compact);
+    const auto frame = BrowserShared::frameMessage(reply);
     for (const auto socket : m_socketList) {
         if (socket && socket->isValid() && socket->state() == QLocalSocket::ConnectedState) {
-            QByteArray arr = reply.toUtf8();
-            socket->write(arr.constData(), arr.length());
+            socket->write(m_unframedSockets.contains(socket) ? reply : frame);
             socket->flush();
         }
     }
@@ -107,4 +139,6 @@ void BrowserHost::proxyDisconnected()
 {
     auto socket = qobject_cast<QLocalSocket*>(QObject::sender());
     m_socketList.removeOne(socket);
+    m_readBuffers.remove(socket);
+    m_unframedSockets.remove(socket);
 }
@@ -18,9 +18,11 @@
 #ifndef NATIVEMESSAGINGHOST_H
 #define NATIVEMESSAGINGHOST_H
 
+#include <QHash>
 #include <QJsonObject>
 #include <QObject>
 #include <QPointer>
+#include <QSet>
 
 class QLocalServer;
 class QLocalSocket;
@@ -47,8 +49,12 @@ private slots:
     void proxyDisconnected();
 
 private:
+    void processMessage(const QByteArray& message);
+
     QPointer<QLocalServer> m_localServer;
     QList<QLocalSocket*> m_socketList;
+    QHash<QLocalSocket*, QByteArray> m_readBuffers;
+    QSet<QLocalSocket*> m_unframedSockets;
 };
 
 #endif // NATIVEMESSAGINGHOST_H
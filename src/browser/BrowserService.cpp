@@ -25,6 +25,7 @@
 #include "BrowserEntrySaveDialog.h"
 #include "BrowserHost.h"
 #include "BrowserSettings.h"
+#include "BrowserUrlIndex.h"
 #include "core/Tools.h"
 #include "gui/MainWindow.h"
 #include "gui/MessageBox.h"
@@ -33,14 +34,16 @@
 #endif
 
 #include <QCheckBox>
+#include <QCoreApplication>
 #include <QCryptographicHash>
-#include <QHostAddress>
+#include <QFutureWatcher>
 #include <QInputDialog>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QListWidget>
 #include <QProgressDialog>
 #include <QUrl>
+#include <QtConcurrent>
 
 const QString BrowserService::KEEPASSXCBROWSER_NAME = QStringLiteral("KeePassXC-Browser Settings");
 const QString BrowserService::KEEPASSXCBROWSER_OLD_NAME = QStringLiteral("keepassxc-browser Settings");
@@ -65,8 +68,16 @@ BrowserService::BrowserService()
     , m_dialogActive(false)
     , m_bringToFrontRequested(false)
     , m_prevWindowState(WindowState::Normal)
+    , m_shuttingDown(false)
     , m_keepassBrowserUUID(Tools::hexToUuid("de887cc3036343b8974b5911b8816224"))
 {
+    // A client waiting for a dialog must not hold up the other clients
+    m_requestPool.setMaxThreadCount(qMax(2, QThread::idealThreadCount()));
+
+    qRegisterMetaType<std::function<void()>>();
+    connect(this, &BrowserService::guiTaskRequested, this, &BrowserService::runGuiTask, Qt::BlockingQueuedConnection);
+    connect(qApp, &QCoreApplication::aboutToQuit, this, &BrowserService::shutdownRequests);
+
     connect(m_browserHost, &BrowserHost::clientMessageReceived, this, &BrowserService::processClientMessage);
     connect(getMainWindow(), &MainWindow::databaseUnlocked, this, &BrowserService::databaseUnlocked);
     connect(getMainWindow(), &MainWindow::databaseLocked, this, &BrowserService::databaseLocked);
@@ -587,32 +598,29 @@ BrowserService::searchEntries(const QSharedPointer<Database>& db, const QString&
         return entries;
     }
 
-    for (const auto& group : rootGroup->groupsRecursive(true)) {
-        if (group->isRecycled() || !group->resolveSearchingEnabled()) {
+    // Local files and the special keepassxc:// scheme are not matched by their host, check every entry
+    QList<Entry*> candidates;
+    if (siteUrlStr.startsWith("file://") || siteUrlStr.startsWith("keepassxc://")) {
+        candidates = rootGroup->entriesRecursive();
+    } else {
+        candidates = urlIndex(db)->entries(QUrl(siteUrlStr).host());
+    }
+
+    for (auto* entry : asConst(candidates)) {
+        if (entry->isRecycled() || !entry->group()->resolveSearchingEnabled()) {
             continue;
         }
 
-        for (auto* entry : group->entries()) {
-            if (entry->isRecycled()) {
-                continue;
-            }
-
-            // Search for additional URL's starting with KP2A_URL
-            for (const auto& key : entry->attributes()->keys()) {
-                if (key.startsWith(ADDITIONAL_URL) && handleURL(entry->attributes()->value(key), siteUrlStr, formUrlStr)
-                    && !entries.contains(entry)) {
-                    entries.append(entry);
-                    continue;
-                }
-            }
-
-            if (!handleEntry(entry, siteUrlStr, formUrlStr)) {
-                continue;
-            }
+        if (handleEntry(entry, siteUrlStr, formUrlStr)) {
+            entries.append(entry);
+            continue;
+        }
 
-            // Additional URL check may have already inserted the entry to the list
-            if (!entries.contains(entry)) {
+        // Search for additional URL's starting with KP2A_URL
+        for (const auto& key : entry->attributes()->keys()) {
+            if (key.startsWith(ADDITIONAL_URL) && handleURL(entry->attributes()->value(key), siteUrlStr, formUrlStr)) {
                 entries.append(entry);
+                break;
             }
         }
     }
@@ -1079,26 +1087,22 @@ bool BrowserService::handleURL(const QString& entryUrl, const QString& siteUrlSt
  */
 QString BrowserService::baseDomain(const QString& hostname) const
 {
-    QUrl qurl = QUrl::fromUserInput(hostname);
-    QString host = qurl.host();
-
-    // If the hostname is an IP address, return it directly
-    QHostAddress hostAddress(hostname);
-    if (!hostAddress.isNull()) {
-        return hostname;
-    }
+    return BrowserUrlIndex::baseDomain(hostname);
+}
 
-    if (host.isEmpty() || !host.contains(qurl.topLevelDomain())) {
-        return {};
+/**
+ * Index of the entry URLs of a database, created on first use and
+ * destroyed together with the database.
+ */
+BrowserUrlIndex* BrowserService::urlIndex(const QSharedPointer<Database>& db)
+{
+    auto& index = m_urlIndexes[db.data()];
+    if (!index) {
+        const Database* key = db.data();
+        index = new BrowserUrlIndex(db.data());
+        connect(index, &QObject::destroyed, this, [this, key] { m_urlIndexes.remove(key); });
     }
-
-    // Remove the top level domain part from the hostname, e.g. https://another.example.co.uk -> https://another.example
-    host.chop(qurl.topLevelDomain().length());
-    // Split the URL and select the last part, e.g. https://another.example -> example
-    QString baseDomain = host.split('.').last();
-    // Append the top level domain back to the URL, e.g. example -> example.co.uk
-    baseDomain.append(qurl.topLevelDomain());
-    return baseDomain;
+    return index;
 }
 
 QSharedPointer<Database> BrowserService::getDatabase()
@@ -1341,7 +1345,7 @@ void BrowserService::activeDatabaseChanged(DatabaseWidget* dbWidget)
 void BrowserService::processClientMessage(const QJsonObject& message)
 {
     auto clientID = message["clientID"].toString();
-    if (clientID.isEmpty()) {
+    if (clientID.isEmpty() || m_shuttingDown) {
         return;
     }
 
@@ -1350,7 +1354,62 @@ void BrowserService::processClientMessage(const QJsonObject& message)
         m_browserClients.insert(clientID, QSharedPointer<BrowserAction>::create());
     }
 
-    auto& action = m_browserClients.value(clientID);
-    auto response = action->processClientMessage(message);
-    m_browserHost->sendClientMessage(response);
+    m_pendingRequests[clientID].enqueue(message);
+    processNextRequest(clientID);
+}
+
+/**
+ * Requests are decrypted and answered on the request pool. The requests of
+ * one client are handled in order, different clients are handled in parallel.
+ * Database and settings access is run on the GUI thread through runOnGuiThread().
+ */
+void BrowserService::processNextRequest(const QString& clientID)
+{
+    if (m_busyClients.contains(clientID)) {
+        return;
+    }
+
+    auto& queue = m_pendingRequests[clientID];
+    if (queue.isEmpty()) {
+        m_pendingRequests.remove(clientID);
+        return;
+    }
+
+    const auto message = queue.dequeue();
+    const auto action = m_browserClients.value(clientID);
+    m_busyClients.insert(clientID);
+
+    auto* watcher = new QFutureWatcher<QJsonObject>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [this, watcher, clientID] {
+        watcher->deleteLater();
+        m_busyClients.remove(clientID);
+        if (!m_shuttingDown) {
+            m_browserHost->sendClientMessage(watcher->result());
+            emit clientReplySent(watcher->result());
+            processNextRequest(clientID);
+        }
+    });
+    const auto handler = m_requestHandler;
+    watcher->setFuture(QtConcurrent::run(&m_requestPool, [action, handler, message] {
+        return handler ? handler(message) : action->processClientMessage(message);
+    }));
+}
+
+void BrowserService::runGuiTask(const std::function<void()>& task)
+{
+    // Requests still in flight at exit get empty results
+    if (!m_shuttingDown) {
+        task();
+    }
+}
+
+void BrowserService::shutdownRequests()
+{
+    m_shuttingDown = true;
+    m_pendingRequests.clear();
+
+    // Workers may be waiting for the GUI thread, keep serving them until they are done
+    while (!m_requestPool.waitForDone(10)) {
+        QCoreApplication::processEvents();
+    }
 }
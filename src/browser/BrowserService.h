@@ -22,6 +22,14 @@
 
 #include "core/Entry.h"
 
+#include <QQueue>
+#include <QThread>
+#include <QThreadPool>
+
+#include <functional>
+
+Q_DECLARE_METATYPE(std::function<void()>)
+
 typedef QPair<QString, QString> StringPair;
 typedef QList<StringPair> StringPairList;
 
@@ -33,6 +41,7 @@ enum
 class DatabaseWidget;
 class BrowserHost;
 class BrowserAction;
+class BrowserUrlIndex;
 
 class BrowserService : public QObject
 {
@@ -81,6 +90,8 @@ public:
 
     static void convertAttributesToCustomData(QSharedPointer<Database> db);
 
+    template <typename T> T runOnGuiThread(const std::function<T()>& task);
+
     static const QString KEEPASSXCBROWSER_NAME;
     static const QString KEEPASSXCBROWSER_OLD_NAME;
     static const QString OPTION_SKIP_AUTO_SUBMIT;
@@ -91,6 +102,8 @@ public:
 
 signals:
     void requestUnlock();
+    void guiTaskRequested(const std::function<void()>& task);
+    void clientReplySent(const QJsonObject& reply);
 
 public slots:
     void databaseLocked(DatabaseWidget* dbWidget);
@@ -99,6 +112,8 @@ public slots:
 
 private slots:
     void processClientMessage(const QJsonObject& message);
+    void runGuiTask(const std::function<void()>& task);
+    void shutdownRequests();
 
 private:
     enum Access
@@ -135,6 +150,7 @@ private:
     bool handleEntry(Entry* entry, const QString& url, const QString& submitUrl);
     bool handleURL(const QString& entryUrl, const QString& siteUrlStr, const QString& formUrlStr);
     QString baseDomain(const QString& hostname) const;
+    BrowserUrlIndex* urlIndex(const QSharedPointer<Database>& db);
     QSharedPointer<Database> getDatabase();
     QSharedPointer<Database> selectedDatabase();
     QString getDatabaseRootUuid();
@@ -146,15 +162,24 @@ private:
     void raiseWindow(const bool force = false);
     void updateWindowState();
 
+    void processNextRequest(const QString& clientID);
+
     static bool moveSettingsToCustomData(Entry* entry, const QString& name);
     static int moveKeysToCustomData(Entry* entry, QSharedPointer<Database> db);
 
     QPointer<BrowserHost> m_browserHost;
     QHash<QString, QSharedPointer<BrowserAction>> m_browserClients;
+    QHash<QString, QQueue<QJsonObject>> m_pendingRequests;
+    QSet<QString> m_busyClients;
+    QThreadPool m_requestPool;
+    // Handles a request on the request pool instead of the client's BrowserAction, used by tests
+    std::function<QJsonObject(const QJsonObject&)> m_requestHandler;
+    QHash<const Database*, QPointer<BrowserUrlIndex>> m_urlIndexes;
 
     bool m_dialogActive;
     bool m_bringToFrontRequested;
     WindowState m_prevWindowState;
+    bool m_shuttingDown;
     QUuid m_keepassBrowserUUID;
 
     QPointer<DatabaseWidget> m_currentDatabaseWidget;
@@ -164,6 +189,21 @@ private:
     friend class TestBrowser;
 };
 
+/**
+ * Run `task` on the GUI thread and wait for its result. Called from
+ * the GUI thread itself, the task is run directly.
+ */
+template <typename T> T BrowserService::runOnGuiThread(const std::function<T()>& task)
+{
+    if (QThread::currentThread() == thread()) {
+        return task();
+    }
+
+    T result{};
+    emit guiTaskRequested([&result, &task] { result = task(); });
+    return result;
+}
+
 static inline BrowserService* browserService()
 {
     return BrowserService::instance();
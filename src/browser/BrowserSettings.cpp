@@ -493,23 +493,31 @@ PasswordGenerator::GeneratorFlags BrowserSettings::passwordGeneratorFlags()
     return flags;
 }
 
-QJsonObject BrowserSettings::generatePassword()
+QJsonArray BrowserSettings::generatePasswords(int count)
 {
-    QJsonObject password;
+    QJsonArray passwords;
     if (generatorType() == 0) {
         m_passwordGenerator.setLength(passwordLength());
         m_passwordGenerator.setCharClasses(passwordCharClasses());
         m_passwordGenerator.setFlags(passwordGeneratorFlags());
-        const QString pw = m_passwordGenerator.generatePassword();
-        password["entropy"] = PasswordHealth(pw).entropy();
-        password["password"] = pw;
+        for (const auto& pw : m_passwordGenerator.generatePasswords(count)) {
+            QJsonObject password;
+            password["entropy"] = PasswordHealth(pw).entropy();
+            password["password"] = pw;
+            passwords.append(password);
+        }
     } else {
         m_passPhraseGenerator.setWordCount(passPhraseWordCount());
         m_passPhraseGenerator.setWordSeparator(passPhraseWordSeparator());
-        password["entropy"] = m_passPhraseGenerator.estimateEntropy();
-        password["password"] = m_passPhraseGenerator.generatePassphrase();
+        const auto entropy = m_passPhraseGenerator.estimateEntropy();
+        for (const auto& pw : m_passPhraseGenerator.generatePassphrases(count)) {
+            QJsonObject password;
+            password["entropy"] = entropy;
+            password["password"] = pw;
+            passwords.append(password);
+        }
     }
-    return password;
+    return passwords;
 }
 
 void BrowserSettings::updateBinaryPaths()
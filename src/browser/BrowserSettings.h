@@ -24,6 +24,8 @@
 #include "core/PassphraseGenerator.h"
 #include "core/PasswordGenerator.h"
 
+#include <QJsonArray>
+
 class BrowserSettings
 {
 public:
@@ -118,7 +120,7 @@ public:
     void setPasswordLength(int length);
     PasswordGenerator::CharClasses passwordCharClasses();
     PasswordGenerator::GeneratorFlags passwordGeneratorFlags();
-    QJsonObject generatePassword();
+    QJsonArray generatePasswords(int count);
     void updateBinaryPaths();
 
 private:
@@ -20,6 +20,7 @@
 #include "config-keepassx.h"
 
 #include <QStandardPaths>
+#include <QtEndian>
 
 namespace BrowserShared
 {
@@ -40,4 +41,40 @@ namespace BrowserShared
         return QStandardPaths::writableLocation(QStandardPaths::TempLocation) + serverName;
 #endif
     }
+
+    QByteArray frameMessage(const QByteArray& message)
+    {
+        QByteArray frame(sizeof(quint32), Qt::Uninitialized);
+        qToBigEndian(static_cast<quint32>(message.size()), reinterpret_cast<uchar*>(frame.data()));
+        frame.append(message);
+        return frame;
+    }
+
+    bool takeFrame(QByteArray& buffer, QByteArray& message)
+    {
+        if (buffer.size() < static_cast<int>(sizeof(quint32))) {
+            return false;
+        }
+
+        const auto length = qFromBigEndian<quint32>(reinterpret_cast<const uchar*>(buffer.constData()));
+        if (length > static_cast<quint32>(NATIVEMSG_MAX_LENGTH)) {
+            // The stream cannot be resynchronized, drop what has been received
+            buffer.clear();
+            return false;
+        }
+
+        const int frameSize = static_cast<int>(sizeof(quint32) + length);
+        if (buffer.size() < frameSize) {
+            return false;
+        }
+
+        message = buffer.mid(sizeof(quint32), static_cast<int>(length));
+        buffer.remove(0, frameSize);
+        return true;
+    }
+
+    bool isFramed(const QByteArray& buffer)
+    {
+        return buffer.isEmpty() || buffer.at(0) == '\0';
+    }
 } // namespace BrowserShared
@@ -18,6 +18,7 @@
 #ifndef KEEPASSXC_BROWSERSHARED_H
 #define KEEPASSXC_BROWSERSHARED_H
 
+#include <QByteArray>
 #include <QString>
 
 namespace BrowserShared
@@ -38,6 +39,13 @@ namespace BrowserShared
     };
 
     QString localServerPath();
+
+    // Messages on the local socket are prefixed with their size as a 32-bit big-endian integer
+    QByteArray frameMessage(const QByteArray& message);
+    // Move the first complete message out of `buffer`, false if there is none yet
+    bool takeFrame(QByteArray& buffer, QByteArray& message);
+    // Unframed JSON from clients that predate the framing starts with '{' instead of a zero byte
+    bool isFramed(const QByteArray& buffer);
 } // namespace BrowserShared
 
 #endif // KEEPASSXC_BROWSERSHARED_H
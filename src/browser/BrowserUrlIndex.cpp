@@ -0,0 +1,233 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BrowserUrlIndex.h"
+
+#include "BrowserService.h"
+#include "core/Database.h"
+#include "core/Global.h"
+#include "core/Group.h"
+
+#include <QHostAddress>
+#include <QUrl>
+
+namespace
+{
+    // Position of an entry in the order of Group::entriesRecursive()
+    QVector<int> treePosition(const Entry* entry)
+    {
+        const Group* group = entry->group();
+        QVector<int> position{-1, group->entries().indexOf(const_cast<Entry*>(entry))};
+        for (const Group* parent = group->parentGroup(); parent; parent = parent->parentGroup()) {
+            position.prepend(parent->children().indexOf(const_cast<Group*>(group)));
+            group = parent;
+        }
+        return position;
+    }
+} // namespace
+
+/**
+ * The index is built on first use and then updated entry by entry.
+ * Changes to the group structure invalidate it so it is rebuilt on
+ * the next lookup.
+ */
+BrowserUrlIndex::BrowserUrlIndex(Database* db)
+    : QObject(db)
+    , m_db(db)
+{
+    connect(db, &Database::entryAdded, this, &BrowserUrlIndex::addEntry);
+    connect(db, &Database::entryAboutToRemove, this, &BrowserUrlIndex::removeEntry);
+    connect(db, &Database::entryDataChanged, this, &BrowserUrlIndex::updateEntry);
+    connect(db, &Database::groupAdded, this, &BrowserUrlIndex::invalidate);
+    connect(db, &Database::groupRemoved, this, &BrowserUrlIndex::invalidate);
+}
+
+QList<Entry*> BrowserUrlIndex::entries(const QString& hostname) const
+{
+    const auto domain = baseDomain(hostname);
+    QMutexLocker locker(&m_mutex);
+    build();
+    auto entries = m_entries.value(domain);
+    locker.unlock();
+
+    if (entries.size() > 1) {
+        QHash<const Entry*, QVector<int>> positions;
+        for (const auto* entry : asConst(entries)) {
+            positions.insert(entry, treePosition(entry));
+        }
+        std::sort(entries.begin(), entries.end(), [&positions](const Entry* lhs, const Entry* rhs) {
+            const auto& l = positions[lhs];
+            const auto& r = positions[rhs];
+            return std::lexicographical_compare(l.begin(), l.end(), r.begin(), r.end());
+        });
+    }
+    return entries;
+}
+
+void BrowserUrlIndex::invalidate()
+{
+    QMutexLocker locker(&m_mutex);
+    m_valid = false;
+    m_entries.clear();
+    m_domains.clear();
+}
+
+void BrowserUrlIndex::addEntry(Entry* entry)
+{
+    const auto domains = entryDomains(entry);
+    QMutexLocker locker(&m_mutex);
+    if (m_valid) {
+        insert(entry, domains);
+    }
+}
+
+void BrowserUrlIndex::removeEntry(Entry* entry)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_valid) {
+        remove(entry);
+    }
+}
+
+void BrowserUrlIndex::updateEntry(Entry* entry)
+{
+    const auto domains = entryDomains(entry);
+    QMutexLocker locker(&m_mutex);
+    if (!m_valid || domains == m_domains.value(entry)) {
+        return;
+    }
+
+    remove(entry);
+    insert(entry, domains);
+}
+
+/**
+ * Gets the base domain of a hostname.
+ *
+ * Returns the base domain, e.g. another.example.co.uk -> example.co.uk
+ */
+QString BrowserUrlIndex::baseDomain(const QString& hostname)
+{
+    QUrl qurl = QUrl::fromUserInput(hostname);
+    QString host = qurl.host();
+
+    // If the hostname is an IP address, return it directly
+    QHostAddress hostAddress(hostname);
+    if (!hostAddress.isNull()) {
+        return hostname;
+    }
+
+    if (host.isEmpty() || !host.contains(qurl.topLevelDomain())) {
+        return {};
+    }
+
+    // Remove the top level domain part from the hostname, e.g. https://another.example.co.uk -> https://another.example
+    host.chop(qurl.topLevelDomain().length());
+    // Split the URL and select the last part, e.g. https://another.example -> example
+    QString baseDomain = host.split('.').last();
+    // Append the top level domain back to the URL, e.g. example -> example.co.uk
+    baseDomain.append(qurl.topLevelDomain());
+    return baseDomain;
+}
+
+/**
+ * Host of an entry URL, parsed the same way as BrowserService::handleURL()
+ * does so that entries are indexed under the domain they are matched by.
+ */
+QString BrowserUrlIndex::urlHost(const QString& url)
+{
+    if (url.contains("://")) {
+        return QUrl(url).host();
+    }
+    return QUrl::fromUserInput(url).host();
+}
+
+QStringList BrowserUrlIndex::entryDomains(const Entry* entry)
+{
+    QStringList domains;
+    auto addUrl = [&domains](const QString& url) {
+        const auto host = urlHost(url);
+        if (!host.isEmpty()) {
+            const auto domain = baseDomain(host);
+            if (!domains.contains(domain)) {
+                domains.append(domain);
+            }
+        }
+    };
+
+    addUrl(entry->url());
+    const auto* attributes = entry->attributes();
+    for (const auto& key : attributes->keys()) {
+        if (key.startsWith(BrowserService::ADDITIONAL_URL)) {
+            addUrl(attributes->value(key));
+        }
+    }
+    return domains;
+}
+
+/**
+ * Index all entries of the database unless the index is up to date.
+ * Must be called with the mutex held.
+ */
+void BrowserUrlIndex::build() const
+{
+    // Replacing the root group does not emit any signal
+    if (m_valid && m_rootGroup == m_db->rootGroup()) {
+        return;
+    }
+
+    m_entries.clear();
+    m_domains.clear();
+    m_rootGroup = m_db->rootGroup();
+    if (m_rootGroup) {
+        for (auto* entry : m_rootGroup->entriesRecursive()) {
+            insert(entry, entryDomains(entry));
+        }
+    }
+    m_valid = true;
+}
+
+void BrowserUrlIndex::insert(Entry* entry, const QStringList& domains) const
+{
+    if (domains.isEmpty()) {
+        return;
+    }
+
+    for (const auto& domain : domains) {
+        m_entries[domain].append(entry);
+    }
+    m_domains.insert(entry, domains);
+}
+
+/**
+ * Remove an entry from the index. The entry is not dereferenced,
+ * it may be partially destroyed.
+ */
+void BrowserUrlIndex::remove(const Entry* entry) const
+{
+    const auto domains = m_domains.take(entry);
+    for (const auto& domain : domains) {
+        auto it = m_entries.find(domain);
+        if (it == m_entries.end()) {
+            continue;
+        }
+        it->removeOne(const_cast<Entry*>(entry));
+        if (it->isEmpty()) {
+            m_entries.erase(it);
+        }
+    }
+}
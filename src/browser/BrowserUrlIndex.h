@@ -0,0 +1,72 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_BROWSERURLINDEX_H
+#define KEEPASSXC_BROWSERURLINDEX_H
+
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QPointer>
+#include <QStringList>
+
+class Database;
+class Entry;
+class Group;
+
+/**
+ * Index of the entries of a database by the base domain of their URL
+ * and additional URLs, kept up to date from the entry signals of the
+ * database. A lookup returns the entries that can possibly match a
+ * site, the precise URL matching is left to the caller.
+ */
+class BrowserUrlIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit BrowserUrlIndex(Database* db);
+
+    // Entries with a URL on the base domain of `hostname`, in database order
+    QList<Entry*> entries(const QString& hostname) const;
+
+    static QString baseDomain(const QString& hostname);
+    static QString urlHost(const QString& url);
+
+public slots:
+    void invalidate();
+
+private slots:
+    void addEntry(Entry* entry);
+    void removeEntry(Entry* entry);
+    void updateEntry(Entry* entry);
+
+private:
+    static QStringList entryDomains(const Entry* entry);
+    void build() const;
+    void insert(Entry* entry, const QStringList& domains) const;
+    void remove(const Entry* entry) const;
+
+    Database* const m_db;
+    mutable QMutex m_mutex;
+    mutable bool m_valid = false;
+    mutable QPointer<Group> m_rootGroup;
+    mutable QHash<QString, QList<Entry*>> m_entries;
+    mutable QHash<const Entry*, QStringList> m_domains;
+};
+
+#endif // KEEPASSXC_BROWSERURLINDEX_H
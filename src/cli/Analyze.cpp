@@ -20,10 +20,13 @@
 #include "Utils.h"
 #include "core/Group.h"
 #include "core/HibpOffline.h"
+#include "core/PasswordHealth.h"
 
 #include <QCommandLineParser>
 #include <QFile>
 
+#include <algorithm>
+
 const QCommandLineOption Analyze::HIBPDatabaseOption = QCommandLineOption(
     {"H", "hibp"},
     QObject::tr("Check if any passwords have been publicly leaked. FILENAME must be the path of a file listing "
@@ -31,6 +34,16 @@ const QCommandLineOption Analyze::HIBPDatabaseOption = QCommandLineOption(
                 "https://haveibeenpwned.com/Passwords."),
     QObject::tr("FILENAME"));
 
+const QCommandLineOption Analyze::HIBPIndexOption =
+    QCommandLineOption("hibp-index",
+                       QObject::tr("Check against a sorted index of the HIBP file for fast lookups. The index is "
+                                   "created at FILENAME from the file given with --hibp if it does not exist yet."),
+                       QObject::tr("FILENAME"));
+
+const QCommandLineOption Analyze::HealthOption =
+    QCommandLineOption("health",
+                       QObject::tr("Report weak, reused and expired passwords, like the health check report."));
+
 const QCommandLineOption Analyze::OkonOption =
     QCommandLineOption("okon",
                        QObject::tr("Path to okon-cli to search a formatted HIBP file"),
@@ -41,9 +54,46 @@ Analyze::Analyze()
     name = QString("analyze");
     description = QObject::tr("Analyze passwords for weaknesses and problems.");
     options.append(Analyze::HIBPDatabaseOption);
+    options.append(Analyze::HIBPIndexOption);
+    options.append(Analyze::HealthOption);
     options.append(Analyze::OkonOption);
 }
 
+namespace
+{
+    void healthReport(QSharedPointer<Database> database, QTextStream& out)
+    {
+        QList<const Entry*> entries;
+        for (const auto entry : database->rootGroup()->entriesRecursive()) {
+            if (entry->password().isEmpty() || entry->excludeFromReports() || entry->isRecycled()) {
+                continue;
+            }
+            entries << entry;
+        }
+
+        const auto healths = HealthChecker(database).evaluate(entries);
+
+        QList<int> weak;
+        for (int i = 0; i < healths.size(); ++i) {
+            if (healths[i]->quality() < PasswordHealth::Quality::Good) {
+                weak << i;
+            }
+        }
+        std::stable_sort(weak.begin(), weak.end(), [&healths](int lhs, int rhs) {
+            return healths[lhs]->score() < healths[rhs]->score();
+        });
+
+        for (int i : weak) {
+            const auto& health = healths[i];
+            out << QObject::tr("Password for '%1' has score %2: %3")
+                       .arg(entries[i]->path())
+                       .arg(health->score())
+                       .arg(health->scoreReason().split('\n', QString::SkipEmptyParts).join(", "))
+                << endl;
+        }
+    }
+} // namespace
+
 int Analyze::executeWithDatabase(QSharedPointer<Database> database, QSharedPointer<QCommandLineParser> parser)
 {
     auto& out = Utils::STDOUT;
@@ -53,9 +103,21 @@ int Analyze::executeWithDatabase(QSharedPointer<Database> database, QSharedPoint
     QString error;
 
     auto hibpDatabase = parser->value(Analyze::HIBPDatabaseOption);
-    if (!QFile::exists(hibpDatabase) || hibpDatabase.isEmpty()) {
-        err << QObject::tr("Cannot find HIBP file: %1").arg(hibpDatabase);
-        return EXIT_FAILURE;
+    auto hibpIndex = parser->value(Analyze::HIBPIndexOption);
+    if (parser->isSet(Analyze::HealthOption)) {
+        out << QObject::tr("Evaluating password health of database entries…") << endl;
+        healthReport(database, out);
+
+        if (hibpDatabase.isEmpty() && hibpIndex.isEmpty()) {
+            return EXIT_SUCCESS;
+        }
+    }
+
+    if (hibpIndex.isEmpty() || !QFile::exists(hibpIndex)) {
+        if (!QFile::exists(hibpDatabase) || hibpDatabase.isEmpty()) {
+            err << QObject::tr("Cannot find HIBP file: %1").arg(hibpDatabase);
+            return EXIT_FAILURE;
+        }
     }
 
     auto okon = parser->value(Analyze::OkonOption);
@@ -66,6 +128,30 @@ int Analyze::executeWithDatabase(QSharedPointer<Database> database, QSharedPoint
             err << error << endl;
             return EXIT_FAILURE;
         }
+    } else if (!hibpIndex.isEmpty() || HibpOffline::isIndex(hibpDatabase)) {
+        if (hibpIndex.isEmpty()) {
+            hibpIndex = hibpDatabase;
+        } else if (!QFile::exists(hibpIndex)) {
+            QFile hibpFile(hibpDatabase);
+            if (!hibpFile.open(QFile::ReadOnly)) {
+                err << QObject::tr("Failed to open HIBP file %1: %2").arg(hibpDatabase).arg(hibpFile.errorString())
+                    << endl;
+                return EXIT_FAILURE;
+            }
+
+            out << QObject::tr("Creating HIBP index %1, this will take a while…").arg(hibpIndex) << endl;
+
+            if (!HibpOffline::createIndex(hibpFile, hibpIndex, &error)) {
+                err << error << endl;
+                return EXIT_FAILURE;
+            }
+        }
+
+        QFile indexFile(hibpIndex);
+        if (!HibpOffline::indexReport(database, indexFile, findings, &error)) {
+            err << error << endl;
+            return EXIT_FAILURE;
+        }
     } else {
         QFile hibpFile(hibpDatabase);
         if (!hibpFile.open(QFile::ReadOnly)) {
@@ -82,14 +168,9 @@ int Analyze::executeWithDatabase(QSharedPointer<Database> database, QSharedPoint
     }
 
     for (const auto& finding : findings) {
-        const auto entry = finding.first;
+        auto path = finding.first->path();
         auto count = finding.second;
 
-        QString path = entry->title();
-        for (auto g = entry->group(); g && g != g->database()->rootGroup(); g = g->parentGroup()) {
-            path.prepend("/").prepend(g->name());
-        }
-
         if (count > 0) {
             out << QObject::tr("Password for '%1' has been leaked %2 time(s)!", "", count).arg(path).arg(count) << endl;
         } else {
@@ -27,6 +27,8 @@ public:
     int executeWithDatabase(QSharedPointer<Database> db, QSharedPointer<QCommandLineParser> parser) override;
 
     static const QCommandLineOption HIBPDatabaseOption;
+    static const QCommandLineOption HIBPIndexOption;
+    static const QCommandLineOption HealthOption;
     static const QCommandLineOption OkonOption;
 };
 
@@ -0,0 +1,220 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Batch.h"
+
+#include "Utils.h"
+
+#include <QBuffer>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextCodec>
+
+const QCommandLineOption Batch::StopOnErrorOption =
+    QCommandLineOption(QStringList() << "stop-on-error",
+                       QObject::tr("Stop at the first failing command without saving the database."));
+
+const QCommandLineOption Batch::DryRunOption =
+    QCommandLineOption(QStringList() << "dry-run", QObject::tr("Execute the commands without saving the database."));
+
+namespace
+{
+    // Commands that manage the database lifetime themselves make no sense in a batch.
+    const QStringList DisallowedCommands = {"batch", "close", "db-create", "exit", "import", "open", "quit"};
+
+    /**
+     * Parse one line of batch input into command arguments. Lines starting with '{'
+     * are JSON objects of the form {"command": "add", "arguments": ["-u", "user", "/entry"], "id": ...},
+     * any other line is split like an interactive command.
+     */
+    bool parseBatchLine(const QString& line, QStringList& arguments, QJsonValue& id, QString& error)
+    {
+        if (!line.startsWith('{')) {
+            arguments = Utils::splitCommandString(line);
+            return true;
+        }
+
+        QJsonParseError parseError;
+        auto doc = QJsonDocument::fromJson(line.toUtf8(), &parseError);
+        if (parseError.error != QJsonParseError::NoError || !doc.isObject()) {
+            error = QObject::tr("Invalid JSON command: %1").arg(parseError.errorString());
+            return false;
+        }
+
+        auto object = doc.object();
+        id = object.value("id");
+        auto command = object.value("command").toString();
+        if (command.isEmpty()) {
+            error = QObject::tr("Missing command name.");
+            return false;
+        }
+
+        arguments << command;
+        for (const auto& argument : object.value("arguments").toArray()) {
+            arguments << argument.toString();
+        }
+        return true;
+    }
+
+    void writeResult(const QJsonObject& result)
+    {
+        Utils::STDOUT << QJsonDocument(result).toJson(QJsonDocument::Compact) << endl;
+    }
+} // namespace
+
+Batch::Batch()
+{
+    name = QString("batch");
+    description = QObject::tr("Execute commands from a file or standard input against a database.");
+    options.append(Batch::StopOnErrorOption);
+    options.append(Batch::DryRunOption);
+    optionalArguments.append(
+        {QString("file"), QObject::tr("File containing the commands, one per line. Default is stdin"), QString("[file]")});
+}
+
+int Batch::executeWithDatabase(QSharedPointer<Database> database, QSharedPointer<QCommandLineParser> parser)
+{
+    auto& err = Utils::STDERR;
+
+    const QStringList args = parser->positionalArguments();
+    QFile inputFile;
+    QTextStream* in = &Utils::STDIN;
+    QTextStream fileStream;
+    if (args.size() > 1) {
+        inputFile.setFileName(args.at(1));
+        if (!inputFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            err << QObject::tr("Unable to open command file %1: %2").arg(args.at(1), inputFile.errorString()) << endl;
+            return EXIT_FAILURE;
+        }
+        fileStream.setDevice(&inputFile);
+        fileStream.setCodec("UTF-8");
+        in = &fileStream;
+    }
+
+    bool stopOnError = parser->isSet(Batch::StopOnErrorOption);
+    int lineNumber = 0;
+    int executed = 0;
+    int failed = 0;
+
+    // Results are written to stdout as one JSON object per line (JSON Lines), with the
+    // output of each command captured instead of interleaved with the results.
+    QTextCodec* outCodec = Utils::STDOUT.codec();
+    QTextCodec* errCodec = Utils::STDERR.codec();
+
+    while (!in->atEnd()) {
+        QString line = in->readLine().trimmed();
+        ++lineNumber;
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+
+        QJsonObject result;
+        result["line"] = lineNumber;
+
+        QStringList commandArgs;
+        QJsonValue id;
+        QString error;
+        QSharedPointer<Command> command;
+        if (parseBatchLine(line, commandArgs, id, error) && !commandArgs.isEmpty()) {
+            command = Commands::getCommand(commandArgs.first());
+            if (!command) {
+                error = QObject::tr("Unknown command %1").arg(commandArgs.first());
+            } else if (DisallowedCommands.contains(command->name)) {
+                error = QObject::tr("Command %1 is not available in batch mode.").arg(command->name);
+                command.reset();
+            }
+        }
+        if (!id.isUndefined()) {
+            result["id"] = id;
+        }
+
+        ++executed;
+        if (!command) {
+            ++failed;
+            result["exitCode"] = EXIT_FAILURE;
+            result["error"] = error;
+            writeResult(result);
+            if (stopOnError) {
+                break;
+            }
+            continue;
+        }
+
+        QBuffer outBuffer;
+        QBuffer errBuffer;
+        outBuffer.open(QIODevice::ReadWrite);
+        errBuffer.open(QIODevice::ReadWrite);
+        auto* outDevice = Utils::STDOUT.device();
+        auto* errDevice = Utils::STDERR.device();
+        Utils::STDOUT.setDevice(&outBuffer);
+        Utils::STDOUT.setCodec("UTF-8");
+        Utils::STDERR.setDevice(&errBuffer);
+        Utils::STDERR.setCodec("UTF-8");
+
+        command->currentDatabase = database;
+        command->deferSave = true;
+        int exitCode = command->execute(commandArgs);
+        command->deferSave = false;
+        command->currentDatabase.reset();
+
+        Utils::STDOUT.setDevice(outDevice);
+        Utils::STDOUT.setCodec(outCodec);
+        Utils::STDERR.setDevice(errDevice);
+        Utils::STDERR.setCodec(errCodec);
+
+        result["command"] = command->name;
+        result["exitCode"] = exitCode;
+        result["output"] = QString::fromUtf8(outBuffer.data());
+        result["error"] = QString::fromUtf8(errBuffer.data());
+        writeResult(result);
+
+        if (exitCode != EXIT_SUCCESS) {
+            ++failed;
+            if (stopOnError) {
+                break;
+            }
+        }
+    }
+
+    QJsonObject summary;
+    summary["command"] = name;
+    summary["executed"] = executed;
+    summary["failed"] = failed;
+
+    // All modifications are written with a single save once every command has run.
+    bool saved = false;
+    bool saveFailed = false;
+    bool aborted = stopOnError && failed > 0;
+    if (!aborted && !parser->isSet(Batch::DryRunOption) && database->isModified()) {
+        QString errorMessage;
+        saved = database->save(&errorMessage, true, false);
+        if (!saved) {
+            saveFailed = true;
+            summary["error"] = QObject::tr("Writing the database failed: %1").arg(errorMessage);
+        }
+    }
+    summary["saved"] = saved;
+
+    int exitCode = (failed > 0 || saveFailed) ? EXIT_FAILURE : EXIT_SUCCESS;
+    summary["exitCode"] = exitCode;
+    writeResult(summary);
+
+    return exitCode;
+}
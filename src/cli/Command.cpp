@@ -18,6 +18,7 @@
 #include "Add.h"
 #include "AddGroup.h"
 #include "Analyze.h"
+#include "Batch.h"
 #include "Clip.h"
 #include "Close.h"
 #include "Create.h"
@@ -37,6 +38,7 @@
 #include "Open.h"
 #include "Remove.h"
 #include "RemoveGroup.h"
+#include "Rotate.h"
 #include "Show.h"
 #include "Utils.h"
 
@@ -70,6 +72,14 @@ const QCommandLineOption Command::YubiKeyOption =
                        QObject::tr("Yubikey slot and optional serial used to access the database (e.g., 1:7370001)."),
                        QObject::tr("slot[:serial]"));
 
+const QCommandLineOption Command::JsonOption =
+    QCommandLineOption(QStringList() << "json", QObject::tr("Output one JSON object per entry (JSON Lines)."));
+
+const QCommandLineOption Command::FieldsOption =
+    QCommandLineOption(QStringList() << "fields",
+                       QObject::tr("Comma-separated list of attributes to include in the JSON output."),
+                       QObject::tr("fields"));
+
 namespace
 {
 
@@ -95,6 +105,7 @@ namespace
 
 Command::Command()
     : currentDatabase(nullptr)
+    , deferSave(false)
 {
     options.append(Command::QuietOption);
 }
@@ -179,12 +190,14 @@ namespace Commands
         s_commands.insert(QStringLiteral("open"), QSharedPointer<Command>(new Open()));
         s_commands.insert(QStringLiteral("rm"), QSharedPointer<Command>(new Remove()));
         s_commands.insert(QStringLiteral("rmdir"), QSharedPointer<Command>(new RemoveGroup()));
+        s_commands.insert(QStringLiteral("rotate"), QSharedPointer<Command>(new Rotate()));
         s_commands.insert(QStringLiteral("show"), QSharedPointer<Command>(new Show()));
 
         if (interactive) {
             s_commands.insert(QStringLiteral("exit"), QSharedPointer<Command>(new Exit("exit")));
             s_commands.insert(QStringLiteral("quit"), QSharedPointer<Command>(new Exit("quit")));
         } else {
+            s_commands.insert(QStringLiteral("batch"), QSharedPointer<Command>(new Batch()));
             s_commands.insert(QStringLiteral("export"), QSharedPointer<Command>(new Export()));
             s_commands.insert(QStringLiteral("import"), QSharedPointer<Command>(new Import()));
         }
@@ -42,6 +42,9 @@ public:
     QString name;
     QString description;
     QSharedPointer<Database> currentDatabase;
+    // When set, commands leave the database modified instead of saving it,
+    // so that the caller (e.g. batch mode) can save once at the end.
+    bool deferSave;
     QList<CommandLineArgument> positionalArguments;
     QList<CommandLineArgument> optionalArguments;
     QList<QCommandLineOption> options;
@@ -55,6 +58,8 @@ public:
     static const QCommandLineOption KeyFileOption;
     static const QCommandLineOption NoPasswordOption;
     static const QCommandLineOption YubiKeyOption;
+    static const QCommandLineOption JsonOption;
+    static const QCommandLineOption FieldsOption;
 };
 
 namespace Commands
@@ -68,3 +68,11 @@ int DatabaseCommand::execute(const QStringList& arguments)
 
     return executeWithDatabase(db, parser);
 }
+
+bool DatabaseCommand::saveDatabase(QSharedPointer<Database> database, QString* error)
+{
+    if (deferSave) {
+        return true;
+    }
+    return database->save(error, true, false);
+}
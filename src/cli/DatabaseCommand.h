@@ -26,6 +26,9 @@ public:
     DatabaseCommand();
     int execute(const QStringList& arguments) override;
     virtual int executeWithDatabase(QSharedPointer<Database> db, QSharedPointer<QCommandLineParser> parser) = 0;
+
+protected:
+    bool saveDatabase(QSharedPointer<Database> database, QString* error);
 };
 
 #endif // KEEPASSXC_DATABASECOMMAND_H
@@ -53,7 +53,13 @@ static void estimate(const char* pwd, bool advanced)
         int pwdLen = 0;
         ZxcMatch_t *info, *p;
         double m = 0.0;
+#ifdef ZXCVBN_HAVE_ARENA
+        // the matches are taken from the arena, which frees them all at once
+        ZxcArena_t* arena = ZxcvbnNewArena();
+        const auto e = ZxcvbnMatchArena(arena, pwd, nullptr, &info);
+#else
         const auto e = ZxcvbnMatch(pwd, nullptr, &info);
+#endif
         for (p = info; p; p = p->Next) {
             m += p->Entrpy;
         }
@@ -138,7 +144,11 @@ static void estimate(const char* pwd, bool advanced)
             out << endl;
             p = p->Next;
         }
+#ifdef ZXCVBN_HAVE_ARENA
+        ZxcvbnFreeArena(arena);
+#else
         ZxcvbnFreeInfo(info);
+#endif
         if (pwdLen != len) {
             out << QObject::tr("*** Password length (%1) != sum of length of parts (%2) ***").arg(len).arg(pwdLen)
                 << endl;
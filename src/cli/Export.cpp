@@ -19,6 +19,7 @@
 
 #include "TextStream.h"
 #include "Utils.h"
+#include "core/Group.h"
 #include "format/CsvExporter.h"
 
 #include <QCommandLineParser>
@@ -26,13 +27,39 @@
 const QCommandLineOption Export::FormatOption = QCommandLineOption(
     QStringList() << "f"
                   << "format",
-    QObject::tr("Format to use when exporting. Available choices are 'xml' or 'csv'. Defaults to 'xml'."),
-    QStringLiteral("xml|csv"));
+    QObject::tr("Format to use when exporting. Available choices are 'xml', 'csv' or 'jsonl'. Defaults to 'xml'."),
+    QStringLiteral("xml|csv|jsonl"));
+
+namespace
+{
+    // Writes one JSON object per entry while walking the tree. Values are exported
+    // verbatim, like the XML and CSV formats, and all attributes are included
+    // unless a subset is requested.
+    void exportJson(QTextStream& out, const Group* group, const QStringList& fields)
+    {
+        for (const Entry* entry : group->entries()) {
+            QJsonObject object;
+            if (fields.isEmpty()) {
+                object = Utils::entryToJson(entry, entry->attributes()->keys(), true, false);
+                object["Created"] = entry->timeInfo().creationTime().toString(Qt::ISODate);
+                object["Last Modified"] = entry->timeInfo().lastModificationTime().toString(Qt::ISODate);
+            } else {
+                object = Utils::entryToJson(entry, fields, true, false);
+            }
+            Utils::writeJsonLine(out, object);
+        }
+
+        for (const Group* child : group->children()) {
+            exportJson(out, child, fields);
+        }
+    }
+} // namespace
 
 Export::Export()
 {
     name = QStringLiteral("export");
     options.append(Export::FormatOption);
+    options.append(Command::FieldsOption);
     description = QObject::tr("Exports the content of a database to standard output in the specified format.");
 }
 
@@ -52,7 +79,13 @@ int Export::executeWithDatabase(QSharedPointer<Database> database, QSharedPointe
         out.write(xmlData.constData());
     } else if (format.startsWith(QStringLiteral("csv"), Qt::CaseInsensitive)) {
         CsvExporter csvExporter;
-        out << csvExporter.exportDatabase(database);
+        if (!csvExporter.exportDatabase(out.device(), database)) {
+            err << QObject::tr("Unable to export database to CSV: %1").arg(csvExporter.errorString()) << endl;
+            return EXIT_FAILURE;
+        }
+    } else if (format.startsWith(QStringLiteral("jsonl"), Qt::CaseInsensitive)) {
+        exportJson(out, database->rootGroup(), Utils::jsonFields(parser->values(Command::FieldsOption)));
+        out.flush();
     } else {
         err << QObject::tr("Unsupported format %1").arg(format) << endl;
         return EXIT_FAILURE;
@@ -58,6 +58,12 @@ const QCommandLineOption Generate::ExcludeSimilarCharsOption =
 
 const QCommandLineOption Generate::IncludeEveryGroupOption =
     QCommandLineOption(QStringList() << "every-group", QObject::tr("Include characters from every selected group"));
+const QCommandLineOption Generate::CountOption =
+    QCommandLineOption(QStringList() << "c"
+                                     << "count",
+                       QObject::tr("Number of passwords to generate, one per line"),
+                       QObject::tr("count"));
+
 Generate::Generate()
 {
     name = QString("generate");
@@ -71,6 +77,7 @@ Generate::Generate()
     options.append(Generate::ExcludeCharsOption);
     options.append(Generate::ExcludeSimilarCharsOption);
     options.append(Generate::IncludeEveryGroupOption);
+    options.append(Generate::CountOption);
 }
 
 /**
@@ -139,14 +146,33 @@ int Generate::execute(const QStringList& arguments)
         return EXIT_FAILURE;
     }
 
+    auto& out = Utils::STDOUT;
+    auto& err = Utils::STDERR;
+
+    int count = 1;
+    if (parser->isSet(Generate::CountOption)) {
+        bool ok;
+        count = parser->value(Generate::CountOption).toInt(&ok);
+        if (!ok || count <= 0) {
+            err << QObject::tr("Invalid password count %1").arg(parser->value(Generate::CountOption)) << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
     QSharedPointer<PasswordGenerator> passwordGenerator = Generate::createGenerator(parser);
     if (passwordGenerator.isNull()) {
         return EXIT_FAILURE;
     }
 
-    auto& out = Utils::STDOUT;
-    QString password = passwordGenerator->generatePassword();
-    out << password << endl;
+    // Generate in batches to bound memory use for large counts
+    constexpr int batchSize = 10000;
+    for (int generated = 0; generated < count; generated += batchSize) {
+        const auto passwords = passwordGenerator->generatePasswords(qMin(batchSize, count - generated));
+        for (const auto& password : passwords) {
+            out << password << '\n';
+        }
+    }
+    out.flush();
 
     return EXIT_SUCCESS;
 }
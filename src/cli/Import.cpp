@@ -19,12 +19,52 @@
 
 #include "Create.h"
 #include "Utils.h"
+#include "core/Group.h"
+#include "format/CsvImporter.h"
 
 #include <QCommandLineParser>
 #include <QFileInfo>
 
+const QCommandLineOption Import::FormatOption = QCommandLineOption(
+    QStringList() << "f"
+                  << "format",
+    QObject::tr("Format of the file to import. Available choices are 'xml' or 'csv'. Defaults to 'xml'."),
+    QStringLiteral("xml|csv"));
+
+namespace
+{
+    // Streams the rows of a CSV file into the database. The columns are taken from
+    // a header row like the one written by the CSV export, or in the same order
+    // if the file has no such header.
+    bool importCsv(const QString& path, Database* db, QString* error)
+    {
+        QFile file(path);
+        if (!file.exists()) {
+            *error = QObject::tr("File %1 does not exist.").arg(path);
+            return false;
+        }
+
+        CsvParser parser;
+        CsvImporter importer(&parser);
+        CsvRow header;
+        parser.parse(&file, [&header](const CsvRow& row) {
+            header = row;
+            return false;
+        });
+        if (importer.setColumnsFromHeader(header)) {
+            importer.setSkippedRows(1);
+        }
+
+        if (!importer.importFile(&file, db)) {
+            *error = importer.errorString();
+            return false;
+        }
+        return true;
+    }
+} // namespace
+
 /**
- * Create a database file from an XML export of another database.
+ * Create a database file from an XML export of another database, or from a CSV file.
  * A password can be specified to encrypt the database.
  * If none is specified the function will fail.
  *
@@ -37,12 +77,14 @@
 Import::Import()
 {
     name = QString("import");
-    description = QObject::tr("Import the contents of an XML database.");
-    positionalArguments.append({QString("xml"), QObject::tr("Path of the XML database export."), QString("")});
+    description = QObject::tr("Import the contents of an XML database or a CSV file.");
+    positionalArguments.append(
+        {QString("file"), QObject::tr("Path of the XML database export or CSV file."), QString("")});
     positionalArguments.append({QString("database"), QObject::tr("Path of the new database."), QString("")});
     options.append(Create::SetKeyFileOption);
     options.append(Create::SetPasswordOption);
     options.append(Create::DecryptionTimeOption);
+    options.append(Import::FormatOption);
 }
 
 int Import::execute(const QStringList& arguments)
@@ -56,9 +98,17 @@ int Import::execute(const QStringList& arguments)
     auto& err = Utils::STDERR;
 
     const QStringList args = parser->positionalArguments();
-    const QString& xmlExportPath = args.at(0);
+    const QString& importPath = args.at(0);
     const QString& dbPath = args.at(1);
 
+    QString format = parser->value(Import::FormatOption);
+    if (format.isEmpty()) {
+        format = QStringLiteral("xml");
+    } else if (format != QStringLiteral("xml") && format != QStringLiteral("csv")) {
+        err << QObject::tr("Unsupported format %1").arg(format) << endl;
+        return EXIT_FAILURE;
+    }
+
     if (QFileInfo::exists(dbPath)) {
         err << QObject::tr("File %1 already exists.").arg(dbPath) << endl;
         return EXIT_FAILURE;
@@ -70,7 +120,12 @@ int Import::execute(const QStringList& arguments)
     }
 
     QString errorMessage;
-    if (!db->import(xmlExportPath, &errorMessage)) {
+    if (format == QStringLiteral("csv")) {
+        if (!importCsv(importPath, db.data(), &errorMessage)) {
+            err << QObject::tr("Unable to import CSV file: %1").arg(errorMessage) << endl;
+            return EXIT_FAILURE;
+        }
+    } else if (!db->import(importPath, &errorMessage)) {
         err << QObject::tr("Unable to import XML database: %1").arg(errorMessage) << endl;
         return EXIT_FAILURE;
     }
@@ -31,12 +31,37 @@ const QCommandLineOption List::FlattenOption = QCommandLineOption(QStringList()
                                                                                 << "flatten",
                                                                   QObject::tr("Flattens the output to single lines."));
 
+namespace
+{
+    // Streams the group contents as JSON Lines while walking the tree, so that
+    // large databases are never formatted into a single string.
+    void printJson(QTextStream& out, const Group* group, bool recursive, const QStringList& fields)
+    {
+        for (const Entry* entry : group->entries()) {
+            Utils::writeJsonLine(out, Utils::entryToJson(entry, fields));
+        }
+
+        for (const Group* child : group->children()) {
+            QJsonObject object;
+            object["type"] = QStringLiteral("group");
+            object["uuid"] = child->uuidToHex();
+            object["path"] = QStringLiteral("/") + child->hierarchy().mid(1).join("/") + QStringLiteral("/");
+            Utils::writeJsonLine(out, object);
+            if (recursive) {
+                printJson(out, child, recursive, fields);
+            }
+        }
+    }
+} // namespace
+
 List::List()
 {
     name = QString("ls");
     description = QObject::tr("List database entries.");
     options.append(List::RecursiveOption);
     options.append(List::FlattenOption);
+    options.append(Command::JsonOption);
+    options.append(Command::FieldsOption);
     optionalArguments.append(
         {QString("group"), QObject::tr("Path of the group to list. Default is /"), QString("[group]")});
 }
@@ -51,16 +76,20 @@ int List::executeWithDatabase(QSharedPointer<Database> database, QSharedPointer<
     bool flatten = parser->isSet(List::FlattenOption);
 
     // No group provided, defaulting to root group.
-    if (args.size() == 1) {
-        out << database->rootGroup()->print(recursive, flatten) << flush;
-        return EXIT_SUCCESS;
+    Group* group = database->rootGroup();
+    if (args.size() > 1) {
+        const QString& groupPath = args.at(1);
+        group = database->rootGroup()->findGroupByPath(groupPath);
+        if (!group) {
+            err << QObject::tr("Cannot find group %1.").arg(groupPath) << endl;
+            return EXIT_FAILURE;
+        }
     }
 
-    const QString& groupPath = args.at(1);
-    Group* group = database->rootGroup()->findGroupByPath(groupPath);
-    if (!group) {
-        err << QObject::tr("Cannot find group %1.").arg(groupPath) << endl;
-        return EXIT_FAILURE;
+    if (parser->isSet(Command::JsonOption)) {
+        printJson(out, group, recursive, Utils::jsonFields(parser->values(Command::FieldsOption)));
+        out << flush;
+        return EXIT_SUCCESS;
     }
 
     out << group->print(recursive, flatten) << flush;
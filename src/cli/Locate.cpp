@@ -22,10 +22,39 @@
 #include "Utils.h"
 #include "core/Group.h"
 
+namespace
+{
+    // Matches entries the same way as Group::locate() but writes each hit as soon
+    // as it is found instead of collecting all paths first.
+    int locateJson(QTextStream& out,
+                   const Group* group,
+                   const QString& locateTerm,
+                   const QString& currentPath,
+                   const QStringList& fields)
+    {
+        int count = 0;
+        for (const Entry* entry : group->entries()) {
+            QString entryPath = currentPath + entry->title();
+            if (entryPath.contains(locateTerm, Qt::CaseInsensitive)) {
+                Utils::writeJsonLine(out, Utils::entryToJson(entry, fields));
+                ++count;
+            }
+        }
+
+        for (const Group* child : group->children()) {
+            count += locateJson(out, child, locateTerm, currentPath + child->name() + QString("/"), fields);
+        }
+
+        return count;
+    }
+} // namespace
+
 Locate::Locate()
 {
     name = QString("locate");
     description = QObject::tr("Find entries quickly.");
+    options.append(Command::JsonOption);
+    options.append(Command::FieldsOption);
     positionalArguments.append({QString("term"), QObject::tr("Search term."), QString("")});
 }
 
@@ -37,6 +66,20 @@ int Locate::executeWithDatabase(QSharedPointer<Database> database, QSharedPointe
     const QStringList args = parser->positionalArguments();
     const QString& searchTerm = args.at(1);
 
+    if (parser->isSet(Command::JsonOption)) {
+        int count = 0;
+        if (!searchTerm.isEmpty()) {
+            count = locateJson(
+                out, database->rootGroup(), searchTerm, "/", Utils::jsonFields(parser->values(Command::FieldsOption)));
+        }
+        out << flush;
+        if (count == 0) {
+            err << "No results for that search term." << endl;
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
     QStringList results = database->rootGroup()->locate(searchTerm);
     if (results.isEmpty()) {
         err << "No results for that search term." << endl;
@@ -0,0 +1,120 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Rotate.h"
+
+#include "Generate.h"
+#include "Utils.h"
+#include "core/EntrySearcher.h"
+#include "core/Group.h"
+#include "core/PasswordGenerator.h"
+#include "core/PasswordRotator.h"
+
+#include <QCommandLineParser>
+
+const QCommandLineOption Rotate::SearchOption =
+    QCommandLineOption("search",
+                       QObject::tr("Only rotate the entries matching the search query, using the same syntax as the "
+                                   "search field of the application."),
+                       QObject::tr("query"));
+
+const QCommandLineOption Rotate::DryRunOption =
+    QCommandLineOption("dry-run", QObject::tr("List the entries that would be rotated without changing them."));
+
+Rotate::Rotate()
+{
+    name = QString("rotate");
+    description = QObject::tr("Generate new passwords for many entries at once.");
+    options.append(Rotate::SearchOption);
+    options.append(Rotate::DryRunOption);
+    optionalArguments.append(
+        {QString("group"), QObject::tr("Path of the group to rotate. Default is /"), QString("[group]")});
+
+    // Password generation options.
+    options.append(Generate::PasswordLengthOption);
+    options.append(Generate::LowerCaseOption);
+    options.append(Generate::UpperCaseOption);
+    options.append(Generate::NumbersOption);
+    options.append(Generate::SpecialCharsOption);
+    options.append(Generate::ExtendedAsciiOption);
+    options.append(Generate::ExcludeCharsOption);
+    options.append(Generate::ExcludeSimilarCharsOption);
+    options.append(Generate::IncludeEveryGroupOption);
+}
+
+int Rotate::executeWithDatabase(QSharedPointer<Database> database, QSharedPointer<QCommandLineParser> parser)
+{
+    auto& out = parser->isSet(Command::QuietOption) ? Utils::DEVNULL : Utils::STDOUT;
+    auto& err = Utils::STDERR;
+
+    const QStringList args = parser->positionalArguments();
+    if (args.size() < 2 && !parser->isSet(Rotate::SearchOption)) {
+        err << QObject::tr("Select the entries to rotate with a group or a search query.") << endl;
+        return EXIT_FAILURE;
+    }
+
+    // Validate the generator before touching any entry.
+    QSharedPointer<PasswordGenerator> passwordGenerator = Generate::createGenerator(parser);
+    if (passwordGenerator.isNull()) {
+        return EXIT_FAILURE;
+    }
+
+    Group* group = database->rootGroup();
+    if (args.size() > 1) {
+        const QString& groupPath = args.at(1);
+        group = database->rootGroup()->findGroupByPath(groupPath);
+        if (!group) {
+            err << QObject::tr("Cannot find group %1.").arg(groupPath) << endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    QList<Entry*> entries;
+    if (parser->isSet(Rotate::SearchOption)) {
+        entries = EntrySearcher().search(parser->value(Rotate::SearchOption), group, true);
+    } else {
+        entries = group->entriesRecursive();
+    }
+
+    PasswordRotator rotator(*passwordGenerator);
+    if (parser->isSet(Rotate::DryRunOption)) {
+        const auto targets = rotator.rotatable(entries);
+        for (const auto entry : targets) {
+            out << entry->path() << '\n';
+        }
+        out << QObject::tr("Would rotate %n password(s).", nullptr, targets.size()) << endl;
+        return EXIT_SUCCESS;
+    }
+
+    const auto rotated = rotator.rotate(entries);
+    if (rotated.isEmpty()) {
+        err << QObject::tr("No entries to rotate.") << endl;
+        return EXIT_FAILURE;
+    }
+
+    QString errorMessage;
+    if (!saveDatabase(database, &errorMessage)) {
+        err << QObject::tr("Writing the database failed: %1").arg(errorMessage) << endl;
+        return EXIT_FAILURE;
+    }
+
+    for (const auto entry : rotated) {
+        out << entry->path() << '\n';
+    }
+    out << QObject::tr("Rotated %n password(s).", nullptr, rotated.size()) << endl;
+    return EXIT_SUCCESS;
+}
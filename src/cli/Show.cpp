@@ -40,6 +40,21 @@ const QCommandLineOption Show::AttributesOption = QCommandLineOption(
         "If no attributes are specified, a summary of the default attributes is given."),
     QObject::tr("attribute"));
 
+namespace
+{
+    // Reports an attribute name that matches no attribute or several of them
+    void printAttributeError(QTextStream& err, const QString& attributeName, const QStringList& attrs)
+    {
+        if (attrs.isEmpty()) {
+            err << QObject::tr("ERROR: unknown attribute %1.").arg(attributeName) << endl;
+        } else {
+            err << QObject::tr("ERROR: attribute %1 is ambiguous, it matches %2.")
+                       .arg(attributeName, QLocale().createSeparatedList(attrs))
+                << endl;
+        }
+    }
+} // namespace
+
 Show::Show()
 {
     name = QString("show");
@@ -47,6 +62,7 @@ Show::Show()
     options.append(Show::TotpOption);
     options.append(Show::AttributesOption);
     options.append(Show::ProtectedAttributesOption);
+    options.append(Command::JsonOption);
     positionalArguments.append({QString("entry"), QObject::tr("Name of the entry to show."), QString("")});
 }
 
@@ -72,6 +88,27 @@ int Show::executeWithDatabase(QSharedPointer<Database> database, QSharedPointer<
         return EXIT_FAILURE;
     }
 
+    if (parser->isSet(Command::JsonOption)) {
+        QStringList unresolved;
+        QJsonObject object = Utils::entryToJson(entry, attributes, showProtectedAttributes, true, &unresolved);
+        for (const QString& attributeName : asConst(unresolved)) {
+            object.remove(attributeName);
+            printAttributeError(err, attributeName, Utils::findAttributes(*entry->attributes(), attributeName));
+        }
+        if (showTotp) {
+            // Like the text output, only the TOTP is shown unless attributes are asked for
+            if (attributes.isEmpty()) {
+                for (const QString& attributeName : EntryAttributes::DefaultAttributes) {
+                    object.remove(attributeName);
+                }
+            }
+            object["TOTP"] = entry->totp();
+        }
+        Utils::writeJsonLine(out, object);
+        out << flush;
+        return unresolved.isEmpty() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     // If no attributes specified, output the default attribute set.
     bool showDefaultAttributes = attributes.isEmpty() && !showTotp;
     if (showDefaultAttributes) {
@@ -82,15 +119,9 @@ int Show::executeWithDatabase(QSharedPointer<Database> database, QSharedPointer<
     bool encounteredError = false;
     for (const QString& attributeName : asConst(attributes)) {
         QStringList attrs = Utils::findAttributes(*entry->attributes(), attributeName);
-        if (attrs.isEmpty()) {
-            encounteredError = true;
-            err << QObject::tr("ERROR: unknown attribute %1.").arg(attributeName) << endl;
-            continue;
-        } else if (attrs.size() > 1) {
+        if (attrs.size() != 1) {
             encounteredError = true;
-            err << QObject::tr("ERROR: attribute %1 is ambiguous, it matches %2.")
-                       .arg(attributeName, QLocale().createSeparatedList(attrs))
-                << endl;
+            printAttributeError(err, attributeName, attrs);
             continue;
         }
         QString canonicalName = attrs[0];
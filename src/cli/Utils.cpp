@@ -18,7 +18,9 @@
 #include "Utils.h"
 
 #include "core/Database.h"
+#include "core/Entry.h"
 #include "core/EntryAttributes.h"
+#include "core/Group.h"
 #include "keys/FileKey.h"
 #ifdef WITH_XC_YUBIKEY
 #include "keys/ChallengeResponseKey.h"
@@ -32,6 +34,7 @@
 #endif
 
 #include <QFileInfo>
+#include <QJsonDocument>
 #include <QProcess>
 
 namespace Utils
@@ -385,6 +388,56 @@ namespace Utils
         return result;
     }
 
+    QJsonObject entryToJson(const Entry* entry,
+                            const QStringList& attributes,
+                            bool showProtected,
+                            bool resolvePlaceholders,
+                            QStringList* unresolved)
+    {
+        QJsonObject object;
+        object["type"] = QStringLiteral("entry");
+        object["uuid"] = entry->uuidToHex();
+        object["path"] = QStringLiteral("/") + entry->path();
+
+        bool defaultAttributes = attributes.isEmpty();
+        const QStringList& names = defaultAttributes ? EntryAttributes::DefaultAttributes : attributes;
+        for (const QString& name : names) {
+            QStringList attrs = findAttributes(*entry->attributes(), name);
+            if (attrs.size() != 1) {
+                object[name] = QJsonValue::Null;
+                if (unresolved) {
+                    unresolved->append(name);
+                }
+                continue;
+            }
+            const QString& canonicalName = attrs.first();
+            if (defaultAttributes && !showProtected && entry->attributes()->isProtected(canonicalName)) {
+                object[canonicalName] = QStringLiteral("PROTECTED");
+                continue;
+            }
+            QString value = entry->attributes()->value(canonicalName);
+            object[canonicalName] = resolvePlaceholders ? entry->resolveMultiplePlaceholders(value) : value;
+        }
+
+        return object;
+    }
+
+    void writeJsonLine(QTextStream& out, const QJsonObject& object)
+    {
+        out << QString::fromUtf8(QJsonDocument(object).toJson(QJsonDocument::Compact)) << '\n';
+    }
+
+    QStringList jsonFields(const QStringList& values)
+    {
+        QStringList fields;
+        for (const QString& value : values) {
+            for (const QString& field : value.split(',', QString::SkipEmptyParts)) {
+                fields << field.trimmed();
+            }
+        }
+        return fields;
+    }
+
     /**
      * Load a key file from disk. When the path specified does not exist a
      * new file will be generated. No folders will be generated so the parent
@@ -18,10 +18,12 @@
 #ifndef KEEPASSXC_UTILS_H
 #define KEEPASSXC_UTILS_H
 
+#include <QJsonObject>
 #include <QTextStream>
 
 class CompositeKey;
 class Database;
+class Entry;
 class EntryAttributes;
 class FileKey;
 class PasswordKey;
@@ -55,6 +57,26 @@ namespace Utils
      * (case-insensitive).
      */
     QStringList findAttributes(const EntryAttributes& attributes, const QString& name);
+
+    /**
+     * Returns a JSON object describing `entry` with its uuid, path and the
+     * requested attributes. If `attributes` is empty, the default attributes
+     * are used and protected values are masked unless `showProtected` is set.
+     * Names that match no attribute or several are set to null and, if given,
+     * added to `unresolved`.
+     */
+    QJsonObject entryToJson(const Entry* entry,
+                            const QStringList& attributes,
+                            bool showProtected = false,
+                            bool resolvePlaceholders = true,
+                            QStringList* unresolved = nullptr);
+
+    /**
+     * Writes `object` as a single line of JSON (JSON Lines). The stream is not
+     * flushed so that long listings are written out in buffered chunks.
+     */
+    void writeJsonLine(QTextStream& out, const QJsonObject& object);
+    QStringList jsonFields(const QStringList& values);
 }; // namespace Utils
 
 #endif // KEEPASSXC_UTILS_H
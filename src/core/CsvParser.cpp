@@ -20,33 +20,34 @@
 
 #include <QFile>
 #include <QTextCodec>
+#include <QTextDecoder>
 
 #include "core/Tools.h"
 
+namespace
+{
+    // Number of bytes decoded and scanned at once
+    const qint64 ChunkSize = 1024 * 1024;
+} // namespace
+
 CsvParser::CsvParser()
-    : m_ch(0)
+    : m_codec(QTextCodec::codecForName("UTF-8"))
     , m_comment('#')
     , m_currCol(1)
     , m_currRow(1)
+    , m_fileSize(0)
     , m_isBackslashSyntax(false)
-    , m_isEof(false)
     , m_isFileLoaded(false)
     , m_isGood(true)
-    , m_lastPos(-1)
     , m_maxCols(0)
     , m_qualifier('"')
     , m_separator(',')
     , m_statusMsg("")
 {
-    m_csv.setBuffer(&m_array);
-    m_ts.setDevice(&m_csv);
-    m_csv.open(QIODevice::ReadOnly);
-    m_ts.setCodec("UTF-8");
 }
 
 CsvParser::~CsvParser()
 {
-    m_csv.close();
 }
 
 bool CsvParser::isFileLoaded()
@@ -60,6 +61,17 @@ bool CsvParser::reparse()
     return parseFile();
 }
 
+bool CsvParser::parseFile()
+{
+    m_table.clear();
+    bool result = parseData(m_array.constData(), m_array.size(), [this](const CsvRow& row) {
+        m_table.append(row);
+        return true;
+    });
+    fillColumns();
+    return result;
+}
+
 bool CsvParser::parse(QFile* device)
 {
     clear();
@@ -73,6 +85,47 @@ bool CsvParser::parse(QFile* device)
     return parseFile();
 }
 
+bool CsvParser::parse(QFile* device, const RowCallback& callback)
+{
+    clear();
+    if (!device) {
+        appendStatusMsg(QObject::tr("NULL device"), true);
+        return false;
+    }
+    if (device->isOpen()) {
+        device->close();
+    }
+    if (!device->open(QIODevice::ReadOnly)) {
+        appendStatusMsg(QObject::tr("error reading from device"), true);
+        return false;
+    }
+
+    m_fileSize = device->size();
+    if (m_fileSize == 0) {
+        device->close();
+        appendStatusMsg(QObject::tr("file empty").append("\n"));
+        return true;
+    }
+
+    bool result;
+    uchar* data = device->map(0, m_fileSize);
+    if (data) {
+        result = parseData(reinterpret_cast<const char*>(data), m_fileSize, callback);
+        device->unmap(data);
+    } else {
+        // not a regular file, fall back to reading it into memory
+        if (!Tools::readAllFromDevice(device, m_array)) {
+            device->close();
+            appendStatusMsg(QObject::tr("error reading from device"), true);
+            return false;
+        }
+        result = parseData(m_array.constData(), m_array.size(), callback);
+        m_array.clear();
+    }
+    device->close();
+    return result;
+}
+
 bool CsvParser::readFile(QFile* device)
 {
     if (device->isOpen()) {
@@ -86,8 +139,7 @@ bool CsvParser::readFile(QFile* device)
     } else {
         device->close();
 
-        m_array.replace("\r\n", "\n");
-        m_array.replace("\r", "\n");
+        m_fileSize = m_array.size();
         if (m_array.isEmpty()) {
             appendStatusMsg(QObject::tr("file empty").append("\n"));
         }
@@ -98,16 +150,11 @@ bool CsvParser::readFile(QFile* device)
 
 void CsvParser::reset()
 {
-    m_ch = 0;
     m_currCol = 1;
     m_currRow = 1;
-    m_isEof = false;
     m_isGood = true;
-    m_lastPos = -1;
     m_maxCols = 0;
     m_statusMsg = "";
-    m_ts.seek(0);
-    m_table.clear();
     // the following are users' concern :)
     // m_comment = '#';
     // m_backslashSyntax = false;
@@ -120,142 +167,222 @@ void CsvParser::clear()
 {
     reset();
     m_isFileLoaded = false;
+    m_fileSize = 0;
     m_array.clear();
 }
 
-bool CsvParser::parseFile()
+bool CsvParser::parseData(const char* data, qint64 size, const RowCallback& callback)
 {
-    parseRecord();
-    while (!m_isEof) {
-        if (!skipEndline()) {
-            appendStatusMsg(QObject::tr("malformed string"), true);
+    // honour a byte order mark the same way QTextStream does
+    QTextCodec* codec = QTextCodec::codecForUtfText(QByteArray::fromRawData(data, qMin<qint64>(size, 4)), m_codec);
+    QScopedPointer<QTextDecoder> decoder(codec->makeDecoder());
+
+    QString text;
+    CsvRow row;
+    qint64 offset = 0;
+    bool atEnd = false;
+    while (!atEnd) {
+        // decode the next chunk, keeping the incomplete record left over from the previous one
+        const qint64 length = qMin(ChunkSize, size - offset);
+        text.append(decoder->toUnicode(data + offset, static_cast<int>(length)));
+        offset += length;
+        atEnd = offset >= size;
+
+        int pos = 0;
+        while (pos < text.size()) {
+            row.clear();
+            int next = parseRecord(text, pos, atEnd, row);
+            if (next < 0) {
+                break;
+            }
+            pos = next;
+            if (!isEmptyRow(row)) {
+                if (m_maxCols < row.size()) {
+                    m_maxCols = row.size();
+                }
+                if (!callback(row)) {
+                    return m_isGood;
+                }
+            }
+            m_currRow++;
+            m_currCol = 1;
         }
-        m_currRow++;
-        m_currCol = 1;
-        parseRecord();
+        text.remove(0, pos);
     }
-    fillColumns();
     return m_isGood;
 }
 
-void CsvParser::parseRecord()
+int CsvParser::parseRecord(const QString& text, int pos, bool atEnd, CsvRow& row)
 {
-    CsvRow row;
-    if (isComment()) {
-        skipLine();
-        return;
+    // lines starting with the comment character (after blanks) are skipped
+    int i = pos;
+    while (i < text.size() && (text.at(i) == ' ' || text.at(i) == '\t')) {
+        ++i;
     }
-    do {
-        parseField(row);
-        getChar(m_ch);
-    } while (isSeparator(m_ch) && !m_isEof);
-
-    if (!m_isEof) {
-        ungetChar();
+    if (i == text.size() && !atEnd) {
+        return -1;
     }
-    if (isEmptyRow(row)) {
-        row.clear();
-        return;
+    if (i < text.size() && text.at(i) == m_comment) {
+        return skipComment(text, i, atEnd);
     }
-    m_table.push_back(row);
-    if (m_maxCols < row.size()) {
-        m_maxCols = row.size();
-    }
-    m_currCol++;
-}
 
-void CsvParser::parseField(CsvRow& row)
-{
-    QString field;
-    peek(m_ch);
-    if (!isTerminator(m_ch)) {
-        if (isQualifier(m_ch)) {
-            parseQuoted(field);
+    while (true) {
+        QString field;
+        if (pos == text.size()) {
+            if (!atEnd) {
+                return -1;
+            }
+        } else if (isQualifier(text.at(pos))) {
+            pos = parseQuoted(text, pos, atEnd, field);
         } else {
-            parseSimple(field);
+            pos = parseSimple(text, pos, field);
+            if (pos == text.size() && !atEnd) {
+                return -1;
+            }
+        }
+        if (pos < 0) {
+            return -1;
+        }
+        row.append(field);
+
+        if (pos == text.size()) {
+            // a record is only complete at a line break or at the end of the data
+            return atEnd ? pos : -1;
         }
+        if (text.at(pos) == m_separator) {
+            ++pos;
+            m_currCol++;
+            continue;
+        }
+
+        int next = skipEndline(text, pos, atEnd);
+        if (next == 0) {
+            return -1;
+        }
+        if (next < 0) {
+            // drop the offending character and carry on with the next record
+            appendStatusMsg(QObject::tr("malformed string"), true);
+            return pos + 1;
+        }
+        return next;
     }
-    row.push_back(field);
 }
 
-void CsvParser::parseSimple(QString& s)
+int CsvParser::parseSimple(const QString& text, int pos, QString& field) const
 {
-    QChar c;
-    getChar(c);
-    while ((isText(c)) && (!m_isEof)) {
-        s.append(c);
-        getChar(c);
-    }
-    if (!m_isEof) {
-        ungetChar();
+    // unquoted text runs up to the next separator or line break
+    const QChar* begin = text.constData();
+    const QChar* end = begin + text.size();
+    const ushort separator = m_separator.unicode();
+    const QChar* it = begin + pos;
+    for (; it != end; ++it) {
+        const ushort c = it->unicode();
+        if (c == separator || c == '\n' || c == '\r') {
+            break;
+        }
     }
+    const int next = static_cast<int>(it - begin);
+    field = text.mid(pos, next - pos);
+    return next;
 }
 
-void CsvParser::parseQuoted(QString& s)
+int CsvParser::parseQuoted(const QString& text, int pos, bool atEnd, QString& field)
 {
-    // read and discard initial qualifier (e.g. quote)
-    getChar(m_ch);
-    parseEscaped(s);
-    if (!isQualifier(m_ch)) {
-        appendStatusMsg(QObject::tr("missing closing quote"), true);
+    const QChar opening = text.at(pos);
+    ++pos;
+    if (m_isBackslashSyntax && opening == '\\' && pos == text.size() && atEnd) {
+        // a lone escape character at the end of the data is taken literally
+        field = "\\";
+        return pos;
     }
-}
 
-void CsvParser::parseEscaped(QString& s)
-{
-    parseEscapedText(s);
-    while (processEscapeMark(s, m_ch)) {
-        parseEscapedText(s);
+    while (true) {
+        // jump straight to the next qualifier or escape character
+        int next = text.indexOf(m_qualifier, pos);
+        if (m_isBackslashSyntax && m_qualifier != '\\') {
+            int escape = text.indexOf('\\', pos);
+            if (escape >= 0 && (next < 0 || escape < next)) {
+                next = escape;
+            }
+        }
+
+        if (next < 0) {
+            if (!atEnd) {
+                return -1;
+            }
+            field.append(text.midRef(pos));
+            appendStatusMsg(QObject::tr("missing closing quote"), true);
+            pos = text.size();
+            break;
+        }
+        field.append(text.midRef(pos, next - pos));
+
+        if (next + 1 == text.size() && !atEnd) {
+            // need the following character to tell an escape from the closing qualifier
+            return -1;
+        }
+        if (m_isBackslashSyntax) {
+            if (text.at(next) != '\\') {
+                pos = next + 1;
+                break;
+            }
+            // escape-character syntax, e.g. \"
+            if (next + 1 == text.size()) {
+                field.append('\\');
+                pos = next + 1;
+                break;
+            }
+            field.append(text.at(next + 1));
+            pos = next + 2;
+        } else {
+            // double quote syntax, e.g. ""
+            if (next + 1 < text.size() && text.at(next + 1) == m_qualifier) {
+                field.append(m_qualifier);
+                pos = next + 2;
+            } else {
+                pos = next + 1;
+                break;
+            }
+        }
     }
-    if (!m_isEof) {
-        ungetChar();
+
+    if (field.contains('\r')) {
+        field.replace("\r\n", "\n");
+        field.replace('\r', '\n');
     }
+    return pos;
 }
 
-void CsvParser::parseEscapedText(QString& s)
+int CsvParser::skipComment(const QString& text, int pos, bool atEnd) const
 {
-    getChar(m_ch);
-    while ((!isQualifier(m_ch)) && !m_isEof) {
-        s.append(m_ch);
-        getChar(m_ch);
+    while (pos < text.size()) {
+        int next = skipEndline(text, pos, atEnd);
+        if (next != -1) {
+            return next > 0 ? next : -1;
+        }
+        ++pos;
     }
+    return atEnd ? pos : -1;
 }
 
-bool CsvParser::processEscapeMark(QString& s, QChar c)
+/**
+ * Consume the line break at pos.
+ *
+ * @return position after the line break, 0 when more data is needed or -1 if there is no line break at pos
+ */
+int CsvParser::skipEndline(const QString& text, int pos, bool atEnd) const
 {
-    QChar buf;
-    peek(buf);
-    QChar c2;
-    if (true == m_isBackslashSyntax) {
-        // escape-character syntax, e.g. \"
-        if (c != '\\') {
-            return false;
-        }
-        // consume (and append) second qualifier
-        getChar(c2);
-        if (m_isEof) {
-            c2 = '\\';
-            s.append('\\');
-            return false;
-        } else {
-            s.append(c2);
-            return true;
-        }
-    } else {
-        // double quote syntax, e.g. ""
-        if (!isQualifier(c)) {
-            return false;
-        }
-        peek(c2);
-        if (!m_isEof) { // not EOF, can read one char
-            if (isQualifier(c2)) {
-                s.append(c2);
-                getChar(c2);
-                return true;
-            }
-        }
-        return false;
+    const QChar c = text.at(pos);
+    if (c == '\n') {
+        return pos + 1;
+    }
+    if (c != '\r') {
+        return -1;
     }
+    if (pos + 1 == text.size()) {
+        return atEnd ? pos + 1 : 0;
+    }
+    return text.at(pos + 1) == '\n' ? pos + 2 : pos + 1;
 }
 
 void CsvParser::fillColumns()
@@ -264,52 +391,14 @@ void CsvParser::fillColumns()
     for (int i = 0; i < m_table.size(); ++i) {
         int gap = m_maxCols - m_table.at(i).size();
         if (gap > 0) {
-            CsvRow r = m_table.at(i);
+            CsvRow& r = m_table[i];
             for (int j = 0; j < gap; ++j) {
                 r.append(QString(""));
             }
-            m_table.replace(i, r);
         }
     }
 }
 
-void CsvParser::skipLine()
-{
-    m_ts.readLine();
-    m_ts.seek(m_ts.pos() - 1);
-}
-
-bool CsvParser::skipEndline()
-{
-    getChar(m_ch);
-    return (m_ch == '\n');
-}
-
-void CsvParser::getChar(QChar& c)
-{
-    m_isEof = m_ts.atEnd();
-    if (!m_isEof) {
-        m_lastPos = m_ts.pos();
-        m_ts >> c;
-    }
-}
-
-void CsvParser::ungetChar()
-{
-    if (!m_ts.seek(m_lastPos)) {
-        qWarning("CSV Parser: unget lower bound exceeded");
-        m_isGood = false;
-    }
-}
-
-void CsvParser::peek(QChar& c)
-{
-    getChar(c);
-    if (!m_isEof) {
-        ungetChar();
-    }
-}
-
 bool CsvParser::isQualifier(const QChar& c) const
 {
     if (true == m_isBackslashSyntax && (c != m_qualifier)) {
@@ -319,28 +408,6 @@ bool CsvParser::isQualifier(const QChar& c) const
     }
 }
 
-bool CsvParser::isComment()
-{
-    bool result = false;
-    QChar c2;
-    qint64 pos = m_ts.pos();
-
-    do {
-        getChar(c2);
-    } while ((isSpace(c2) || isTab(c2)) && (!m_isEof));
-
-    if (c2 == m_comment) {
-        result = true;
-    }
-    m_ts.seek(pos);
-    return result;
-}
-
-bool CsvParser::isText(QChar c) const
-{
-    return !((isCRLF(c)) || (isSeparator(c)));
-}
-
 bool CsvParser::isEmptyRow(const CsvRow& row) const
 {
     CsvRow::const_iterator it = row.constBegin();
@@ -352,31 +419,6 @@ bool CsvParser::isEmptyRow(const CsvRow& row) const
     return true;
 }
 
-bool CsvParser::isCRLF(const QChar& c) const
-{
-    return (c == '\n');
-}
-
-bool CsvParser::isSpace(const QChar& c) const
-{
-    return (c == ' ');
-}
-
-bool CsvParser::isTab(const QChar& c) const
-{
-    return (c == '\t');
-}
-
-bool CsvParser::isSeparator(const QChar& c) const
-{
-    return (c == m_separator);
-}
-
-bool CsvParser::isTerminator(const QChar& c) const
-{
-    return (isSeparator(c) || (c == '\n') || (c == '\r'));
-}
-
 void CsvParser::setBackslashSyntax(bool set)
 {
     m_isBackslashSyntax = set;
@@ -389,7 +431,10 @@ void CsvParser::setComment(const QChar& c)
 
 void CsvParser::setCodec(const QString& s)
 {
-    m_ts.setCodec(QTextCodec::codecForName(s.toLocal8Bit()));
+    QTextCodec* codec = QTextCodec::codecForName(s.toLocal8Bit());
+    if (codec) {
+        m_codec = codec;
+    }
 }
 
 void CsvParser::setFieldSeparator(const QChar& c)
@@ -402,9 +447,9 @@ void CsvParser::setTextQualifier(const QChar& c)
     m_qualifier = c.unicode();
 }
 
-int CsvParser::getFileSize() const
+qint64 CsvParser::getFileSize() const
 {
-    return m_csv.size();
+    return m_fileSize;
 }
 
 const CsvTable CsvParser::getCsvTable() const
@@ -19,22 +19,36 @@
 #ifndef KEEPASSX_CSVPARSER_H
 #define KEEPASSX_CSVPARSER_H
 
-#include <QBuffer>
-#include <QTextStream>
+#include <QStringList>
+#include <functional>
 
 class QFile;
+class QTextCodec;
 
 typedef QStringList CsvRow;
 typedef QList<CsvRow> CsvTable;
 
+/**
+ * Parser for CSV files.
+ *
+ * The file contents are decoded chunk by chunk and scanned in bulk for separators,
+ * qualifiers and line breaks. Rows are either collected into a table (see getCsvTable())
+ * or handed one at a time to a callback, in which case only the row being parsed is
+ * held in memory and the file itself is memory-mapped.
+ */
 class CsvParser
 {
 
 public:
+    // Receives each parsed row, returning false stops parsing
+    typedef std::function<bool(const CsvRow&)> RowCallback;
+
     CsvParser();
     ~CsvParser();
     // read data from device and parse it
     bool parse(QFile* device);
+    // parse the device without building a table, rows are not padded to equal size
+    bool parse(QFile* device, const RowCallback& callback);
     bool isFileLoaded();
     // reparse the same buffer (device is not opened again)
     bool reparse();
@@ -43,7 +57,7 @@ public:
     void setFieldSeparator(const QChar& c);
     void setTextQualifier(const QChar& c);
     void setBackslashSyntax(bool set);
-    int getFileSize() const;
+    qint64 getFileSize() const;
     int getCsvRows() const;
     int getCsvCols() const;
     QString getStatus() const;
@@ -54,48 +68,32 @@ protected:
 
 private:
     QByteArray m_array;
-    QBuffer m_csv;
-    QChar m_ch;
+    QTextCodec* m_codec;
     QChar m_comment;
     unsigned int m_currCol;
     unsigned int m_currRow;
+    qint64 m_fileSize;
     bool m_isBackslashSyntax;
-    bool m_isEof;
     bool m_isFileLoaded;
     bool m_isGood;
-    qint64 m_lastPos;
     int m_maxCols;
     QChar m_qualifier;
     QChar m_separator;
     QString m_statusMsg;
-    QTextStream m_ts;
 
-    void getChar(QChar& c);
-    void ungetChar();
-    void peek(QChar& c);
     void fillColumns();
-    bool isTerminator(const QChar& c) const;
-    bool isSeparator(const QChar& c) const;
     bool isQualifier(const QChar& c) const;
-    bool processEscapeMark(QString& s, QChar c);
-    bool isText(QChar c) const;
-    bool isComment();
-    bool isCRLF(const QChar& c) const;
-    bool isSpace(const QChar& c) const;
-    bool isTab(const QChar& c) const;
     bool isEmptyRow(const CsvRow& row) const;
     bool parseFile();
-    void parseRecord();
-    void parseField(CsvRow& row);
-    void parseSimple(QString& s);
-    void parseQuoted(QString& s);
-    void parseEscaped(QString& s);
-    void parseEscapedText(QString& s);
+    bool parseData(const char* data, qint64 size, const RowCallback& callback);
+    int parseRecord(const QString& text, int pos, bool atEnd, CsvRow& row);
+    int parseSimple(const QString& text, int pos, QString& field) const;
+    int parseQuoted(const QString& text, int pos, bool atEnd, QString& field);
+    int skipComment(const QString& text, int pos, bool atEnd) const;
+    int skipEndline(const QString& text, int pos, bool atEnd) const;
     bool readFile(QFile* device);
     void reset();
     void clear();
-    bool skipEndline();
-    void skipLine();
     void appendStatusMsg(const QString& s, bool isCritical = false);
 };
 
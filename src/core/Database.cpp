@@ -21,6 +21,7 @@
 #include "core/AsyncTask.h"
 #include "core/FileWatcher.h"
 #include "core/Group.h"
+#include "core/PasswordHealth.h"
 #include "format/KdbxXmlReader.h"
 #include "format/KeePass2Reader.h"
 #include "format/KeePass2Writer.h"
@@ -39,6 +40,7 @@ Database::Database()
     , m_data()
     , m_rootGroup(nullptr)
     , m_fileWatcher(new FileWatcher(this))
+    , m_reuseIndex(new PasswordReuseIndex(this))
     , m_uuid(QUuid::createUuid())
 {
     // setup modified timer
@@ -563,6 +565,7 @@ void Database::setRootGroup(Group* group)
 
     m_rootGroup = group;
     m_rootGroup->setParent(this);
+    m_reuseIndex->invalidate();
 }
 
 Metadata* Database::metadata()
@@ -664,6 +667,14 @@ void Database::addDeletedObject(const QUuid& uuid)
     addDeletedObject(delObj);
 }
 
+/**
+ * Index of the entries sharing a password, used by the password health checks.
+ */
+PasswordReuseIndex* Database::reuseIndex() const
+{
+    return m_reuseIndex;
+}
+
 QList<QString> Database::commonUsernames()
 {
     return m_commonUsernames;
@@ -875,12 +886,59 @@ bool Database::hasNonDataChanges() const
 void Database::markAsModified()
 {
     m_modified = true;
-    if (!m_modifiedTimer.isActive()) {
+    if (m_batchUpdateDepth > 0) {
+        // The modified signal is emitted once the batch update ends
+        m_modifiedInBatch = true;
+        return;
+    }
+    if (!m_modifiedTimer.isActive() && modifiedSignalEnabled()) {
         // Small time delay prevents numerous consecutive saves due to repeated signals
         startModifiedTimer();
     }
 }
 
+/**
+ * Starts a batch of changes, such as a merge or an import. Views connected to
+ * batchUpdateStarted() may skip the per-item signals until batchUpdateFinished()
+ * and reload at once, and the modified signal is emitted only once at the end.
+ *
+ * Batch updates can be nested; every call must be paired with endBatchUpdate().
+ */
+void Database::beginBatchUpdate()
+{
+    if (m_batchUpdateDepth++ > 0) {
+        return;
+    }
+
+    if (m_modifiedTimer.isActive()) {
+        stopModifiedTimer();
+        m_modifiedInBatch = true;
+    }
+    emit batchUpdateStarted();
+}
+
+void Database::endBatchUpdate()
+{
+    Q_ASSERT(m_batchUpdateDepth > 0);
+    if (m_batchUpdateDepth <= 0 || --m_batchUpdateDepth > 0) {
+        return;
+    }
+
+    emit batchUpdateFinished();
+
+    if (m_modifiedInBatch) {
+        m_modifiedInBatch = false;
+        if (m_modified) {
+            startModifiedTimer();
+        }
+    }
+}
+
+bool Database::isBatchUpdating() const
+{
+    return m_batchUpdateDepth > 0;
+}
+
 void Database::markAsClean()
 {
     bool emitSignal = m_modified;
@@ -37,6 +37,7 @@ enum class EntryReferenceType;
 class FileWatcher;
 class Group;
 class Metadata;
+class PasswordReuseIndex;
 class QIODevice;
 
 struct DeletedObject
@@ -112,6 +113,11 @@ public:
     void setDeletedObjects(const QList<DeletedObject>& delObjs);
 
     QList<QString> commonUsernames();
+    PasswordReuseIndex* reuseIndex() const;
+
+    void beginBatchUpdate();
+    void endBatchUpdate();
+    bool isBatchUpdating() const;
 
     QSharedPointer<const CompositeKey> key() const;
     bool setKey(const QSharedPointer<const CompositeKey>& key,
@@ -148,6 +154,11 @@ signals:
     void groupRemoved();
     void groupAboutToMove(Group* group, Group* toGroup, int index);
     void groupMoved();
+    void entryAdded(Entry* entry);
+    void entryAboutToRemove(Entry* entry);
+    void entryDataChanged(Entry* entry);
+    void batchUpdateStarted();
+    void batchUpdateFinished();
     void databaseOpened();
     void databaseSaved();
     void databaseDiscarded();
@@ -209,7 +220,10 @@ private:
     QTimer m_modifiedTimer;
     QMutex m_saveMutex;
     QPointer<FileWatcher> m_fileWatcher;
+    QPointer<PasswordReuseIndex> m_reuseIndex;
     bool m_modified = false;
+    bool m_modifiedInBatch = false;
+    int m_batchUpdateDepth = 0;
     bool m_hasNonDataChange = false;
     QString m_keyError;
 
@@ -23,7 +23,6 @@
 #include <QDir>
 #include <QImageReader>
 #include <QPainter>
-#include <QPixmapCache>
 
 DatabaseIcons* DatabaseIcons::m_instance(nullptr);
 
@@ -34,6 +33,14 @@ namespace
 
     const QString badgeDir = QStringLiteral(":/icons/badges/");
     QStringList badgeList;
+
+    // Upper bound of the shared pixmap cache in KiB
+    const int PixmapCacheSize = 32 * 1024;
+
+    int pixmapCost(const QPixmap& pixmap)
+    {
+        return qMax(1, pixmap.width() * pixmap.height() * pixmap.depth() / 8 / 1024);
+    }
 } // namespace
 
 DatabaseIcons::DatabaseIcons()
@@ -43,6 +50,7 @@ DatabaseIcons::DatabaseIcons()
 
     // Set this early and once to ensure consistent icon size until app restart
     m_compactMode = config()->get(Config::GUI_CompactMode).toBool();
+    m_pixmapCache.setMaxCost(PixmapCacheSize);
 }
 
 DatabaseIcons* DatabaseIcons::instance()
@@ -72,13 +80,36 @@ QPixmap DatabaseIcons::icon(int index, IconSize size)
     return icon.pixmap(iconSize(size));
 }
 
+QPixmap DatabaseIcons::customIcon(const QByteArray& digest, const QByteArray& pngData, IconSize size)
+{
+    const int extent = iconSize(size);
+    const auto cacheKey = qMakePair(digest, extent);
+    if (auto cached = m_pixmapCache.object(cacheKey)) {
+        return *cached;
+    }
+
+    // Identical icons share a digest, so each image is decoded once no matter how many databases use it
+    QImage image;
+    image.loadFromData(pngData);
+    QIcon icon(QPixmap::fromImage(image.scaled(64, 64, Qt::IgnoreAspectRatio, Qt::SmoothTransformation)));
+    auto pixmap = icon.pixmap(extent);
+
+    m_pixmapCache.insert(cacheKey, new QPixmap(pixmap), pixmapCost(pixmap));
+    return pixmap;
+}
+
 QPixmap DatabaseIcons::applyBadge(const QPixmap& basePixmap, Badges badgeIndex)
 {
-    const auto cacheKey = QStringLiteral("badgedicon-%1-%2").arg(basePixmap.cacheKey()).arg(badgeIndex);
+    // Badged pixmaps are keyed by the base pixmap, with negative values keeping them apart from icon sizes
+    const qint64 baseKey = basePixmap.cacheKey();
+    const auto cacheKey = qMakePair(QByteArray(reinterpret_cast<const char*>(&baseKey), sizeof(baseKey)),
+                                    -1 - static_cast<int>(badgeIndex));
     QPixmap pixmap = basePixmap;
     if (badgeIndex < 0 || badgeIndex >= badgeList.size()) {
         qWarning("DatabaseIcons: Out-of-range badge index given to applyBadge: %d", badgeIndex);
-    } else if (!QPixmapCache::find(cacheKey, &pixmap)) {
+    } else if (auto cached = m_pixmapCache.object(cacheKey)) {
+        pixmap = *cached;
+    } else {
         int baseSize = basePixmap.width();
         int badgeSize =
             baseSize <= iconSize(IconSize::Default) * basePixmap.devicePixelRatio() ? baseSize * 0.6 : baseSize * 0.5;
@@ -94,7 +125,7 @@ QPixmap DatabaseIcons::applyBadge(const QPixmap& basePixmap, Badges badgeIndex)
         painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
         painter.drawPixmap(badgePos, badge);
 
-        QPixmapCache::insert(cacheKey, pixmap);
+        m_pixmapCache.insert(cacheKey, new QPixmap(pixmap), pixmapCost(pixmap));
     }
 
     return pixmap;
@@ -19,6 +19,7 @@
 #define KEEPASSX_DATABASEICONS_H
 
 #include "core/Global.h"
+#include <QCache>
 #include <QIcon>
 
 class DatabaseIcons
@@ -36,6 +37,7 @@ public:
     };
 
     QPixmap icon(int index, IconSize size = IconSize::Default);
+    QPixmap customIcon(const QByteArray& digest, const QByteArray& pngData, IconSize size = IconSize::Default);
     QPixmap applyBadge(const QPixmap& basePixmap, Badges badgeIndex);
     int count();
 
@@ -46,6 +48,8 @@ private:
 
     static DatabaseIcons* m_instance;
     QHash<QString, QIcon> m_iconCache;
+    // Decoded custom icons and badged pixmaps of all open databases, least recently used evicted first
+    QCache<QPair<QByteArray, int>, QPixmap> m_pixmapCache;
     bool m_compactMode;
 
     Q_DISABLE_COPY(DatabaseIcons)
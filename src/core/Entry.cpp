@@ -50,6 +50,11 @@ Entry::Entry()
     connect(m_attributes, &EntryAttributes::modified, this, &Entry::updateTotp);
     connect(m_attributes, &EntryAttributes::modified, this, &Entry::modified);
     connect(m_attributes, &EntryAttributes::defaultKeyModified, this, &Entry::emitDataChanged);
+    connect(m_attributes, &EntryAttributes::reset, this, &Entry::emitDataChanged);
+    connect(m_attributes, &EntryAttributes::customKeyModified, this, &Entry::emitDataChanged);
+    connect(m_attributes, &EntryAttributes::added, this, &Entry::emitDataChanged);
+    connect(m_attributes, &EntryAttributes::removed, this, &Entry::emitDataChanged);
+    connect(m_attributes, &EntryAttributes::renamed, this, &Entry::emitDataChanged);
     connect(m_attachments, &EntryAttachments::modified, this, &Entry::modified);
     connect(m_autoTypeAssociations, &AutoTypeAssociations::modified, this, &Entry::modified);
     connect(m_customData, &CustomData::modified, this, &Entry::modified);
@@ -1217,7 +1222,8 @@ void Entry::setGroup(Group* group)
             // copy custom icon to the new database
             if (!iconUuid().isNull() && group->database() && m_group->database()->metadata()->hasCustomIcon(iconUuid())
                 && !group->database()->metadata()->hasCustomIcon(iconUuid())) {
-                group->database()->metadata()->addCustomIcon(iconUuid(), icon());
+                group->database()->metadata()->addCustomIcon(
+                    iconUuid(), m_group->database()->metadata()->customIconData(iconUuid()));
             }
         }
     }
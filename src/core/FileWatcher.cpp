@@ -19,14 +19,144 @@
 
 #include "core/AsyncTask.h"
 
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QHash>
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
 #ifdef Q_OS_LINUX
 #include <sys/statfs.h>
 #endif
 
+namespace
+{
+    /**
+     * Shares one native file system watcher between all FileWatcher instances,
+     * instead of allocating an inotify instance or similar per watched file.
+     * Files are watched together with their directory: replacing a file by a
+     * rename, as atomic saves do, is only reported on the directory. Polled
+     * files are compared by their metadata which also covers replacing them.
+     */
+    class FileWatchService : public QObject
+    {
+    public:
+        static FileWatchService* instance()
+        {
+            static QPointer<FileWatchService> service;
+            if (!service) {
+                service = new FileWatchService(QCoreApplication::instance());
+            }
+            return service;
+        }
+
+        QFileSystemWatcher* watcher(bool polling)
+        {
+            return polling ? &m_polling.watcher : &m_native.watcher;
+        }
+
+        // Returns whether the file, and its directory, are watched now
+        bool watch(const QString& filePath, bool polling)
+        {
+            auto& watch = polling ? m_polling : m_native;
+            bool watched = addPath(watch, filePath);
+            if (!polling) {
+                watched = addPath(watch, QFileInfo(filePath).absolutePath()) && watched;
+            }
+            return watched;
+        }
+
+        void unwatch(const QString& filePath, bool polling)
+        {
+            auto& watch = polling ? m_polling : m_native;
+            removePath(watch, filePath);
+            if (!polling) {
+                removePath(watch, QFileInfo(filePath).absolutePath());
+            }
+        }
+
+        // Watch the file again after it was replaced or recreated
+        void rewatch(const QString& filePath, bool polling)
+        {
+            auto& watch = polling ? m_polling : m_native;
+            if (watch.paths.contains(filePath) && !watch.watcher.files().contains(filePath)
+                && QFileInfo::exists(filePath)) {
+                watch.watcher.addPath(filePath);
+            }
+        }
+
+    private:
+        struct Watch
+        {
+            QFileSystemWatcher watcher;
+            QHash<QString, int> paths;
+        };
+
+        explicit FileWatchService(QObject* parent)
+            : QObject(parent)
+        {
+            // Files on network file systems are watched by polling their metadata
+            m_polling.watcher.setObjectName(QLatin1String("_qt_autotest_force_engine_poller"));
+        }
+
+        static bool addPath(Watch& watch, const QString& path)
+        {
+            if (watch.paths[path]++ == 0 && QFileInfo::exists(path)) {
+                watch.watcher.addPath(path);
+            }
+            // Adding fails when the path can't be watched, e.g. once the inotify watches are used up
+            return watch.watcher.files().contains(path) || watch.watcher.directories().contains(path);
+        }
+
+        static void removePath(Watch& watch, const QString& path)
+        {
+            auto it = watch.paths.find(path);
+            if (it == watch.paths.end() || --it.value() > 0) {
+                return;
+            }
+            watch.paths.erase(it);
+            if (watch.watcher.files().contains(path) || watch.watcher.directories().contains(path)) {
+                watch.watcher.removePath(path);
+            }
+        }
+
+        Watch m_native;
+        Watch m_polling;
+    };
+
+#if defined(Q_OS_LINUX)
+    /**
+     * Whether the file is on a file system whose remote changes are not
+     * reported to the native watcher.
+     */
+    bool isRemoteFileSystem(const QString& filePath)
+    {
+        struct statfs statfsBuf;
+        if (statfs(QFileInfo(filePath).absolutePath().toLocal8Bit().constData(), &statfsBuf)) {
+            // if we can't get the fs type let's fall back to polling
+            return true;
+        }
+
+        switch (static_cast<quint32>(statfsBuf.f_type)) {
+        case 0x6969: // NFS
+        case 0x517B: // SMB
+        case 0xFE534D42: // SMB2
+        case 0xFF534D42: // CIFS
+        case 0x5346414F: // AFS
+        case 0x65735546: // FUSE, e.g. sshfs or cloud storage
+            return true;
+        default:
+            return false;
+        }
+    }
+#endif
+} // namespace
+
 FileWatcher::FileWatcher(QObject* parent)
     : QObject(parent)
 {
-    connect(&m_fileWatcher, SIGNAL(fileChanged(QString)), SLOT(checkFileChanged()));
     connect(&m_fileChecksumTimer, SIGNAL(timeout()), SLOT(checkFileChanged()));
     connect(&m_fileChangeDelayTimer, &QTimer::timeout, this, [this] { emit fileChanged(m_filePath); });
     m_fileChangeDelayTimer.setSingleShot(true);
@@ -42,28 +172,39 @@ void FileWatcher::start(const QString& filePath, int checksumIntervalSeconds, in
 {
     stop();
 
-#if defined(Q_OS_LINUX)
-    struct statfs statfsBuf;
-    bool forcePolling = false;
-    const auto NFS_SUPER_MAGIC = 0x6969;
-
-    if (!statfs(filePath.toLocal8Bit().constData(), &statfsBuf)) {
-        forcePolling = (statfsBuf.f_type == NFS_SUPER_MAGIC);
-    } else {
-        // if we can't get the fs type let's fall back to polling
-        forcePolling = true;
-    }
-    auto objectName = forcePolling ? QLatin1String("_qt_autotest_force_engine_poller") : QLatin1String("");
-    m_fileWatcher.setObjectName(objectName);
-#endif
-
-    m_fileWatcher.addPath(filePath);
     m_filePath = filePath;
 
     // Handle file checksum
     m_fileChecksumSizeBytes = checksumSizeKibibytes * 1024;
     m_fileChecksum = calculateChecksum();
-    if (checksumIntervalSeconds > 0) {
+    m_fileStat = fileStat();
+
+#if defined(Q_OS_LINUX)
+    // Native notifications are reliable on local file systems, only poll the others
+    m_polling = isRemoteFileSystem(filePath);
+    const bool pollChecksum = m_polling;
+#else
+    // The file system type is not known, keep polling the checksum as a fallback
+    m_polling = false;
+    const bool pollChecksum = true;
+#endif
+
+    const auto directory = QFileInfo(filePath).absolutePath();
+    const bool watched = FileWatchService::instance()->watch(m_filePath, m_polling);
+    m_fileWatcher = FileWatchService::instance()->watcher(m_polling);
+    connect(m_fileWatcher, &QFileSystemWatcher::fileChanged, this, [this](const QString& path) {
+        if (path == m_filePath) {
+            checkFileChanged();
+        }
+    });
+    connect(m_fileWatcher, &QFileSystemWatcher::directoryChanged, this, [this, directory](const QString& path) {
+        if (path == directory) {
+            checkFileChanged();
+        }
+    });
+
+    // Changes would go unnoticed without the watch, the stat check keeps polling cheap
+    if (checksumIntervalSeconds > 0 && (pollChecksum || !watched)) {
         m_fileChecksumTimer.start(checksumIntervalSeconds * 1000);
     }
 
@@ -72,10 +213,13 @@ void FileWatcher::start(const QString& filePath, int checksumIntervalSeconds, in
 
 void FileWatcher::stop()
 {
-    if (!m_filePath.isEmpty()) {
-        m_fileWatcher.removePath(m_filePath);
+    if (m_fileWatcher) {
+        m_fileWatcher->disconnect(this);
+        FileWatchService::instance()->unwatch(m_filePath, m_polling);
     }
+    m_fileWatcher.clear();
     m_filePath.clear();
+    m_fileStat = FileStat();
     m_fileChecksum.clear();
     m_fileChecksumTimer.stop();
     m_fileChangeDelayTimer.stop();
@@ -104,21 +248,36 @@ bool FileWatcher::shouldIgnoreChanges()
 
 bool FileWatcher::hasSameFileChecksum()
 {
+    // Unchanged metadata means unchanged contents, skip reading the file
+    if (fileStat() == m_fileStat) {
+        return true;
+    }
     return calculateChecksum() == m_fileChecksum;
 }
 
 void FileWatcher::checkFileChanged()
 {
+    if (m_fileWatcher) {
+        FileWatchService::instance()->rewatch(m_filePath, m_polling);
+    }
+
     if (shouldIgnoreChanges()) {
         return;
     }
 
+    // Directory notifications also cover unrelated files, only hash if this one changed
+    const auto currentStat = fileStat();
+    if (currentStat == m_fileStat) {
+        return;
+    }
+
     // Prevent reentrance
     m_ignoreFileChange = true;
 
     AsyncTask::runThenCallback([=] { return calculateChecksum(); },
                                this,
                                [=](QByteArray checksum) {
+                                   m_fileStat = currentStat;
                                    if (checksum != m_fileChecksum) {
                                        m_fileChecksum = checksum;
                                        m_fileChangeDelayTimer.start(0);
@@ -128,6 +287,33 @@ void FileWatcher::checkFileChanged()
                                });
 }
 
+FileWatcher::FileStat FileWatcher::fileStat() const
+{
+    FileStat result;
+    if (m_filePath.isEmpty()) {
+        return result;
+    }
+
+    const QFileInfo info(m_filePath);
+    if (info.exists()) {
+        result.lastModified = info.lastModified();
+        result.size = info.size();
+    }
+#ifdef Q_OS_UNIX
+    // A replaced file may keep size and modification time, but not its inode
+    struct stat statBuf;
+    if (!::stat(m_filePath.toLocal8Bit().constData(), &statBuf)) {
+        result.inode = statBuf.st_ino;
+    }
+#endif
+    return result;
+}
+
+bool FileWatcher::FileStat::operator==(const FileStat& other) const
+{
+    return lastModified == other.lastModified && size == other.size && inode == other.inode;
+}
+
 QByteArray FileWatcher::calculateChecksum()
 {
     QFile file(m_filePath);
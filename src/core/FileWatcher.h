@@ -18,9 +18,12 @@
 #ifndef KEEPASSXC_FILEWATCHER_H
 #define KEEPASSXC_FILEWATCHER_H
 
-#include <QFileSystemWatcher>
+#include <QDateTime>
+#include <QPointer>
 #include <QTimer>
 
+class QFileSystemWatcher;
+
 class FileWatcher : public QObject
 {
     Q_OBJECT
@@ -45,11 +48,24 @@ private slots:
     void checkFileChanged();
 
 private:
+    // Metadata that changes with the file contents, compared before hashing
+    struct FileStat
+    {
+        QDateTime lastModified;
+        qint64 size = -1;
+        quint64 inode = 0;
+
+        bool operator==(const FileStat& other) const;
+    };
+
+    FileStat fileStat() const;
     QByteArray calculateChecksum();
     bool shouldIgnoreChanges();
 
     QString m_filePath;
-    QFileSystemWatcher m_fileWatcher;
+    QPointer<QFileSystemWatcher> m_fileWatcher;
+    bool m_polling = false;
+    FileStat m_fileStat;
     QByteArray m_fileChecksum;
     QTimer m_fileChangeDelayTimer;
     QTimer m_fileIgnoreDelayTimer;
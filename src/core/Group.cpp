@@ -440,7 +440,7 @@ void Group::setParent(Group* parent, int index)
             // copy custom icon to the new database
             if (!iconUuid().isNull() && parent->m_db && m_db->metadata()->hasCustomIcon(iconUuid())
                 && !parent->m_db->metadata()->hasCustomIcon(iconUuid())) {
-                parent->m_db->metadata()->addCustomIcon(iconUuid(), icon());
+                parent->m_db->metadata()->addCustomIcon(iconUuid(), m_db->metadata()->customIconData(iconUuid()));
             }
         }
         if (m_db != parent->m_db) {
@@ -1001,6 +1001,9 @@ void Group::connectDatabaseSignalsRecursive(Database* db)
         connect(this, &Group::groupAdded, db, &Database::groupAdded);
         connect(this, &Group::aboutToMove, db, &Database::groupAboutToMove);
         connect(this, &Group::groupMoved, db, &Database::groupMoved);
+        connect(this, &Group::entryAdded, db, &Database::entryAdded);
+        connect(this, &Group::entryAboutToRemove, db, &Database::entryAboutToRemove);
+        connect(this, &Group::entryDataChanged, db, &Database::entryDataChanged);
         connect(this, &Group::groupNonDataChange, db, &Database::markNonDataChange);
         connect(this, &Group::modified, db, &Database::markAsModified);
         // clang-format on
@@ -21,11 +21,39 @@
 
 #include <QCryptographicHash>
 #include <QProcess>
+#include <QSaveFile>
+#include <QSet>
+#include <QTemporaryFile>
+#include <QtConcurrent>
+#include <QtEndian>
+
+#include <algorithm>
+#include <cstring>
 
 namespace HibpOffline
 {
     const std::size_t SHA1_BYTES = 20;
 
+    /*
+     * Layout of an index file, all integers big endian:
+     *
+     *   header   magic, version and number of records
+     *   buckets  BUCKET_COUNT + 1 record offsets, one per two byte hash prefix
+     *   records  SHA-1 followed by the leak count, sorted by hash
+     *
+     * A lookup only has to binary search the records sharing the prefix of the hash.
+     */
+    const char INDEX_MAGIC[8] = {'K', 'P', 'X', 'C', 'H', 'I', 'B', 'P'};
+    const quint32 INDEX_VERSION = 1;
+    const int HEADER_SIZE = 24;
+    const int BUCKET_COUNT = 65536;
+    const int BUCKETS_SIZE = (BUCKET_COUNT + 1) * 8;
+    const int RECORD_SIZE = SHA1_BYTES + 4;
+    // Input is read, and records written, in blocks of this size
+    const int BLOCK_SIZE = 1024 * 1024;
+    // Records are distributed to this many temporary files, each sorted in memory
+    const int PARTITION_COUNT = 256;
+
     enum class ParseResult
     {
         Ok,
@@ -33,47 +61,126 @@ namespace HibpOffline
         Error
     };
 
-    ParseResult parseHibpLine(QIODevice& input, QByteArray& sha1, int& count)
+    struct Record
     {
-        QByteArray hexSha1(SHA1_BYTES * 2, '\0');
-        const qint64 rc = input.read(hexSha1.data(), hexSha1.size());
-        if (rc == 0) {
-            return ParseResult::Eof;
-        } else if (rc != hexSha1.size()) {
-            return ParseResult::Error;
+        uchar data[RECORD_SIZE];
+
+        bool operator<(const Record& other) const
+        {
+            return std::memcmp(data, other.data, SHA1_BYTES) < 0;
         }
+    };
 
-        sha1 = QByteArray::fromHex(hexSha1);
+    int hexValue(char c)
+    {
+        if ('0' <= c && c <= '9') {
+            return c - '0';
+        } else if ('a' <= c && c <= 'f') {
+            return c - 'a' + 10;
+        } else if ('A' <= c && c <= 'F') {
+            return c - 'A' + 10;
+        }
+        return -1;
+    }
 
-        char c;
-        if (!input.getChar(&c) || c != ':') {
-            return ParseResult::Error;
+    /*
+     * Reads "SHA1:count" lines from the HIBP text file in large blocks.
+     */
+    class HibpReader
+    {
+    public:
+        explicit HibpReader(QIODevice& input)
+            : m_input(input)
+        {
         }
 
-        count = 0;
-        while (true) {
-            if (!input.getChar(&c)) {
+        ParseResult next(uchar* sha1, int& count)
+        {
+            const char* line;
+            int length;
+            do {
+                if (!readLine(line, length)) {
+                    return m_error ? ParseResult::Error : ParseResult::Eof;
+                }
+                ++m_lineNum;
+                if (length > 0 && line[length - 1] == '\r') {
+                    --length;
+                }
+            } while (length == 0);
+
+            if (length < static_cast<int>(SHA1_BYTES * 2) + 2 || line[SHA1_BYTES * 2] != ':') {
                 return ParseResult::Error;
             }
-
-            if (c == '\n' || c == '\r') {
-                break;
+            for (std::size_t i = 0; i < SHA1_BYTES; ++i) {
+                const int high = hexValue(line[i * 2]);
+                const int low = hexValue(line[i * 2 + 1]);
+                if (high < 0 || low < 0) {
+                    return ParseResult::Error;
+                }
+                sha1[i] = static_cast<uchar>(high << 4 | low);
             }
 
-            if (!('0' <= c && c <= '9')) {
-                return ParseResult::Error;
+            count = 0;
+            for (int i = SHA1_BYTES * 2 + 1; i < length; ++i) {
+                const char c = line[i];
+                if (!('0' <= c && c <= '9')) {
+                    return ParseResult::Error;
+                }
+                count *= 10;
+                count += (c - '0');
             }
+            return ParseResult::Ok;
+        }
 
-            count *= 10;
-            count += (c - '0');
+        quint64 lineNum() const
+        {
+            return m_lineNum;
         }
 
-        while (1 == input.peek(&c, 1) && (c == '\n' || c == '\r')) {
-            input.getChar(&c);
+    private:
+        bool readLine(const char*& line, int& length)
+        {
+            while (true) {
+                const char* start = m_buffer.constData() + m_pos;
+                const int available = m_buffer.size() - m_pos;
+                const auto end = static_cast<const char*>(std::memchr(start, '\n', available));
+                if (end) {
+                    line = start;
+                    length = static_cast<int>(end - start);
+                    m_pos += length + 1;
+                    return true;
+                }
+                if (m_eof) {
+                    // last line without line break
+                    line = start;
+                    length = available;
+                    m_pos = m_buffer.size();
+                    return length > 0;
+                }
+
+                m_buffer.remove(0, m_pos);
+                m_pos = 0;
+                const int size = m_buffer.size();
+                m_buffer.resize(size + BLOCK_SIZE);
+                const qint64 rc = m_input.read(m_buffer.data() + size, BLOCK_SIZE);
+                if (rc < 0) {
+                    m_buffer.resize(size);
+                    m_error = true;
+                    m_eof = true;
+                    return false;
+                }
+                m_buffer.resize(size + static_cast<int>(rc));
+                m_eof = rc == 0;
+            }
         }
 
-        return ParseResult::Ok;
-    }
+        QIODevice& m_input;
+        QByteArray m_buffer;
+        int m_pos = 0;
+        bool m_eof = false;
+        bool m_error = false;
+        quint64 m_lineNum = 0;
+    };
 
     bool
     report(QSharedPointer<Database> db, QIODevice& hibpInput, QList<QPair<const Entry*, int>>& findings, QString* error)
@@ -86,15 +193,16 @@ namespace HibpOffline
             }
         }
 
-        QByteArray sha1;
-        for (quint64 lineNum = 1;; ++lineNum) {
+        HibpReader reader(hibpInput);
+        QByteArray sha1(SHA1_BYTES, '\0');
+        while (true) {
             int count = 0;
 
-            switch (parseHibpLine(hibpInput, sha1, count)) {
+            switch (reader.next(reinterpret_cast<uchar*>(sha1.data()), count)) {
             case ParseResult::Eof:
                 return true;
             case ParseResult::Error:
-                *error = QObject::tr("HIBP file, line %1: parse error").arg(lineNum);
+                *error = QObject::tr("HIBP file, line %1: parse error").arg(reader.lineNum());
                 return false;
             default:
                 break;
@@ -106,6 +214,233 @@ namespace HibpOffline
         }
     }
 
+    bool isIndex(const QString& path)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly)) {
+            return false;
+        }
+        return file.read(sizeof(INDEX_MAGIC)) == QByteArray::fromRawData(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    }
+
+    /*
+     * Convert the HIBP text file into a sorted index. The records are first
+     * distributed by their leading byte to temporary files next to the index,
+     * which are then sorted one at a time, so the memory use stays at a small
+     * fraction of the input size. The temporary files are only opened while
+     * they are written or read, which keeps within low open file limits.
+     */
+    bool createIndex(QIODevice& hibpInput, const QString& indexPath, QString* error)
+    {
+        QList<QSharedPointer<QTemporaryFile>> partitions;
+        QVector<QByteArray> pending(PARTITION_COUNT);
+        for (int i = 0; i < PARTITION_COUNT; ++i) {
+            auto partition = QSharedPointer<QTemporaryFile>::create(indexPath + ".XXXXXX");
+            if (!partition->open()) {
+                *error = QObject::tr("Failed to create temporary file: %1").arg(partition->errorString());
+                return false;
+            }
+            // the file is kept until the partition is destroyed
+            partition->close();
+            partitions.append(partition);
+        }
+
+        auto flush = [&](int i) {
+            if (pending[i].isEmpty()) {
+                return true;
+            }
+            QFile file(partitions[i]->fileName());
+            if (!file.open(QIODevice::WriteOnly | QIODevice::Append) || file.write(pending[i]) != pending[i].size()) {
+                *error = QObject::tr("Failed to write temporary file: %1").arg(file.errorString());
+                return false;
+            }
+            pending[i].resize(0);
+            return true;
+        };
+
+        HibpReader reader(hibpInput);
+        QVector<quint64> bucketSizes(BUCKET_COUNT, 0);
+        quint64 recordCount = 0;
+        Record record;
+        while (true) {
+            int count = 0;
+            const auto result = reader.next(record.data, count);
+            if (result == ParseResult::Eof) {
+                break;
+            } else if (result == ParseResult::Error) {
+                *error = QObject::tr("HIBP file, line %1: parse error").arg(reader.lineNum());
+                return false;
+            }
+
+            qToBigEndian<quint32>(static_cast<quint32>(count), record.data + SHA1_BYTES);
+            const int partition = record.data[0];
+            pending[partition].append(reinterpret_cast<const char*>(record.data), RECORD_SIZE);
+            if (pending[partition].size() >= BLOCK_SIZE / 16 && !flush(partition)) {
+                return false;
+            }
+            ++bucketSizes[record.data[0] << 8 | record.data[1]];
+            ++recordCount;
+        }
+
+        QSaveFile output(indexPath);
+        if (!output.open(QIODevice::WriteOnly)) {
+            *error = QObject::tr("Failed to create index file %1: %2").arg(indexPath, output.errorString());
+            return false;
+        }
+
+        QByteArray header(HEADER_SIZE + BUCKETS_SIZE, '\0');
+        auto data = reinterpret_cast<uchar*>(header.data());
+        std::memcpy(data, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+        qToBigEndian<quint32>(INDEX_VERSION, data + 8);
+        qToBigEndian<quint64>(recordCount, data + 16);
+        quint64 offset = 0;
+        for (int i = 0; i <= BUCKET_COUNT; ++i) {
+            qToBigEndian<quint64>(offset, data + HEADER_SIZE + i * 8);
+            if (i < BUCKET_COUNT) {
+                offset += bucketSizes[i];
+            }
+        }
+        if (output.write(header) != header.size()) {
+            *error = QObject::tr("Failed to write index file %1: %2").arg(indexPath, output.errorString());
+            return false;
+        }
+
+        for (int i = 0; i < PARTITION_COUNT; ++i) {
+            if (!flush(i)) {
+                return false;
+            }
+            auto& partition = partitions[i];
+            QFile file(partition->fileName());
+            if (!file.open(QIODevice::ReadOnly)) {
+                *error = QObject::tr("Failed to read temporary file: %1").arg(file.errorString());
+                return false;
+            }
+            QByteArray records = file.readAll();
+            file.close();
+            partition->remove();
+
+            auto begin = reinterpret_cast<Record*>(records.data());
+            std::sort(begin, begin + records.size() / RECORD_SIZE);
+            if (output.write(records) != records.size()) {
+                break;
+            }
+        }
+
+        if (!output.commit()) {
+            *error = QObject::tr("Failed to write index file %1: %2").arg(indexPath, output.errorString());
+            return false;
+        }
+        return true;
+    }
+
+    /*
+     * Check that the bucket offsets of a mapped index stay within its records,
+     * so that lookups never read past the end of the file.
+     */
+    bool validBuckets(const uchar* buckets, quint64 recordCount)
+    {
+        quint64 previous = 0;
+        for (int i = 0; i <= BUCKET_COUNT; ++i) {
+            const quint64 offset = qFromBigEndian<quint64>(buckets + i * 8);
+            if (offset < previous) {
+                return false;
+            }
+            previous = offset;
+        }
+        return previous == recordCount;
+    }
+
+    /*
+     * Look up the leak count of each of the given SHA-1 hashes in a memory-mapped index.
+     * Hashes that are not listed are left out of the results.
+     */
+    bool lookup(QFile& index, const QList<QByteArray>& sha1s, QHash<QByteArray, int>& counts, QString* error)
+    {
+        if (!index.isOpen() && !index.open(QIODevice::ReadOnly)) {
+            *error = QObject::tr("Failed to open HIBP file %1: %2").arg(index.fileName(), index.errorString());
+            return false;
+        }
+
+        const qint64 size = index.size();
+        uchar* data = size >= HEADER_SIZE + BUCKETS_SIZE ? index.map(0, size) : nullptr;
+        if (data
+            && (std::memcmp(data, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0
+                || qFromBigEndian<quint32>(data + 8) != INDEX_VERSION
+                || size != HEADER_SIZE + BUCKETS_SIZE + qint64(qFromBigEndian<quint64>(data + 16)) * RECORD_SIZE
+                || !validBuckets(data + HEADER_SIZE, qFromBigEndian<quint64>(data + 16)))) {
+            index.unmap(data);
+            data = nullptr;
+        }
+        if (!data) {
+            *error = QObject::tr("HIBP file %1 is not a valid index").arg(index.fileName());
+            return false;
+        }
+
+        // binary search within the records sharing the two byte prefix of the hash
+        const uchar* buckets = data + HEADER_SIZE;
+        const uchar* records = buckets + BUCKETS_SIZE;
+        auto search = [buckets, records](const QByteArray& sha1) {
+            if (sha1.size() != static_cast<int>(SHA1_BYTES)) {
+                return -1;
+            }
+            const auto hash = reinterpret_cast<const uchar*>(sha1.constData());
+            const int bucket = hash[0] << 8 | hash[1];
+            quint64 low = qFromBigEndian<quint64>(buckets + bucket * 8);
+            quint64 high = qFromBigEndian<quint64>(buckets + (bucket + 1) * 8);
+            while (low < high) {
+                const quint64 middle = low + (high - low) / 2;
+                const uchar* record = records + middle * RECORD_SIZE;
+                const int cmp = std::memcmp(record, hash, SHA1_BYTES);
+                if (cmp == 0) {
+                    return static_cast<int>(qFromBigEndian<quint32>(record + SHA1_BYTES));
+                } else if (cmp < 0) {
+                    low = middle + 1;
+                } else {
+                    high = middle;
+                }
+            }
+            return -1;
+        };
+        const auto results = QtConcurrent::blockingMapped<QList<int>>(sha1s, search);
+        index.unmap(data);
+
+        for (int i = 0; i < sha1s.size(); ++i) {
+            if (results[i] >= 0) {
+                counts.insert(sha1s[i], results[i]);
+            }
+        }
+        return true;
+    }
+
+    bool indexReport(QSharedPointer<Database> db,
+                     QFile& index,
+                     QList<QPair<const Entry*, int>>& findings,
+                     QString* error)
+    {
+        QList<QPair<const Entry*, QByteArray>> entries;
+        QSet<QByteArray> sha1s;
+        for (const auto* entry : db->rootGroup()->entriesRecursive()) {
+            if (!entry->isRecycled()) {
+                const auto sha1 = QCryptographicHash::hash(entry->password().toUtf8(), QCryptographicHash::Sha1);
+                entries.append({entry, sha1});
+                sha1s.insert(sha1);
+            }
+        }
+
+        QHash<QByteArray, int> counts;
+        if (!lookup(index, sha1s.values(), counts, error)) {
+            return false;
+        }
+
+        for (const auto& entry : entries) {
+            const auto found = counts.constFind(entry.second);
+            if (found != counts.constEnd()) {
+                findings.append({entry.first, found.value()});
+            }
+        }
+        return true;
+    }
+
     bool okonReport(QSharedPointer<Database> db,
                     const QString& okon,
                     const QString& okonDatabase,
@@ -18,8 +18,10 @@
 #ifndef KEEPASSXC_HIBPOFFLINE_H
 #define KEEPASSXC_HIBPOFFLINE_H
 
+#include <QHash>
 #include <QSharedPointer>
 
+class QFile;
 class QIODevice;
 
 class Database;
@@ -37,6 +39,14 @@ namespace HibpOffline
                     const QString& okonDatabase,
                     QList<QPair<const Entry*, int>>& findings,
                     QString* error);
+
+    bool isIndex(const QString& path);
+    bool createIndex(QIODevice& hibpInput, const QString& indexPath, QString* error);
+    bool lookup(QFile& index, const QList<QByteArray>& sha1s, QHash<QByteArray, int>& counts, QString* error);
+    bool indexReport(QSharedPointer<Database> db,
+                     QFile& index,
+                     QList<QPair<const Entry*, int>>& findings,
+                     QString* error);
 } // namespace HibpOffline
 
 #endif // KEEPASSXC_HIBPOFFLINE_H
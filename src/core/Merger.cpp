@@ -59,6 +59,12 @@ void Merger::resetForcedMergeMode()
 
 QStringList Merger::merge()
 {
+    // Report the merge as one batch instead of one change per item
+    Database* targetDb = m_context.m_targetDb;
+    if (targetDb) {
+        targetDb->beginBatchUpdate();
+    }
+
     // Order of merge steps is important - it is possible that we
     // create some items before deleting them afterwards
     ChangeList changes;
@@ -72,6 +78,9 @@ QStringList Merger::merge()
     if (!changes.isEmpty()) {
         m_context.m_targetDb->markAsModified();
     }
+    if (targetDb) {
+        targetDb->endBatchUpdate();
+    }
     return changes;
 }
 
@@ -611,8 +620,7 @@ Merger::ChangeList Merger::mergeMetadata(const MergeContext& context)
 
     for (const auto& iconUuid : sourceMetadata->customIconsOrder()) {
         if (!targetMetadata->hasCustomIcon(iconUuid)) {
-            QImage customIcon = sourceMetadata->customIcon(iconUuid);
-            targetMetadata->addCustomIcon(iconUuid, customIcon);
+            targetMetadata->addCustomIcon(iconUuid, sourceMetadata->customIconData(iconUuid));
             changes << tr("Adding missing icon %1").arg(QString::fromLatin1(iconUuid.toRfc4122().toHex()));
         }
     }
@@ -18,14 +18,29 @@
 #include "Metadata.h"
 
 #include "core/DatabaseIcons.h"
+#include "core/Global.h"
 #include "core/Group.h"
 
 #include <QApplication>
+#include <QBuffer>
 #include <QCryptographicHash>
 
 const int Metadata::DefaultHistoryMaxItems = 10;
 const int Metadata::DefaultHistoryMaxSize = 6 * 1024 * 1024;
 
+namespace
+{
+    QByteArray encodeIcon(const QImage& image)
+    {
+        QByteArray pngData;
+        QBuffer buffer(&pngData);
+        buffer.open(QIODevice::WriteOnly);
+        image.save(&buffer, "PNG");
+        buffer.close();
+        return pngData;
+    }
+} // namespace
+
 Metadata::Metadata(QObject* parent)
     : ModifiableObject(parent)
     , m_customData(new CustomData(this))
@@ -64,9 +79,10 @@ void Metadata::clear()
 {
     init();
     m_customIcons.clear();
-    m_customIconsRaw.clear();
     m_customIconsOrder.clear();
     m_customIconsHashes.clear();
+    m_customIconsImageHashes.clear();
+    m_customIconsImageHashesBuilt = false;
     m_customData->clear();
 }
 
@@ -177,7 +193,12 @@ bool Metadata::protectNotes() const
 
 QImage Metadata::customIcon(const QUuid& uuid) const
 {
-    return m_customIconsRaw.value(uuid);
+    return QImage::fromData(customIconData(uuid));
+}
+
+QByteArray Metadata::customIconData(const QUuid& uuid) const
+{
+    return m_customIcons.value(uuid).data;
 }
 
 QPixmap Metadata::customIconPixmap(const QUuid& uuid, IconSize size) const
@@ -185,7 +206,17 @@ QPixmap Metadata::customIconPixmap(const QUuid& uuid, IconSize size) const
     if (!hasCustomIcon(uuid)) {
         return {};
     }
-    return m_customIcons.value(uuid).pixmap(databaseIcons()->iconSize(size));
+
+    // TODO: This check can go away when we move all QIcon handling outside of core
+    // On older versions of Qt, loading a QPixmap from QImage outside of a GUI
+    // environment causes ASAN to fail and crash on nullptr violation
+    static bool isGui = qApp->inherits("QGuiApplication");
+    if (!isGui) {
+        return {};
+    }
+
+    const auto& icon = m_customIcons[uuid];
+    return databaseIcons()->customIcon(icon.digest, icon.data, size);
 }
 
 QHash<QUuid, QPixmap> Metadata::customIconsPixmaps(IconSize size) const
@@ -201,7 +232,7 @@ QHash<QUuid, QPixmap> Metadata::customIconsPixmaps(IconSize size) const
 
 bool Metadata::hasCustomIcon(const QUuid& uuid) const
 {
-    return m_customIconsRaw.contains(uuid);
+    return m_customIcons.contains(uuid);
 }
 
 QList<QUuid> Metadata::customIconsOrder() const
@@ -358,31 +389,31 @@ void Metadata::setProtectNotes(bool value)
 }
 
 void Metadata::addCustomIcon(const QUuid& uuid, const QImage& image)
+{
+    addCustomIcon(uuid, encodeIcon(image));
+}
+
+void Metadata::addCustomIcon(const QUuid& uuid, const QByteArray& pngData)
 {
     Q_ASSERT(!uuid.isNull());
-    Q_ASSERT(!m_customIconsRaw.contains(uuid));
+    Q_ASSERT(!m_customIcons.contains(uuid));
+
+    CustomIcon icon;
+    icon.digest = hashIconData(pngData);
+    // Share the bytes of an identical icon that is already stored
+    auto duplicate = m_customIconsHashes.value(icon.digest);
+    icon.data = duplicate.isNull() ? pngData : m_customIcons.value(duplicate).data;
 
-    m_customIconsRaw[uuid] = image;
+    m_customIcons.insert(uuid, icon);
     // remove all uuids to prevent duplicates in release mode
     m_customIconsOrder.removeAll(uuid);
     m_customIconsOrder.append(uuid);
-    // Associate image hash to uuid
-    QByteArray hash = hashImage(image);
-    m_customIconsHashes[hash] = uuid;
-    Q_ASSERT(m_customIconsRaw.count() == m_customIconsOrder.count());
-
-    // TODO: This check can go away when we move all QIcon handling outside of core
-    // On older versions of Qt, loading a QPixmap from QImage outside of a GUI
-    // environment causes ASAN to fail and crash on nullptr violation
-    static bool isGui = qApp->inherits("QGuiApplication");
-    if (isGui) {
-        // Generate QIcon with pre-baked resolutions
-        auto basePixmap = QPixmap::fromImage(image.scaled(64, 64, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
-        QIcon icon(basePixmap);
-        m_customIcons.insert(uuid, icon);
-    } else {
-        m_customIcons.insert(uuid, QIcon());
+    // Associate data digest to uuid
+    m_customIconsHashes[icon.digest] = uuid;
+    if (m_customIconsImageHashesBuilt) {
+        m_customIconsImageHashes[hashImage(QImage::fromData(icon.data))] = uuid;
     }
+    Q_ASSERT(m_customIcons.count() == m_customIconsOrder.count());
 
     emitModified();
 }
@@ -390,25 +421,39 @@ void Metadata::addCustomIcon(const QUuid& uuid, const QImage& image)
 void Metadata::removeCustomIcon(const QUuid& uuid)
 {
     Q_ASSERT(!uuid.isNull());
-    Q_ASSERT(m_customIconsRaw.contains(uuid));
+    Q_ASSERT(m_customIcons.contains(uuid));
 
     // Remove hash record only if this is the same uuid
-    QByteArray hash = hashImage(m_customIconsRaw[uuid]);
-    if (m_customIconsHashes.contains(hash) && m_customIconsHashes[hash] == uuid) {
-        m_customIconsHashes.remove(hash);
+    const QByteArray digest = m_customIcons.value(uuid).digest;
+    if (m_customIconsHashes.value(digest) == uuid) {
+        m_customIconsHashes.remove(digest);
+    }
+    if (m_customIconsImageHashesBuilt) {
+        const QByteArray imageHash = m_customIconsImageHashes.key(uuid);
+        if (!imageHash.isNull()) {
+            m_customIconsImageHashes.remove(imageHash);
+        }
     }
 
     m_customIcons.remove(uuid);
-    m_customIconsRaw.remove(uuid);
     m_customIconsOrder.removeAll(uuid);
-    Q_ASSERT(m_customIconsRaw.count() == m_customIconsOrder.count());
+    Q_ASSERT(m_customIcons.count() == m_customIconsOrder.count());
     emitModified();
 }
 
+/**
+ * Find a custom icon with the same pixels as `candidate`. The stored PNG
+ * bytes may come from any encoder, so icons are compared decoded.
+ */
 QUuid Metadata::findCustomIcon(const QImage& candidate)
 {
-    QByteArray hash = hashImage(candidate);
-    return m_customIconsHashes.value(hash, QUuid());
+    if (!m_customIconsImageHashesBuilt) {
+        for (const QUuid& uuid : asConst(m_customIconsOrder)) {
+            m_customIconsImageHashes[hashImage(customIcon(uuid))] = uuid;
+        }
+        m_customIconsImageHashesBuilt = true;
+    }
+    return m_customIconsImageHashes.value(hashImage(candidate), QUuid());
 }
 
 void Metadata::copyCustomIcons(const QSet<QUuid>& iconList, const Metadata* otherMetadata)
@@ -417,11 +462,16 @@ void Metadata::copyCustomIcons(const QSet<QUuid>& iconList, const Metadata* othe
         Q_ASSERT(otherMetadata->hasCustomIcon(uuid));
 
         if (!hasCustomIcon(uuid) && otherMetadata->hasCustomIcon(uuid)) {
-            addCustomIcon(uuid, otherMetadata->customIcon(uuid));
+            addCustomIcon(uuid, otherMetadata->customIconData(uuid));
         }
     }
 }
 
+QByteArray Metadata::hashIconData(const QByteArray& pngData)
+{
+    return QCryptographicHash::hash(pngData, QCryptographicHash::Md5);
+}
+
 QByteArray Metadata::hashImage(const QImage& image)
 {
 #if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
@@ -79,6 +79,7 @@ public:
     bool protectUrl() const;
     bool protectNotes() const;
     QImage customIcon(const QUuid& uuid) const;
+    QByteArray customIconData(const QUuid& uuid) const;
     bool hasCustomIcon(const QUuid& uuid) const;
     QPixmap customIconPixmap(const QUuid& uuid, IconSize size = IconSize::Default) const;
     QHash<QUuid, QPixmap> customIconsPixmaps(IconSize size = IconSize::Default) const;
@@ -118,6 +119,7 @@ public:
     void setProtectUrl(bool value);
     void setProtectNotes(bool value);
     void addCustomIcon(const QUuid& uuid, const QImage& image);
+    void addCustomIcon(const QUuid& uuid, const QByteArray& pngData);
     void removeCustomIcon(const QUuid& uuid);
     void copyCustomIcons(const QSet<QUuid>& iconList, const Metadata* otherMetadata);
     QUuid findCustomIcon(const QImage& candidate);
@@ -148,14 +150,24 @@ private:
     template <class P, class V> bool set(P& property, const V& value);
     template <class P, class V> bool set(P& property, const V& value, QDateTime& dateTime);
 
-    QByteArray hashImage(const QImage& image);
+    static QByteArray hashIconData(const QByteArray& pngData);
+    static QByteArray hashImage(const QImage& image);
 
     MetadataData m_data;
 
-    QHash<QUuid, QIcon> m_customIcons;
-    QHash<QUuid, QImage> m_customIconsRaw;
+    // Custom icons are kept as their encoded PNG bytes and decoded on first display
+    struct CustomIcon
+    {
+        QByteArray data;
+        QByteArray digest;
+    };
+
+    QHash<QUuid, CustomIcon> m_customIcons;
     QList<QUuid> m_customIconsOrder;
     QHash<QByteArray, QUuid> m_customIconsHashes;
+    // Decoded pixel hashes for findCustomIcon(), built on its first call
+    QHash<QByteArray, QUuid> m_customIconsImageHashes;
+    bool m_customIconsImageHashesBuilt = false;
 
     QPointer<Group> m_recycleBin;
     QDateTime m_recycleBinChanged;
@@ -91,36 +91,64 @@ void PassphraseGenerator::setWordSeparator(const QString& separator)
 
 QString PassphraseGenerator::generatePassphrase() const
 {
-    QString tmpWord;
     Q_ASSERT(isValid());
+    return generatePassphrases(1).value(0);
+}
+
+/**
+ * Generate several passphrases at once, drawing the word indices from a
+ * shared random buffer.
+ */
+QStringList PassphraseGenerator::generatePassphrases(int count) const
+{
+    Q_ASSERT(isValid());
+
+    QStringList passphrases;
 
     // In case there was an error loading the wordlist
     if (m_wordlist.length() == 0) {
-        return QString();
+        return passphrases;
     }
 
-    QStringList words;
-    for (int i = 0; i < m_wordCount; ++i) {
-        int wordIndex = randomGen()->randomUInt(static_cast<quint32>(m_wordlist.length()));
-        tmpWord = m_wordlist.at(wordIndex);
-
-        // convert case
-        switch (m_wordCase) {
-        case UPPERCASE:
-            tmpWord = tmpWord.toUpper();
-            break;
-        case TITLECASE:
-            tmpWord = tmpWord.replace(0, 1, tmpWord.left(1).toUpper());
-            break;
-        case LOWERCASE:
-        default:
-            tmpWord = tmpWord.toLower();
-            break;
+    // Convert the case of the whole word list up front when more words are
+    // needed than it contains, otherwise convert only the chosen words
+    QVector<QString> convertedWords;
+    if (static_cast<qint64>(count) * m_wordCount > m_wordlist.size()) {
+        convertedWords.reserve(m_wordlist.size());
+        for (const auto& word : m_wordlist) {
+            convertedWords.append(convertCase(word));
         }
-        words.append(tmpWord);
     }
 
-    return words.join(m_separator);
+    const auto numWords = static_cast<quint32>(m_wordlist.size());
+    RandomBuffer random(qBound(64, count * m_wordCount * 4, 1024 * 1024));
+
+    passphrases.reserve(count);
+    for (int n = 0; n < count; ++n) {
+        QStringList words;
+        words.reserve(m_wordCount);
+        for (int i = 0; i < m_wordCount; ++i) {
+            const int wordIndex = random.randomUInt(numWords);
+            words.append(convertedWords.isEmpty() ? convertCase(m_wordlist.at(wordIndex))
+                                                  : convertedWords.at(wordIndex));
+        }
+        passphrases.append(words.join(m_separator));
+    }
+
+    return passphrases;
+}
+
+QString PassphraseGenerator::convertCase(QString word) const
+{
+    switch (m_wordCase) {
+    case UPPERCASE:
+        return word.toUpper();
+    case TITLECASE:
+        return word.replace(0, 1, word.left(1).toUpper());
+    case LOWERCASE:
+    default:
+        return word.toLower();
+    }
 }
 
 bool PassphraseGenerator::isValid() const
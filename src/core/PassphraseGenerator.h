@@ -18,6 +18,7 @@
 #ifndef KEEPASSX_PASSPHRASEGENERATOR_H
 #define KEEPASSX_PASSPHRASEGENERATOR_H
 
+#include <QStringList>
 #include <QVector>
 
 class PassphraseGenerator
@@ -42,12 +43,15 @@ public:
     bool isValid() const;
 
     QString generatePassphrase() const;
+    QStringList generatePassphrases(int count) const;
 
     static constexpr int DefaultWordCount = 7;
     static const char* DefaultSeparator;
     static const char* DefaultWordList;
 
 private:
+    QString convertCase(QString word) const;
+
     int m_wordCount;
     PassphraseWordCase m_wordCase;
     QString m_separator;
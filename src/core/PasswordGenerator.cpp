@@ -66,50 +66,63 @@ void PasswordGenerator::setExcludedChars(const QString& chars)
 }
 
 QString PasswordGenerator::generatePassword() const
+{
+    return generatePasswords(1).first();
+}
+
+/**
+ * Generate several passwords at once. The character groups are only
+ * computed once and the random numbers are drawn from a shared buffer,
+ * which makes this much faster than repeated generatePassword() calls.
+ */
+QStringList PasswordGenerator::generatePasswords(int count) const
 {
     Q_ASSERT(isValid());
 
     const QVector<PasswordGroup> groups = passwordGroups();
 
-    QVector<QChar> passwordChars;
+    QString passwordChars;
     for (const PasswordGroup& group : groups) {
         for (QChar ch : group) {
             passwordChars.append(ch);
         }
     }
+    const auto numChars = static_cast<quint32>(passwordChars.size());
 
-    QString password;
+    // Roughly two bytes per character leave enough room for rejected draws and the shuffle
+    RandomBuffer random(qBound(64, count * m_length * 2, 1024 * 1024));
 
-    if (m_flags & CharFromEveryGroup) {
-        for (const auto& group : groups) {
-            int pos = randomGen()->randomUInt(static_cast<quint32>(group.size()));
+    QStringList passwords;
+    passwords.reserve(count);
+    for (int n = 0; n < count; ++n) {
+        QString password;
+        password.reserve(m_length);
 
-            password.append(group[pos]);
+        if (m_flags & CharFromEveryGroup) {
+            for (const auto& group : groups) {
+                password.append(group[random.randomUInt(static_cast<quint32>(group.size()))]);
+            }
         }
 
-        for (int i = groups.size(); i < m_length; i++) {
-            int pos = randomGen()->randomUInt(static_cast<quint32>(passwordChars.size()));
-
-            password.append(passwordChars[pos]);
+        while (password.size() < m_length) {
+            password.append(passwordChars[random.randomUInt(numChars)]);
         }
 
-        // shuffle chars
-        for (int i = (password.size() - 1); i >= 1; i--) {
-            int j = randomGen()->randomUInt(static_cast<quint32>(i + 1));
+        if (m_flags & CharFromEveryGroup) {
+            // shuffle chars
+            for (int i = (password.size() - 1); i >= 1; i--) {
+                int j = random.randomUInt(static_cast<quint32>(i + 1));
 
-            QChar tmp = password[i];
-            password[i] = password[j];
-            password[j] = tmp;
+                QChar tmp = password[i];
+                password[i] = password[j];
+                password[j] = tmp;
+            }
         }
-    } else {
-        for (int i = 0; i < m_length; i++) {
-            int pos = randomGen()->randomUInt(static_cast<quint32>(passwordChars.size()));
 
-            password.append(passwordChars[pos]);
-        }
+        passwords.append(password);
     }
 
-    return password;
+    return passwords;
 }
 
 bool PasswordGenerator::isValid() const
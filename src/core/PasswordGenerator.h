@@ -19,6 +19,7 @@
 #ifndef KEEPASSX_PASSWORDGENERATOR_H
 #define KEEPASSX_PASSWORDGENERATOR_H
 
+#include <QStringList>
 #include <QVector>
 
 typedef QVector<QChar> PasswordGroup;
@@ -64,6 +65,7 @@ public:
     bool isValid() const;
 
     QString generatePassword() const;
+    QStringList generatePasswords(int count) const;
 
     static const int DefaultLength = 32;
     static const char* DefaultAdditionalChars;
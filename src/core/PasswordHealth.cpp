@@ -15,12 +15,117 @@
  *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <QCache>
+#include <QMessageAuthenticationCode>
+#include <QMutex>
 #include <QString>
+#include <QThreadStorage>
+#include <QtConcurrent>
 
 #include "Group.h"
 #include "PasswordHealth.h"
+#include "crypto/Random.h"
 #include "zxcvbn.h"
 
+namespace
+{
+#ifdef ZXCVBN_HAVE_ARENA
+    struct MatchArena
+    {
+        MatchArena()
+            : arena(ZxcvbnNewArena())
+        {
+        }
+        ~MatchArena()
+        {
+            ZxcvbnFreeArena(arena);
+        }
+        ZxcArena_t* const arena;
+    };
+#endif
+
+    /*
+     * Run zxcvbn on a password. Every thread scores with its own match
+     * arena that is reused from one password to the next, so scoring in
+     * parallel needs neither locking nor an allocation per match.
+     */
+    double zxcvbnEntropy(const QString& password)
+    {
+#ifdef ZXCVBN_HAVE_ARENA
+        static QThreadStorage<MatchArena*> arenas;
+        if (!arenas.hasLocalData()) {
+            arenas.setLocalData(new MatchArena());
+        }
+        return ZxcvbnMatchArena(arenas.localData()->arena, password.toUtf8(), nullptr, nullptr);
+#else
+        return ZxcvbnMatch(password.toUtf8(), nullptr, nullptr);
+#endif
+    }
+
+    /*
+     * Identify a password by a digest keyed with a random per-process
+     * secret, so caches and indexes never need to hold the passwords.
+     */
+    QByteArray passwordDigest(const QString& password)
+    {
+        static const QByteArray key = randomGen()->randomArray(32);
+        return QMessageAuthenticationCode::hash(password.toUtf8(), key, QCryptographicHash::Sha256);
+    }
+
+    /*
+     * zxcvbn results shared by the health checks of entries, so a password
+     * is only scored again once it has changed. Passwords scored on their
+     * own, such as the ones typed into the generator, are not kept.
+     */
+    class EntropyCache
+    {
+    public:
+        static EntropyCache& instance()
+        {
+            static EntropyCache cache;
+            return cache;
+        }
+
+        bool find(const QByteArray& digest, double& entropy)
+        {
+            QMutexLocker locker(&m_mutex);
+            const auto cached = m_entropy.object(digest);
+            if (cached) {
+                entropy = *cached;
+            }
+            return cached != nullptr;
+        }
+
+        void insert(const QByteArray& digest, double entropy)
+        {
+            QMutexLocker locker(&m_mutex);
+            m_entropy.insert(digest, new double(entropy));
+        }
+
+        double entropy(const QString& password)
+        {
+            const auto key = passwordDigest(password);
+            double entropy;
+            if (!find(key, entropy)) {
+                entropy = zxcvbnEntropy(password);
+                insert(key, entropy);
+            }
+            return entropy;
+        }
+
+    private:
+        EntropyCache()
+            : m_entropy(MaxEntries)
+        {
+        }
+
+        static constexpr int MaxEntries = 200000;
+
+        QMutex m_mutex;
+        QCache<QByteArray, double> m_entropy;
+    };
+} // namespace
+
 PasswordHealth::PasswordHealth(double entropy)
     : m_score(entropy)
     , m_entropy(entropy)
@@ -44,7 +149,7 @@ PasswordHealth::PasswordHealth(double entropy)
 }
 
 PasswordHealth::PasswordHealth(const QString& pwd)
-    : PasswordHealth(ZxcvbnMatch(pwd.toUtf8(), nullptr, nullptr))
+    : PasswordHealth(zxcvbnEntropy(pwd))
 {
 }
 
@@ -92,19 +197,167 @@ PasswordHealth::Quality PasswordHealth::quality() const
     return Quality::Excellent;
 }
 
+/**
+ * The index is built on first use and then updated entry by entry.
+ * Changes to the group structure (moving a group to the recycle bin,
+ * merging, ...) invalidate it so it is rebuilt on the next lookup.
+ */
+PasswordReuseIndex::PasswordReuseIndex(Database* db)
+    : QObject(db)
+    , m_db(db)
+{
+    connect(db, &Database::entryAdded, this, &PasswordReuseIndex::addEntry);
+    connect(db, &Database::entryAboutToRemove, this, &PasswordReuseIndex::removeEntry);
+    connect(db, &Database::entryDataChanged, this, &PasswordReuseIndex::updateEntry);
+    connect(db, &Database::groupAdded, this, &PasswordReuseIndex::invalidate);
+    connect(db, &Database::groupRemoved, this, &PasswordReuseIndex::invalidate);
+    connect(db, &Database::groupMoved, this, &PasswordReuseIndex::invalidate);
+}
+
+int PasswordReuseIndex::count(const Entry* entry) const
+{
+    QMutexLocker locker(&m_mutex);
+    build();
+    const auto digest = m_digests.value(entry);
+    return digest.isEmpty() ? 0 : m_entries.value(digest).size();
+}
+
+QList<const Entry*> PasswordReuseIndex::entries(const QString& password) const
+{
+    const auto digest = passwordDigest(password);
+    QMutexLocker locker(&m_mutex);
+    build();
+    return m_entries.value(digest);
+}
+
+void PasswordReuseIndex::invalidate()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_valid = false;
+        m_entries.clear();
+        m_digests.clear();
+    }
+    emit reuseChanged();
+}
+
+void PasswordReuseIndex::addEntry(Entry* entry)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_valid || !isIndexed(entry)) {
+        return;
+    }
+    const bool reused = insert(entry) > 1;
+    locker.unlock();
+
+    if (reused) {
+        emit reuseChanged();
+    }
+}
+
+void PasswordReuseIndex::removeEntry(Entry* entry)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_valid) {
+        return;
+    }
+    const bool reused = remove(entry) > 0;
+    locker.unlock();
+
+    if (reused) {
+        emit reuseChanged();
+    }
+}
+
+void PasswordReuseIndex::updateEntry(Entry* entry)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_valid) {
+        return;
+    }
+
+    const auto digest = isIndexed(entry) ? passwordDigest(entry->password()) : QByteArray();
+    if (digest == m_digests.value(entry)) {
+        return;
+    }
+
+    bool reused = remove(entry) > 0;
+    if (!digest.isEmpty()) {
+        reused = insert(entry) > 1 || reused;
+    }
+    locker.unlock();
+
+    if (reused) {
+        emit reuseChanged();
+    }
+}
+
+bool PasswordReuseIndex::isIndexed(const Entry* entry)
+{
+    return !entry->password().isEmpty() && !entry->isRecycled() && !entry->isAttributeReference("Password");
+}
+
+/**
+ * Index all entries of the database unless the index is up to date.
+ * Must be called with the mutex held.
+ */
+void PasswordReuseIndex::build() const
+{
+    if (m_valid) {
+        return;
+    }
+
+    for (const auto* entry : m_db->rootGroup()->entriesRecursive()) {
+        if (isIndexed(entry)) {
+            const auto digest = passwordDigest(entry->password());
+            m_entries[digest].append(entry);
+            m_digests.insert(entry, digest);
+        }
+    }
+    m_valid = true;
+}
+
+/**
+ * Add an entry to the index, returns the number of entries
+ * now using its password.
+ */
+int PasswordReuseIndex::insert(const Entry* entry)
+{
+    const auto digest = passwordDigest(entry->password());
+    auto& entries = m_entries[digest];
+    entries.append(entry);
+    m_digests.insert(entry, digest);
+    return entries.size();
+}
+
+/**
+ * Remove an entry from the index, returns the number of entries
+ * still using its password or -1 if the entry was not indexed.
+ * The entry is not dereferenced, it may be partially destroyed.
+ */
+int PasswordReuseIndex::remove(const Entry* entry)
+{
+    const auto digest = m_digests.take(entry);
+    if (digest.isEmpty()) {
+        return -1;
+    }
+
+    auto it = m_entries.find(digest);
+    it->removeOne(entry);
+    const int remaining = it->size();
+    if (remaining == 0) {
+        m_entries.erase(it);
+    }
+    return remaining;
+}
+
 /**
  * This class provides additional information about password health
  * than can be derived from the password itself (re-use, expiry).
  */
 HealthChecker::HealthChecker(QSharedPointer<Database> db)
+    : m_db(std::move(db))
 {
-    // Build the cache of re-used passwords
-    for (const auto* entry : db->rootGroup()->entriesRecursive()) {
-        if (!entry->isRecycled() && !entry->isAttributeReference("Password")) {
-            m_reuse[entry->password()]
-                << QObject::tr("Used in %1/%2").arg(entry->group()->hierarchy().join('/'), entry->title());
-        }
-    }
 }
 
 /**
@@ -122,11 +375,11 @@ QSharedPointer<PasswordHealth> HealthChecker::evaluate(const Entry* entry) const
 
     // First analyse the password itself
     const auto pwd = entry->password();
-    auto health = QSharedPointer<PasswordHealth>(new PasswordHealth(pwd));
+    auto health = QSharedPointer<PasswordHealth>(new PasswordHealth(EntropyCache::instance().entropy(pwd)));
 
     // Second, if the password is in the database more than once,
     // reduce the score accordingly
-    const auto& used = m_reuse[pwd];
+    const auto used = m_db->reuseIndex()->entries(pwd);
     const auto count = used.size();
     if (count > 1) {
         constexpr auto penalty = 15;
@@ -134,7 +387,8 @@ QSharedPointer<PasswordHealth> HealthChecker::evaluate(const Entry* entry) const
         health->addScoreReason(QObject::tr("Password is used %1 time(s)", "", count).arg(QString::number(count)));
         // Add the first 20 uses of the password to prevent the details display from growing too large
         for (int i = 0; i < used.size(); ++i) {
-            health->addScoreDetails(used[i]);
+            health->addScoreDetails(
+                QObject::tr("Used in %1/%2").arg(used[i]->group()->hierarchy().join('/'), used[i]->title()));
             if (i == 19) {
                 health->addScoreDetails("…");
                 break;
@@ -184,3 +438,39 @@ QSharedPointer<PasswordHealth> HealthChecker::evaluate(const Entry* entry) const
     // Return the result
     return health;
 }
+
+/**
+ * Evaluate several entries at once.
+ *
+ * The passwords that have not been scored before are run through
+ * zxcvbn in parallel, the results are in the order of `entries`.
+ */
+QList<QSharedPointer<PasswordHealth>> HealthChecker::evaluate(const QList<const Entry*>& entries) const
+{
+    auto& cache = EntropyCache::instance();
+
+    QHash<QByteArray, QString> missing;
+    for (const auto* entry : entries) {
+        const auto pwd = entry->password();
+        const auto digest = passwordDigest(pwd);
+        double entropy;
+        if (!missing.contains(digest) && !cache.find(digest, entropy)) {
+            missing.insert(digest, pwd);
+        }
+    }
+
+    const auto digests = missing.keys();
+    const auto entropies = QtConcurrent::blockingMapped<QList<double>>(digests, [&missing](const QByteArray& digest) {
+        return zxcvbnEntropy(missing.value(digest));
+    });
+    for (int i = 0; i < digests.size(); ++i) {
+        cache.insert(digests[i], entropies[i]);
+    }
+
+    QList<QSharedPointer<PasswordHealth>> results;
+    results.reserve(entries.size());
+    for (const auto* entry : entries) {
+        results.append(evaluate(entry));
+    }
+    return results;
+}
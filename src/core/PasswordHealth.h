@@ -19,6 +19,8 @@
 #define KEEPASSX_PASSWORDHEALTH_H
 
 #include <QHash>
+#include <QMutex>
+#include <QObject>
 #include <QSharedPointer>
 
 class Database;
@@ -89,6 +91,49 @@ private:
     QStringList m_scoreDetails;
 };
 
+/**
+ * Index of the entries of a database that share a password, kept up
+ * to date from the entry signals of the database. Passwords are only
+ * known by a keyed digest, the index does not hold the passwords.
+ * Entries in the recycle bin and password references are not indexed.
+ */
+class PasswordReuseIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PasswordReuseIndex(Database* db);
+
+    // Number of indexed entries with the same password as `entry`, including itself
+    int count(const Entry* entry) const;
+    // The indexed entries with the given password
+    QList<const Entry*> entries(const QString& password) const;
+
+public slots:
+    void invalidate();
+
+signals:
+    // Emitted when the number of uses of some password may have changed
+    void reuseChanged();
+
+private slots:
+    void addEntry(Entry* entry);
+    void removeEntry(Entry* entry);
+    void updateEntry(Entry* entry);
+
+private:
+    static bool isIndexed(const Entry* entry);
+    void build() const;
+    int insert(const Entry* entry);
+    int remove(const Entry* entry);
+
+    Database* const m_db;
+    mutable QMutex m_mutex;
+    mutable bool m_valid = false;
+    mutable QHash<QByteArray, QList<const Entry*>> m_entries;
+    mutable QHash<const Entry*, QByteArray> m_digests;
+};
+
 /**
  * Password health check for all entries of a database.
  *
@@ -101,10 +146,11 @@ public:
 
     // Get the health status of an entry in the database
     QSharedPointer<PasswordHealth> evaluate(const Entry* entry) const;
+    // Get the health status of many entries, scoring passwords in parallel
+    QList<QSharedPointer<PasswordHealth>> evaluate(const QList<const Entry*>& entries) const;
 
 private:
-    // To determine password re-use: first = password, second = entries that use it
-    QHash<QString, QStringList> m_reuse;
+    QSharedPointer<Database> m_db;
 };
 
 #endif // KEEPASSX_PASSWORDHEALTH_H
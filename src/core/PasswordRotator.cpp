@@ -0,0 +1,82 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PasswordRotator.h"
+
+#include "core/Entry.h"
+#include "core/PasswordGenerator.h"
+
+#include <QSet>
+
+PasswordRotator::PasswordRotator(const PasswordGenerator& generator)
+    : m_generator(generator)
+{
+}
+
+/**
+ * Recycled entries are left alone, and so are entries whose password
+ * references another entry, since rotating them would break the reference.
+ */
+bool PasswordRotator::canRotate(const Entry* entry)
+{
+    return entry && !entry->isRecycled() && !entry->attributes()->isReference(EntryAttributes::PasswordKey);
+}
+
+/**
+ * Returns the entries of `entries` that rotate() would change, in order and
+ * without duplicates.
+ */
+QList<Entry*> PasswordRotator::rotatable(const QList<Entry*>& entries) const
+{
+    QList<Entry*> result;
+    QSet<const Entry*> seen;
+    result.reserve(entries.size());
+    for (auto entry : entries) {
+        if (canRotate(entry) && !seen.contains(entry)) {
+            seen.insert(entry);
+            result << entry;
+        }
+    }
+    return result;
+}
+
+/**
+ * Sets a freshly generated password on every rotatable entry and returns
+ * the entries that were changed. Nothing is changed if the generator is not
+ * valid.
+ */
+QList<Entry*> PasswordRotator::rotate(const QList<Entry*>& entries) const
+{
+    if (!m_generator.isValid()) {
+        return {};
+    }
+
+    const auto targets = rotatable(entries);
+    if (targets.isEmpty()) {
+        return {};
+    }
+
+    const auto passwords = m_generator.generatePasswords(targets.size());
+    for (int i = 0; i < targets.size(); ++i) {
+        Entry* entry = targets.at(i);
+        entry->beginUpdate();
+        entry->setPassword(passwords.at(i));
+        entry->endUpdate();
+    }
+
+    return targets;
+}
@@ -0,0 +1,46 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSX_PASSWORDROTATOR_H
+#define KEEPASSX_PASSWORDROTATOR_H
+
+#include <QList>
+
+class Entry;
+class PasswordGenerator;
+
+/**
+ * Replaces the passwords of many entries at once.
+ *
+ * All new passwords are drawn from the generator in a single batch, and every
+ * entry gets exactly one history item for the change. The database is not
+ * saved; callers save once after rotate() returns.
+ */
+class PasswordRotator
+{
+public:
+    explicit PasswordRotator(const PasswordGenerator& generator);
+
+    static bool canRotate(const Entry* entry);
+    QList<Entry*> rotatable(const QList<Entry*>& entries) const;
+    QList<Entry*> rotate(const QList<Entry*>& entries) const;
+
+private:
+    const PasswordGenerator& m_generator;
+};
+
+#endif // KEEPASSX_PASSWORDROTATOR_H
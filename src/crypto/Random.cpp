@@ -81,3 +81,43 @@ quint32 Random::randomUIntRange(quint32 min, quint32 max)
 {
     return min + randomUInt(max - min);
 }
+
+RandomBuffer::RandomBuffer(int size)
+    : m_buffer(qMax(size, 4))
+    , m_pos(static_cast<int>(m_buffer.size()))
+{
+}
+
+quint32 RandomBuffer::randomUInt(quint32 limit)
+{
+    if (limit <= 1) {
+        return 0;
+    }
+
+    // Draw as many bytes as needed to cover the limit, and reject values at
+    // or above the largest multiple of the limit to avoid modulo bias
+    const int bytes = limit <= 0x100U ? 1 : (limit <= 0x10000U ? 2 : 4);
+    const quint64 range = Q_UINT64_C(1) << (bytes * 8);
+    const quint64 ceil = range - (range % limit);
+
+    quint32 rand;
+    do {
+        rand = take(bytes);
+    } while (rand >= ceil);
+
+    return rand % limit;
+}
+
+quint32 RandomBuffer::take(int bytes)
+{
+    if (m_pos + bytes > static_cast<int>(m_buffer.size())) {
+        randomGen()->getRng()->randomize(m_buffer.data(), m_buffer.size());
+        m_pos = 0;
+    }
+
+    quint32 value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value = (value << 8) | m_buffer[m_pos++];
+    }
+    return value;
+}
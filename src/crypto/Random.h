@@ -55,4 +55,31 @@ static inline QSharedPointer<Random> randomGen()
     return Random::instance();
 }
 
+/**
+ * Draws random numbers from a block of random bytes that is refilled from
+ * the system RNG as needed, instead of querying the RNG for every number.
+ * Meant for generating many values at once, e.g. bulk password generation.
+ */
+class RandomBuffer
+{
+public:
+    explicit RandomBuffer(int size = DefaultSize);
+
+    /**
+     * Generate a random quint32 in the range [0, @p limit) without modulo bias,
+     * using as few random bytes as @p limit permits.
+     */
+    quint32 randomUInt(quint32 limit);
+
+    static const int DefaultSize = 4096;
+
+private:
+    quint32 take(int bytes);
+
+    Botan::secure_vector<uint8_t> m_buffer;
+    int m_pos;
+
+    Q_DISABLE_COPY(RandomBuffer);
+};
+
 #endif // KEEPASSX_RANDOM_H
@@ -58,6 +58,33 @@ bool SymmetricCipher::init(Mode mode, Direction direction, const QByteArray& key
     return true;
 }
 
+/**
+ * Start a new message with another IV, keeping the mode,
+ * direction and key set up by init().
+ */
+bool SymmetricCipher::restart(const QByteArray& iv)
+{
+    Q_ASSERT(isInitalized());
+    if (!isInitalized()) {
+        m_error = QObject::tr("Cipher not initialized prior to use.");
+        return false;
+    }
+    if (!m_cipher->valid_nonce_length(iv.size())) {
+        m_error = QObject::tr("SymmetricCipher::init: Invalid IV size of %1 for %2.")
+                      .arg(iv.size())
+                      .arg(modeToString(m_mode));
+        return false;
+    }
+
+    try {
+        m_cipher->start(reinterpret_cast<const uint8_t*>(iv.data()), iv.size());
+        return true;
+    } catch (std::exception& e) {
+        m_error = e.what();
+        return false;
+    }
+}
+
 bool SymmetricCipher::isInitalized() const
 {
     return m_cipher;
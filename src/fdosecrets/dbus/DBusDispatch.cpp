@@ -101,11 +101,10 @@ namespace FdoSecrets
             if (member == "Remove") {
                 member = QStringLiteral("Delete");
             }
-            auto cacheKey = QStringLiteral("%1.%2").arg(iface, member);
+            auto& methods = m_cachedMethods[iface];
 
             // skip if we already have it
-            auto it = m_cachedMethods.find(cacheKey);
-            if (it != m_cachedMethods.end()) {
+            if (methods.contains(member)) {
                 continue;
             }
 
@@ -157,11 +156,20 @@ namespace FdoSecrets
                 md.signature += sig;
             }
             if (valid) {
-                m_cachedMethods.insert(cacheKey, md);
+                methods.insert(member, md);
             }
         }
     }
 
+    QString DBusMgr::objectInterface(const QMetaObject* mo)
+    {
+        auto it = m_cachedInterfaces.constFind(mo);
+        if (it == m_cachedInterfaces.constEnd()) {
+            it = m_cachedInterfaces.insert(mo, mo->classInfo(mo->indexOfClassInfo("D-Bus Interface")).value());
+        }
+        return it.value();
+    }
+
     bool DBusMgr::handleMessage(const QDBusMessage& message, const QDBusConnection&)
     {
         // save a mutable copy of the message, as we may modify it to unify property access
@@ -248,9 +256,8 @@ namespace FdoSecrets
                    "QDBusConnection: internal threading error",
                    "function called for an object that is in another thread!!");
 
-        auto mo = obj->metaObject();
         // either interface matches, or interface is empty if req is property get all
-        QString interface = mo->classInfo(mo->indexOfClassInfo("D-Bus Interface")).value();
+        const auto interface = objectInterface(obj->metaObject());
         if (req.interface != interface && !(req.type == RequestType::PropertyGetAll && req.interface.isEmpty())) {
             qDebug() << "DBusMgr::handleMessage with mismatch interface" << msg;
             return false;
@@ -262,10 +269,10 @@ namespace FdoSecrets
         }
 
         // find the slot to call
-        auto cacheKey = QStringLiteral("%1.%2").arg(req.interface, req.member);
-        auto it = m_cachedMethods.find(cacheKey);
-        if (it == m_cachedMethods.end()) {
-            qDebug() << "DBusMgr::handleMessage with nonexisting method" << cacheKey;
+        const auto methods = m_cachedMethods.value(interface);
+        auto it = methods.constFind(req.member);
+        if (it == methods.constEnd()) {
+            qDebug() << "DBusMgr::handleMessage with nonexisting method" << req.interface << req.member;
             return false;
         }
 
@@ -301,16 +308,12 @@ namespace FdoSecrets
     {
         QVariantMap result;
 
-        // prefix match the cacheKey
-        auto prefix = interface + ".";
-        for (auto it = m_cachedMethods.constBegin(); it != m_cachedMethods.constEnd(); ++it) {
-            if (!it.key().startsWith(prefix)) {
-                continue;
-            }
+        const auto methods = m_cachedMethods.value(interface);
+        for (auto it = methods.constBegin(); it != methods.constEnd(); ++it) {
             if (!it.value().isProperty) {
                 continue;
             }
-            auto name = it.key().mid(prefix.size());
+            const auto& name = it.key();
 
             DBusResult ret;
             QVariantList outputArgs;
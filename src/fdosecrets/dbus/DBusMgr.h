@@ -271,8 +271,12 @@ namespace FdoSecrets
             bool isProperty{false};
             bool needsCallingClient{false};
         };
-        QHash<QString, MethodData> m_cachedMethods{};
+        // interface name -> member name -> method
+        QHash<QString, QHash<QString, MethodData>> m_cachedMethods{};
         void populateMethodCache(const QMetaObject& mo);
+        // D-Bus interface of each object class, looked up once per class
+        QHash<const QMetaObject*, QString> m_cachedInterfaces{};
+        QString objectInterface(const QMetaObject* mo);
 
         enum class RequestType
         {
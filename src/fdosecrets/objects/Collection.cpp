@@ -27,6 +27,29 @@
 
 #include <QFileInfo>
 
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    /*
+     * Position of an entry in the order of Group::entriesRecursive() on `root`:
+     * the indexes of its groups below `root`, then its index within its group.
+     * Only the ancestors of the entry are visited, not the whole tree.
+     */
+    std::pair<std::vector<int>, int> treePosition(const Entry* entry, const Group* root)
+    {
+        std::vector<int> groupPath;
+        for (auto group = entry->group(); group && group != root && group->parentGroup();
+             group = group->parentGroup()) {
+            groupPath.push_back(group->parentGroup()->children().indexOf(const_cast<Group*>(group)));
+        }
+        std::reverse(groupPath.begin(), groupPath.end());
+        // an ancestor's path is a prefix of its descendants' and sorts first, as its entries do
+        return {groupPath, entry->group()->entries().indexOf(const_cast<Entry*>(entry))};
+    }
+} // namespace
+
 namespace FdoSecrets
 {
     Collection* Collection::Create(Service* parent, DatabaseWidget* backend)
@@ -253,12 +276,39 @@ namespace FdoSecrets
             return {};
         }
 
+        if (attributes.isEmpty()) {
+            // searching using empty terms returns nothing
+            return {};
+        }
+
+        // the index narrows down the items, the search terms still decide which ones match
+        QList<Entry*> candidates;
+        for (const auto& item : searchCandidates(attributes)) {
+            auto entry = item->backend();
+            if (entry && entry->group() && entry->group()->resolveSearchingEnabled()) {
+                candidates << entry;
+            }
+        }
+        if (candidates.isEmpty()) {
+            return {};
+        }
+
         QList<EntrySearcher::SearchTerm> terms;
         for (auto it = attributes.constBegin(); it != attributes.constEnd(); ++it) {
             terms << attributeToTerm(it.key(), it.value());
         }
 
-        const auto foundEntries = EntrySearcher(false, true).search(terms, m_exposedGroup);
+        auto foundEntries = EntrySearcher(false, true).searchEntries(terms, candidates);
+        if (foundEntries.size() > 1) {
+            // the index keeps items in the order they were (re)indexed, report them in tree order
+            QHash<const Entry*, std::pair<std::vector<int>, int>> positions;
+            for (const auto* entry : asConst(foundEntries)) {
+                positions.insert(entry, treePosition(entry, m_exposedGroup));
+            }
+            std::sort(foundEntries.begin(), foundEntries.end(), [&positions](const Entry* a, const Entry* b) {
+                return positions.value(a) < positions.value(b);
+            });
+        }
         items.reserve(foundEntries.size());
         for (const auto& entry : foundEntries) {
             items << m_entryToItem.value(entry);
@@ -266,6 +316,78 @@ namespace FdoSecrets
         return {};
     }
 
+    /**
+     * Items that may have all the given attributes. Uses the attribute
+     * that narrows down the items the most.
+     */
+    QList<Item*> Collection::searchCandidates(const StringStringMap& attributes) const
+    {
+        QList<Item*> candidates;
+        bool first = true;
+        for (auto it = attributes.constBegin(); it != attributes.constEnd(); ++it) {
+            const auto indexed = m_attributeIndex.value(it.key()).value(it.value());
+            const auto unindexed = m_unindexedItems.value(it.key());
+            if (first || indexed.size() + unindexed.size() < candidates.size()) {
+                // an item is either indexed or unindexed for a given attribute
+                candidates = indexed + unindexed;
+                first = false;
+            }
+            if (candidates.isEmpty()) {
+                break;
+            }
+        }
+        return candidates;
+    }
+
+    void Collection::indexItem(Item* item)
+    {
+        auto entry = item->backend();
+        if (!entry || m_indexedAttributes.contains(item)) {
+            return;
+        }
+
+        // keep in sync with EntrySearcher, which resolves placeholders in these and skips protected values
+        static const QStringList resolvedKeys{
+            EntryAttributes::TitleKey, EntryAttributes::UserNameKey, EntryAttributes::URLKey};
+
+        IndexedAttributes indexed;
+        const auto attributes = entry->attributes();
+        for (const auto& key : attributes->keys()) {
+            const auto value = attributes->value(key);
+            if (attributes->isProtected(key) || (resolvedKeys.contains(key) && value.contains('{'))) {
+                indexed.unindexedKeys << key;
+                m_unindexedItems[key] << item;
+            } else {
+                indexed.values.insert(key, value);
+                m_attributeIndex[key][value] << item;
+            }
+        }
+        m_indexedAttributes.insert(item, indexed);
+    }
+
+    void Collection::unindexItem(Item* item)
+    {
+        const auto indexed = m_indexedAttributes.take(item);
+        for (auto it = indexed.values.constBegin(); it != indexed.values.constEnd(); ++it) {
+            auto& values = m_attributeIndex[it.key()];
+            auto& items = values[it.value()];
+            items.removeOne(item);
+            if (items.isEmpty()) {
+                values.remove(it.value());
+            }
+            if (values.isEmpty()) {
+                m_attributeIndex.remove(it.key());
+            }
+        }
+        for (const auto& key : indexed.unindexedKeys) {
+            auto& items = m_unindexedItems[key];
+            items.removeOne(item);
+            if (items.isEmpty()) {
+                m_unindexedItems.remove(key);
+            }
+        }
+    }
+
     EntrySearcher::SearchTerm Collection::attributeToTerm(const QString& key, const QString& value)
     {
         static QMap<QString, EntrySearcher::Field> attrKeyToField{
@@ -523,6 +645,7 @@ namespace FdoSecrets
         auto item = Item::Create(this, entry);
         m_items << item;
         m_entryToItem[entry] = item;
+        indexItem(item);
 
         // forward delete signals
         connect(entry->group(), &Group::entryAboutToRemove, item, [item](Entry* toBeRemoved) {
@@ -532,10 +655,15 @@ namespace FdoSecrets
         });
 
         // relay signals
-        connect(item, &Item::itemChanged, this, [this, item]() { emit itemChanged(item); });
+        connect(item, &Item::itemChanged, this, [this, item]() {
+            unindexItem(item);
+            indexItem(item);
+            emit itemChanged(item);
+        });
         connect(item, &Item::itemAboutToDelete, this, [this, item]() {
             m_items.removeAll(item);
             m_entryToItem.remove(item->backend());
+            unindexItem(item);
             emit itemDeleted(item);
         });
 
@@ -620,6 +748,9 @@ namespace FdoSecrets
         }
 
         m_items.clear();
+        m_attributeIndex.clear();
+        m_unindexedItems.clear();
+        m_indexedAttributes.clear();
     }
 
     QString Collection::backendFilePath() const
@@ -136,6 +136,9 @@ namespace FdoSecrets
         friend class CreateCollectionPrompt;
 
         void onEntryAdded(Entry* entry, bool emitSignal);
+        void indexItem(Item* item);
+        void unindexItem(Item* item);
+        QList<Item*> searchCandidates(const StringStringMap& attributes) const;
         void populateContents();
         void connectGroupSignalRecursive(Group* group);
         void cleanupConnections();
@@ -169,6 +172,21 @@ namespace FdoSecrets
         QSet<QString> m_aliases;
         QList<Item*> m_items;
         QMap<const Entry*, Item*> m_entryToItem;
+
+        /**
+         * Items by the exact value of their attributes, for searchItems.
+         * Values that don't match literally, e.g. protected ones or ones
+         * containing placeholders, are not indexed. Their items are listed
+         * in m_unindexedItems instead and are always searched.
+         */
+        struct IndexedAttributes
+        {
+            StringStringMap values;
+            QStringList unindexedKeys;
+        };
+        QHash<QString, QHash<QString, QList<Item*>>> m_attributeIndex;
+        QHash<QString, QList<Item*>> m_unindexedItems;
+        QHash<const Item*, IndexedAttributes> m_indexedAttributes;
     };
 
 } // namespace FdoSecrets
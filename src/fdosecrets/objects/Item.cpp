@@ -58,6 +58,10 @@ namespace FdoSecrets
         : DBusObject(parent)
         , m_backend(backend)
     {
+        connect(m_backend, &Entry::modified, this, [this]() {
+            m_attributesCached = false;
+            m_cachedAttributes.clear();
+        });
         connect(m_backend, &Entry::modified, this, &Item::itemChanged);
     }
 
@@ -86,7 +90,13 @@ namespace FdoSecrets
             return ret;
         }
 
+        if (m_attributesCached) {
+            attrs = m_cachedAttributes;
+            return {};
+        }
+
         // add default attributes except password
+        bool hasReferences = false;
         auto entryAttrs = m_backend->attributes();
         for (const auto& attr : EntryAttributes::DefaultAttributes) {
             if (entryAttrs->isProtected(attr) || attr == EntryAttributes::PasswordKey) {
@@ -97,6 +107,7 @@ namespace FdoSecrets
             if (entryAttrs->isReference(attr)) {
                 value = m_backend->maskPasswordPlaceholders(value);
                 value = m_backend->resolveMultiplePlaceholders(value);
+                hasReferences = true;
             }
             attrs[attr] = value;
         }
@@ -110,6 +121,12 @@ namespace FdoSecrets
         // add some informative and readonly attributes
         attrs[ItemAttributes::UuidKey] = m_backend->uuidToHex();
         attrs[ItemAttributes::PathKey] = path();
+
+        // referenced entries may change without this entry being modified
+        if (!hasReferences) {
+            m_cachedAttributes = attrs;
+            m_attributesCached = true;
+        }
         return {};
     }
 
@@ -232,6 +249,24 @@ namespace FdoSecrets
     }
 
     DBusResult Item::getSecretNoNotification(const DBusClientPtr& client, Session* session, Secret& secret) const
+    {
+        Secret plain;
+        auto ret = getPlainSecret(client, plain);
+        if (ret.err()) {
+            return ret;
+        }
+
+        if (!session) {
+            return DBusResult(DBUS_ERROR_SECRET_NO_SESSION);
+        }
+
+        // encode using session
+        secret = session->encode(plain);
+
+        return {};
+    }
+
+    DBusResult Item::getPlainSecret(const DBusClientPtr& client, Secret& secret) const
     {
         auto ret = ensureBackend();
         if (ret.err()) {
@@ -245,15 +280,7 @@ namespace FdoSecrets
             return DBusResult(DBUS_ERROR_SECRET_IS_LOCKED);
         }
 
-        if (!session) {
-            return DBusResult(DBUS_ERROR_SECRET_NO_SESSION);
-        }
-
         secret = getEntrySecret(m_backend);
-
-        // encode using session
-        secret = session->encode(secret);
-
         return {};
     }
 
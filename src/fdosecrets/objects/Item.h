@@ -78,6 +78,10 @@ namespace FdoSecrets
         static const QSet<QString> ReadOnlyAttributes;
 
         DBusResult getSecretNoNotification(const DBusClientPtr& client, Session* session, Secret& secret) const;
+        /**
+         * Like getSecretNoNotification, but leaves encoding the secret to the caller
+         */
+        DBusResult getPlainSecret(const DBusClientPtr& client, Secret& secret) const;
         DBusResult setProperties(const QVariantMap& properties);
 
         Entry* backend() const;
@@ -107,6 +111,10 @@ namespace FdoSecrets
 
     private:
         QPointer<Entry> m_backend;
+
+        // attributes() of entries without references, cleared when the entry changes
+        mutable StringStringMap m_cachedAttributes;
+        mutable bool m_attributesCached = false;
     };
 
 } // namespace FdoSecrets
@@ -376,11 +376,22 @@ namespace FdoSecrets
             return DBusResult(DBUS_ERROR_SECRET_NO_SESSION);
         }
 
+        // collect the secrets first so they are encoded in one pass
+        QList<Item*> found;
+        QList<Secret> plain;
         for (const auto& item : asConst(items)) {
-            auto ret = item->getSecretNoNotification(client, session, secrets[item]);
+            Secret secret;
+            auto ret = item->getPlainSecret(client, secret);
             if (ret.err()) {
                 return ret;
             }
+            found << item;
+            plain << secret;
+        }
+
+        const auto encoded = session->encode(plain);
+        for (int i = 0; i != found.size(); ++i) {
+            secrets[found.at(i)] = encoded.at(i);
         }
         plugin()->emitRequestShowNotification(
             tr(R"(%n Entry(s) was used by %1)", "%1 is the name of an application", secrets.size())
@@ -51,6 +51,13 @@ namespace FdoSecrets
          */
         Secret encode(const Secret& input) const;
 
+        /**
+         * Encode several secret structs in one pass.
+         * @param inputs
+         * @return the encoded secrets, in the same order
+         */
+        QList<Secret> encode(const QList<Secret>& inputs) const;
+
         /**
          * Decode the secret struct.
          * @param input
@@ -87,6 +87,44 @@ namespace FdoSecrets
         return output;
     }
 
+    QList<Secret> DhIetf1024Sha256Aes128CbcPkcs7::encryptAll(const QList<Secret>& inputs)
+    {
+        // set up the cipher and key schedule once, only the IV changes between secrets
+        SymmetricCipher encrypter;
+        const auto ivSize = SymmetricCipher::defaultIvSize(SymmetricCipher::Aes128_CBC);
+
+        QList<Secret> outputs;
+        outputs.reserve(inputs.size());
+        for (const auto& input : inputs) {
+            Secret output = input;
+            output.parameters.clear();
+            output.value.clear();
+
+            auto IV = randomGen()->randomArray(ivSize);
+            bool ok = encrypter.isInitalized() ? encrypter.restart(IV)
+                                               : encrypter.init(SymmetricCipher::Aes128_CBC,
+                                                                SymmetricCipher::Encrypt,
+                                                                m_aesKey,
+                                                                IV);
+            if (!ok) {
+                qWarning() << "Error encrypt: " << encrypter.errorString();
+                encrypter.reset();
+                outputs << output;
+                continue;
+            }
+
+            output.parameters = IV;
+            output.value = input.value;
+            if (!encrypter.finish(output.value)) {
+                qWarning() << "Error encrypt: " << encrypter.errorString();
+                output.value.clear();
+                encrypter.reset();
+            }
+            outputs << output;
+        }
+        return outputs;
+    }
+
     Secret DhIetf1024Sha256Aes128CbcPkcs7::decrypt(const Secret& input)
     {
         SymmetricCipher decrypter;
@@ -38,6 +38,19 @@ namespace FdoSecrets
         virtual Secret encrypt(const Secret& input) = 0;
         virtual Secret decrypt(const Secret& input) = 0;
         virtual bool isValid() const = 0;
+        /**
+         * Encrypt several secrets at once, ciphers may override this to
+         * share their setup between the secrets.
+         */
+        virtual QList<Secret> encryptAll(const QList<Secret>& inputs)
+        {
+            QList<Secret> outputs;
+            outputs.reserve(inputs.size());
+            for (const auto& input : inputs) {
+                outputs << encrypt(input);
+            }
+            return outputs;
+        }
         virtual QVariant negotiationOutput() const = 0;
     };
 
@@ -80,6 +93,7 @@ namespace FdoSecrets
         Secret decrypt(const Secret& input) override;
         bool isValid() const override;
         QVariant negotiationOutput() const override;
+        QList<Secret> encryptAll(const QList<Secret>& inputs) override;
 
         bool updateClientPublicKey(const QByteArray& clientPublicKey);
 
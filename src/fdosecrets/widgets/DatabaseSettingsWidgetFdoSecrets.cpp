@@ -65,6 +65,7 @@ public:
     {
         auto groupModel = qobject_cast<GroupModel*>(sourceModel());
         Q_ASSERT(groupModel);
+        groupModel->fetchParents(group);
         return mapFromSource(groupModel->index(group));
     }
 
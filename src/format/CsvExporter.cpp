@@ -18,10 +18,21 @@
 
 #include "CsvExporter.h"
 
+#include <QBuffer>
 #include <QFile>
+#include <QtConcurrent>
 
 #include "core/Group.h"
 
+namespace
+{
+    // Formatted rows are written to the device once this many bytes are pending
+    constexpr int BufferSize = 64 * 1024;
+    // Groups with more entries than this have their rows formatted in parallel,
+    // one chunk at a time to keep the memory bounded
+    constexpr int ParallelChunkSize = 1024;
+} // namespace
+
 bool CsvExporter::exportDatabase(const QString& filename, const QSharedPointer<const Database>& db)
 {
     QFile file(filename);
@@ -34,22 +45,27 @@ bool CsvExporter::exportDatabase(const QString& filename, const QSharedPointer<c
 
 bool CsvExporter::exportDatabase(QIODevice* device, const QSharedPointer<const Database>& db)
 {
-    if (device->write(exportHeader().toUtf8()) == -1) {
-        m_error = device->errorString();
+    m_buffer.clear();
+    m_buffer.reserve(BufferSize);
+
+    if (!write(device, exportHeader().toUtf8())) {
         return false;
     }
 
-    if (device->write(exportGroup(db->rootGroup()).toUtf8()) == -1) {
-        m_error = device->errorString();
+    if (!writeGroup(device, db->rootGroup())) {
         return false;
     }
 
-    return true;
+    return flush(device);
 }
 
 QString CsvExporter::exportDatabase(const QSharedPointer<const Database>& db)
 {
-    return exportHeader() + exportGroup(db->rootGroup());
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    exportDatabase(&buffer, db);
+    return QString::fromUtf8(data);
 }
 
 QString CsvExporter::errorString() const
@@ -57,6 +73,15 @@ QString CsvExporter::errorString() const
     return m_error;
 }
 
+/**
+ * Format the rows of large groups on the global thread pool. Rows are still
+ * written in tree order. Enabled by default.
+ */
+void CsvExporter::setParallelFormatting(bool parallel)
+{
+    m_parallel = parallel;
+}
+
 QString CsvExporter::exportHeader()
 {
     QString header;
@@ -73,39 +98,84 @@ QString CsvExporter::exportHeader()
     return header + QString("\n");
 }
 
-QString CsvExporter::exportGroup(const Group* group, QString groupPath)
+QByteArray CsvExporter::exportEntry(const Entry* entry, const QString& groupPath)
+{
+    QString line;
+
+    addColumn(line, groupPath);
+    addColumn(line, entry->title());
+    addColumn(line, entry->username());
+    addColumn(line, entry->password());
+    addColumn(line, entry->url());
+    addColumn(line, entry->notes());
+    addColumn(line, entry->totpSettingsString());
+    addColumn(line, QString::number(entry->iconNumber()));
+    addColumn(line, entry->timeInfo().lastModificationTime().toString(Qt::ISODate));
+    addColumn(line, entry->timeInfo().creationTime().toString(Qt::ISODate));
+
+    line.append("\n");
+    return line.toUtf8();
+}
+
+bool CsvExporter::writeGroup(QIODevice* device, const Group* group, QString groupPath)
 {
-    QString response;
     if (!groupPath.isEmpty()) {
         groupPath.append("/");
     }
     groupPath.append(group->name());
 
     const QList<Entry*>& entryList = group->entries();
-    for (const Entry* entry : entryList) {
-        QString line;
-
-        addColumn(line, groupPath);
-        addColumn(line, entry->title());
-        addColumn(line, entry->username());
-        addColumn(line, entry->password());
-        addColumn(line, entry->url());
-        addColumn(line, entry->notes());
-        addColumn(line, entry->totpSettingsString());
-        addColumn(line, QString::number(entry->iconNumber()));
-        addColumn(line, entry->timeInfo().lastModificationTime().toString(Qt::ISODate));
-        addColumn(line, entry->timeInfo().creationTime().toString(Qt::ISODate));
-
-        line.append("\n");
-        response.append(line);
+    if (m_parallel && entryList.size() > ParallelChunkSize) {
+        for (int i = 0; i < entryList.size(); i += ParallelChunkSize) {
+            const auto rows = QtConcurrent::blockingMapped<QList<QByteArray>>(
+                entryList.mid(i, ParallelChunkSize),
+                [groupPath](const Entry* entry) { return exportEntry(entry, groupPath); });
+            for (const QByteArray& row : rows) {
+                if (!write(device, row)) {
+                    return false;
+                }
+            }
+        }
+    } else {
+        for (const Entry* entry : entryList) {
+            if (!write(device, exportEntry(entry, groupPath))) {
+                return false;
+            }
+        }
     }
 
     const QList<Group*>& children = group->children();
     for (const Group* child : children) {
-        response.append(exportGroup(child, groupPath));
+        if (!writeGroup(device, child, groupPath)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool CsvExporter::write(QIODevice* device, const QByteArray& data)
+{
+    m_buffer.append(data);
+    if (m_buffer.size() >= BufferSize) {
+        return flush(device);
+    }
+    return true;
+}
+
+bool CsvExporter::flush(QIODevice* device)
+{
+    if (m_buffer.isEmpty()) {
+        return true;
     }
 
-    return response;
+    if (device->write(m_buffer) == -1) {
+        m_error = device->errorString();
+        return false;
+    }
+    // Keeps the reserved capacity for the next rows
+    m_buffer.resize(0);
+    return true;
 }
 
 void CsvExporter::addColumn(QString& str, const QString& column)
@@ -19,13 +19,20 @@
 #ifndef KEEPASSX_CSVEXPORTER_H
 #define KEEPASSX_CSVEXPORTER_H
 
+#include <QByteArray>
 #include <QSharedPointer>
 #include <QString>
 
 class Database;
+class Entry;
 class Group;
 class QIODevice;
 
+/**
+ * Writes the database as CSV, streaming each row to the output device while
+ * the group tree is walked. At most a bounded buffer of formatted rows is held
+ * in memory at any time, so the export size does not depend on the database size.
+ */
 class CsvExporter
 {
 public:
@@ -34,11 +41,18 @@ public:
     QString exportDatabase(const QSharedPointer<const Database>& db);
     QString errorString() const;
 
+    void setParallelFormatting(bool parallel);
+
 private:
-    QString exportGroup(const Group* group, QString groupPath = QString());
-    QString exportHeader();
-    void addColumn(QString& str, const QString& column);
+    bool writeGroup(QIODevice* device, const Group* group, QString groupPath = QString());
+    bool write(QIODevice* device, const QByteArray& data);
+    bool flush(QIODevice* device);
+    static QString exportHeader();
+    static QByteArray exportEntry(const Entry* entry, const QString& groupPath);
+    static void addColumn(QString& str, const QString& column);
 
+    QByteArray m_buffer;
+    bool m_parallel = true;
     QString m_error;
 };
 
@@ -0,0 +1,253 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CsvImporter.h"
+
+#include <QFile>
+#include <QRegularExpression>
+
+#include "core/Clock.h"
+#include "core/Database.h"
+#include "core/Group.h"
+#include "totp/totp.h"
+
+namespace
+{
+    // Column names as written by CsvExporter, in the order of CsvImporter::Column
+    const QStringList ColumnNames = {QStringLiteral("Group"),
+                                     QStringLiteral("Title"),
+                                     QStringLiteral("Username"),
+                                     QStringLiteral("Password"),
+                                     QStringLiteral("URL"),
+                                     QStringLiteral("Notes"),
+                                     QStringLiteral("TOTP"),
+                                     QStringLiteral("Icon"),
+                                     QStringLiteral("Last Modified"),
+                                     QStringLiteral("Created")};
+
+    QDateTime parseTime(const QString& datetime)
+    {
+        static const QRegularExpression digits("^\\d+$");
+        if (datetime.contains(digits)) {
+            return Clock::datetimeUtc(datetime.toLongLong() * 1000);
+        }
+        return QDateTime::fromString(datetime, Qt::ISODate);
+    }
+} // namespace
+
+CsvImporter::CsvImporter(CsvParser* parser)
+    : m_parser(parser)
+{
+    // by default the CSV columns are in the same order as the fields
+    for (int i = 0; i < ColumnCount; ++i) {
+        m_columns.append(i);
+    }
+}
+
+/**
+ * Map a field to a CSV column, -1 if the field is not present.
+ */
+void CsvImporter::setColumn(Column column, int csvColumn)
+{
+    m_columns[column] = csvColumn;
+}
+
+/**
+ * Map the fields to the columns of a header row using the names written by CsvExporter.
+ *
+ * @return true if at least one of the columns was recognized
+ */
+bool CsvImporter::setColumnsFromHeader(const CsvRow& header)
+{
+    QVector<int> columns(ColumnCount, -1);
+    bool found = false;
+    for (int i = 0; i < header.size(); ++i) {
+        int column = ColumnNames.indexOf(header.at(i).trimmed());
+        if (column >= 0 && columns[column] < 0) {
+            columns[column] = i;
+            found = true;
+        }
+    }
+    if (found) {
+        m_columns = columns;
+    }
+    return found;
+}
+
+void CsvImporter::setSkippedRows(int rows)
+{
+    m_skipped = rows;
+}
+
+/**
+ * Parse the file and add an entry to the database for every row.
+ * The file is read twice, once to name the root group and once to create the entries.
+ *
+ * @return false if the file could not be parsed without errors, entries are still created for the valid rows
+ */
+bool CsvImporter::importFile(QFile* file, Database* db)
+{
+    m_imported = 0;
+    m_groups.clear();
+    setRootGroup(file, db);
+
+    int row = 0;
+    bool result = m_parser->parse(file, [&](const CsvRow& values) {
+        if (row++ >= m_skipped) {
+            createEntry(values, db);
+            ++m_imported;
+        }
+        return true;
+    });
+    m_error = result ? QString() : m_parser->getStatus().trimmed();
+    return result;
+}
+
+int CsvImporter::importedEntries() const
+{
+    return m_imported;
+}
+
+QString CsvImporter::errorString() const
+{
+    return m_error;
+}
+
+void CsvImporter::setRootGroup(QFile* file, Database* db)
+{
+    bool is_root = false;
+    bool is_empty = false;
+    bool is_label = false;
+
+    if (m_columns[GroupColumn] < 0) {
+        is_empty = true;
+    } else {
+        int row = 0;
+        m_parser->parse(file, [&](const CsvRow& values) {
+            if (row++ < m_skipped) {
+                return true;
+            }
+            // check if group name is either "root", "" (empty) or some other label
+            QString groupLabel = value(values, GroupColumn);
+            QStringList groupList = groupLabel.split("/", QString::SkipEmptyParts);
+            if (groupList.isEmpty()) {
+                is_empty = true;
+            } else if (not groupList.first().compare("Root", Qt::CaseSensitive)) {
+                is_root = true;
+            } else if (not groupLabel.compare("")) {
+                is_empty = true;
+            } else {
+                is_label = true;
+            }
+            return true;
+        });
+    }
+
+    if ((is_empty and is_root) or (is_label and not is_empty and is_root)) {
+        db->rootGroup()->setName("CSV IMPORTED");
+    } else {
+        db->rootGroup()->setName("Root");
+    }
+}
+
+Entry* CsvImporter::createEntry(const CsvRow& row, Database* db)
+{
+    auto entry = new Entry();
+    entry->setUuid(QUuid::createUuid());
+    entry->setGroup(splitGroups(value(row, GroupColumn), db));
+    entry->setTitle(value(row, TitleColumn));
+    entry->setUsername(value(row, UsernameColumn));
+    entry->setPassword(value(row, PasswordColumn));
+    entry->setUrl(value(row, UrlColumn));
+    entry->setNotes(value(row, NotesColumn));
+
+    auto otpString = value(row, TotpColumn);
+    if (!otpString.isEmpty()) {
+        auto totp = Totp::parseSettings(otpString);
+        if (totp->key.isEmpty()) {
+            // Bare secret, use default TOTP settings
+            totp = Totp::parseSettings({}, otpString);
+        }
+        entry->setTotp(totp);
+    }
+
+    bool ok;
+    int icon = value(row, IconColumn).toInt(&ok);
+    if (ok) {
+        entry->setIcon(icon);
+    }
+
+    TimeInfo timeInfo;
+    auto lastModified = parseTime(value(row, LastModifiedColumn));
+    if (lastModified.isValid()) {
+        timeInfo.setLastModificationTime(lastModified);
+    }
+    auto created = parseTime(value(row, CreatedColumn));
+    if (created.isValid()) {
+        timeInfo.setCreationTime(created);
+    }
+    entry->setTimeInfo(timeInfo);
+    return entry;
+}
+
+Group* CsvImporter::splitGroups(const QString& label, Database* db)
+{
+    // extract group names from nested path provided in "label"
+    Group* current = db->rootGroup();
+    if (label.isEmpty()) {
+        return current;
+    }
+    auto cached = m_groups.constFind(label);
+    if (cached != m_groups.constEnd()) {
+        return cached.value();
+    }
+
+    QStringList groupList = label.split("/", QString::SkipEmptyParts);
+    // avoid the creation of a subgroup with the same name as Root
+    if (current->name() == "Root" && !groupList.isEmpty() && groupList.first() == "Root") {
+        groupList.removeFirst();
+    }
+
+    for (const QString& groupName : groupList) {
+        Group* child = nullptr;
+        for (Group* group : current->children()) {
+            if (group->name() == groupName) {
+                child = group;
+                break;
+            }
+        }
+        if (!child) {
+            child = new Group();
+            child->setParent(current);
+            child->setName(groupName);
+            child->setUuid(QUuid::createUuid());
+        }
+        current = child;
+    }
+
+    m_groups.insert(label, current);
+    return current;
+}
+
+QString CsvImporter::value(const CsvRow& row, Column column) const
+{
+    int csvColumn = m_columns[column];
+    if (csvColumn < 0 || csvColumn >= row.size()) {
+        return {};
+    }
+    return row.at(csvColumn);
+}
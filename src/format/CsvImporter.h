@@ -0,0 +1,77 @@
+/*
+ *  Copyright (C) 2021 KeePassXC Team <team@keepassxc.org>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 or (at your option)
+ *  version 3 of the License.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef KEEPASSXC_CSVIMPORTER_H
+#define KEEPASSXC_CSVIMPORTER_H
+
+#include <QHash>
+#include <QVector>
+
+#include "core/CsvParser.h"
+
+class Database;
+class Entry;
+class Group;
+
+/**
+ * Creates entries from the rows of a CSV file, e.g. one written by CsvExporter.
+ * The file is streamed through the parser and every row becomes an entry as soon
+ * as it is read, so the CSV contents are never held in memory as a whole.
+ */
+class CsvImporter
+{
+public:
+    enum Column
+    {
+        GroupColumn = 0,
+        TitleColumn,
+        UsernameColumn,
+        PasswordColumn,
+        UrlColumn,
+        NotesColumn,
+        TotpColumn,
+        IconColumn,
+        LastModifiedColumn,
+        CreatedColumn,
+        ColumnCount
+    };
+
+    explicit CsvImporter(CsvParser* parser);
+
+    void setColumn(Column column, int csvColumn);
+    bool setColumnsFromHeader(const CsvRow& header);
+    void setSkippedRows(int rows);
+
+    bool importFile(QFile* file, Database* db);
+    int importedEntries() const;
+    QString errorString() const;
+
+private:
+    void setRootGroup(QFile* file, Database* db);
+    Entry* createEntry(const CsvRow& row, Database* db);
+    Group* splitGroups(const QString& label, Database* db);
+    QString value(const CsvRow& row, Column column) const;
+
+    CsvParser* const m_parser;
+    QVector<int> m_columns;
+    QHash<QString, Group*> m_groups;
+    int m_skipped = 0;
+    int m_imported = 0;
+    QString m_error;
+};
+
+#endif // KEEPASSXC_CSVIMPORTER_H
@@ -37,6 +37,9 @@ namespace
         pixmap.save(&buffer, "PNG");
         return QString("<img src=\"data:image/png;base64,") + a.toBase64() + "\"/>";
     }
+
+    // Formatted HTML is written to the device once this many bytes are pending
+    constexpr int BufferSize = 64 * 1024;
 } // namespace
 
 bool HtmlExporter::exportDatabase(const QString& filename, const QSharedPointer<const Database>& db)
@@ -97,8 +100,11 @@ bool HtmlExporter::exportDatabase(QIODevice* device, const QSharedPointer<const
     const auto footer = QString("</body>"
                                 "</html>");
 
-    if (device->write(header.toUtf8()) == -1) {
-        m_error = device->errorString();
+    m_buffer.clear();
+    m_buffer.reserve(BufferSize);
+    m_iconCache.clear();
+
+    if (!write(*device, header)) {
         return false;
     }
 
@@ -108,12 +114,12 @@ bool HtmlExporter::exportDatabase(QIODevice* device, const QSharedPointer<const
         }
     }
 
-    if (device->write(footer.toUtf8()) == -1) {
-        m_error = device->errorString();
+    if (!write(*device, footer)) {
         return false;
     }
 
-    return true;
+    m_iconCache.clear();
+    return flush(*device);
 }
 
 bool HtmlExporter::writeGroup(QIODevice& device, const Group& group, QString path)
@@ -150,112 +156,153 @@ bool HtmlExporter::writeGroup(QIODevice& device, const Group& group, QString pat
         }
 
         // Output it
-        if (device.write(header.toUtf8()) == -1) {
-            m_error = device.errorString();
+        if (!write(device, header)) {
             return false;
         }
     }
 
-    // Begin the table for the entries in this group
-    auto table = QString("<table width=\"100%\">");
+    // Stream the table for the entries in this group, one entry at a time
+    if (!write(device, "<table width=\"100%\">")) {
+        return false;
+    }
 
-    // Output the entries in this group
     for (const auto entry : entries) {
+        if (!write(device, entryRow(*entry))) {
+            return false;
+        }
+    }
 
-        // Here we collect the table rows with this entry's data fields
-        QString item;
+    if (!write(device, "</table>\n")) {
+        return false;
+    }
 
-        // Output the fixed fields
-        const auto& u = entry->username();
-        if (!u.isEmpty()) {
-            item.append("<tr><th>");
-            item.append(QObject::tr("User name"));
-            item.append("</th><td class=\"username\">");
-            item.append(entry->username().toHtmlEscaped());
-            item.append("</td></tr>");
+    // Recursively output the child groups
+    const auto& children = group.children();
+    for (const auto child : children) {
+        if (child && !writeGroup(device, *child, path)) {
+            return false;
         }
+    }
 
-        const auto& p = entry->password();
-        if (!p.isEmpty()) {
-            item.append("<tr><th>");
-            item.append(QObject::tr("Password"));
-            item.append("</th><td class=\"password\">");
-            item.append(entry->password().toHtmlEscaped());
-            item.append("</td></tr>");
-        }
+    return true;
+}
 
-        const auto& r = entry->url();
-        if (!r.isEmpty()) {
-            item.append("<tr><th>");
-            item.append(QObject::tr("URL"));
-            item.append("</th><td class=\"url\"><a href=\"");
+QString HtmlExporter::entryRow(const Entry& entry)
+{
+    // Here we collect the table rows with this entry's data fields
+    QString item;
+
+    // Output the fixed fields
+    const auto& u = entry.username();
+    if (!u.isEmpty()) {
+        item.append("<tr><th>");
+        item.append(QObject::tr("User name"));
+        item.append("</th><td class=\"username\">");
+        item.append(u.toHtmlEscaped());
+        item.append("</td></tr>");
+    }
+
+    const auto& p = entry.password();
+    if (!p.isEmpty()) {
+        item.append("<tr><th>");
+        item.append(QObject::tr("Password"));
+        item.append("</th><td class=\"password\">");
+        item.append(p.toHtmlEscaped());
+        item.append("</td></tr>");
+    }
+
+    const auto& r = entry.url();
+    if (!r.isEmpty()) {
+        item.append("<tr><th>");
+        item.append(QObject::tr("URL"));
+        item.append("</th><td class=\"url\"><a href=\"");
+        item.append(r.toHtmlEscaped());
+        item.append("\">");
+
+        // Restrict the length of what we display of the URL -
+        // even from a paper backup, nobody will every type in
+        // more than 100 characters of a URL
+        constexpr auto maxlen = 100;
+        if (r.size() <= maxlen) {
             item.append(r.toHtmlEscaped());
-            item.append("\">");
-
-            // Restrict the length of what we display of the URL -
-            // even from a paper backup, nobody will every type in
-            // more than 100 characters of a URL
-            constexpr auto maxlen = 100;
-            if (r.size() <= maxlen) {
-                item.append(r.toHtmlEscaped());
-            } else {
-                item.append(r.mid(0, maxlen).toHtmlEscaped());
-                item.append("&hellip;");
-            }
-
-            item.append("</a></td></tr>");
+        } else {
+            item.append(r.mid(0, maxlen).toHtmlEscaped());
+            item.append("&hellip;");
         }
 
-        const auto& n = entry->notes();
-        if (!n.isEmpty()) {
+        item.append("</a></td></tr>");
+    }
+
+    const auto& n = entry.notes();
+    if (!n.isEmpty()) {
+        item.append("<tr><th>");
+        item.append(QObject::tr("Notes"));
+        item.append("</th><td class=\"notes\">");
+        item.append(n.toHtmlEscaped().replace("\n", "<br>"));
+        item.append("</td></tr>");
+    }
+
+    // Now add the attributes (if there are any)
+    const auto* const attr = entry.attributes();
+    if (attr && !attr->customKeys().isEmpty()) {
+        for (const auto& key : attr->customKeys()) {
             item.append("<tr><th>");
-            item.append(QObject::tr("Notes"));
-            item.append("</th><td class=\"notes\">");
-            item.append(entry->notes().toHtmlEscaped().replace("\n", "<br>"));
+            item.append(key.toHtmlEscaped());
+            item.append("</th><td class=\"attr\">");
+            item.append(attr->value(key).toHtmlEscaped().replace(" ", "&nbsp;").replace("\n", "<br>"));
             item.append("</td></tr>");
         }
+    }
 
-        // Now add the attributes (if there are any)
-        const auto* const attr = entry->attributes();
-        if (attr && !attr->customKeys().isEmpty()) {
-            for (const auto& key : attr->customKeys()) {
-                item.append("<tr><th>");
-                item.append(key.toHtmlEscaped());
-                item.append("</th><td class=\"attr\">");
-                item.append(attr->value(key).toHtmlEscaped().replace(" ", "&nbsp;").replace("\n", "<br>"));
-                item.append("</td></tr>");
-            }
-        }
+    // Skip if everything is empty
+    if (item.isEmpty()) {
+        return {};
+    }
 
-        // Skip if everything is empty
-        if (item.isEmpty())
-            continue;
+    // Output it into our table. First the left side with
+    // icon and entry title ...
+    QString row = "<tr>";
+    row += "<td width=\"1%\">" + entryIcon(entry) + "</td>";
+    row += "<td width=\"19%\" valign=\"top\"><h3>" + entry.title().toHtmlEscaped() + "</h3></td>";
 
-        // Output it into our table. First the left side with
-        // icon and entry title ...
-        table += "<tr>";
-        table += "<td width=\"1%\">" + PixmapToHTML(entry->iconPixmap(IconSize::Medium)) + "</td>";
-        table += "<td width=\"19%\" valign=\"top\"><h3>" + entry->title().toHtmlEscaped() + "</h3></td>";
+    // ... then the right side with the data fields
+    row += "<td style=\"padding-bottom: 0.5em;\"><table width=\"100%\">" + item + "</table></td>";
+    row += "</tr>";
+    return row;
+}
 
-        // ... then the right side with the data fields
-        table += "<td style=\"padding-bottom: 0.5em;\"><table width=\"100%\">" + item + "</table></td>";
-        table += "</tr>";
+QString HtmlExporter::entryIcon(const Entry& entry)
+{
+    // Most entries share a handful of icons, so only encode each of them once
+    const auto key =
+        QString("%1/%2/%3").arg(entry.iconUuid().toString()).arg(entry.iconNumber()).arg(entry.isExpired());
+    auto it = m_iconCache.constFind(key);
+    if (it == m_iconCache.constEnd()) {
+        it = m_iconCache.insert(key, PixmapToHTML(entry.iconPixmap(IconSize::Medium)));
     }
+    return it.value();
+}
 
-    // Output the complete table of this group
-    table.append("</table>\n");
-    if (device.write(table.toUtf8()) == -1) {
-        m_error = device.errorString();
-        return false;
+bool HtmlExporter::write(QIODevice& device, const QString& html)
+{
+    m_buffer.append(html.toUtf8());
+    if (m_buffer.size() >= BufferSize) {
+        return flush(device);
     }
+    return true;
+}
 
-    // Recursively output the child groups
-    const auto& children = group.children();
-    for (const auto child : children) {
-        if (child && !writeGroup(device, *child, path)) {
-            return false;
-        }
+bool HtmlExporter::flush(QIODevice& device)
+{
+    if (m_buffer.isEmpty()) {
+        return true;
     }
 
+    if (device.write(m_buffer) == -1) {
+        m_error = device.errorString();
+        return false;
+    }
+    // Keeps the reserved capacity for the next rows
+    m_buffer.resize(0);
     return true;
 }
@@ -18,10 +18,13 @@
 #ifndef KEEPASSX_HTMLEXPORTER_H
 #define KEEPASSX_HTMLEXPORTER_H
 
+#include <QByteArray>
+#include <QHash>
 #include <QSharedPointer>
 #include <QString>
 
 class Database;
+class Entry;
 class Group;
 class QIODevice;
 
@@ -34,7 +37,13 @@ public:
 private:
     bool exportDatabase(QIODevice* device, const QSharedPointer<const Database>& db);
     bool writeGroup(QIODevice& device, const Group& group, QString path = QString());
+    QString entryRow(const Entry& entry);
+    QString entryIcon(const Entry& entry);
+    bool write(QIODevice& device, const QString& html);
+    bool flush(QIODevice& device);
 
+    QByteArray m_buffer;
+    QHash<QString, QString> m_iconCache;
     QString m_error;
 };
 
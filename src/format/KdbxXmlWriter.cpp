@@ -156,25 +156,18 @@ void KdbxXmlWriter::writeCustomIcons()
 
     const QList<QUuid> customIconsOrder = m_meta->customIconsOrder();
     for (const QUuid& uuid : customIconsOrder) {
-        writeIcon(uuid, m_meta->customIcon(uuid));
+        writeIcon(uuid, m_meta->customIconData(uuid));
     }
 
     m_xml.writeEndElement();
 }
 
-void KdbxXmlWriter::writeIcon(const QUuid& uuid, const QImage& icon)
+void KdbxXmlWriter::writeIcon(const QUuid& uuid, const QByteArray& pngData)
 {
     m_xml.writeStartElement("Icon");
 
     writeUuid("UUID", uuid);
-
-    QByteArray ba;
-    QBuffer buffer(&ba);
-    buffer.open(QIODevice::WriteOnly);
-    // TODO: check !icon.save()
-    icon.save(&buffer, "PNG");
-    buffer.close();
-    writeBinary("Data", ba);
+    writeBinary("Data", pngData);
 
     m_xml.writeEndElement();
 }
@@ -19,9 +19,33 @@
 
 SortFilterHideProxyModel::SortFilterHideProxyModel(QObject* parent)
     : QSortFilterProxyModel(parent)
+    , m_sortKeyRole(-1)
 {
 }
 
+void SortFilterHideProxyModel::setSourceModel(QAbstractItemModel* sourceModel)
+{
+    if (this->sourceModel()) {
+        disconnect(this->sourceModel(), nullptr, this, nullptr);
+    }
+    invalidateSortKeys();
+
+    // Connect before the base class so that cached keys are dropped before it re-sorts
+    if (sourceModel) {
+        connect(sourceModel, &QAbstractItemModel::dataChanged, this, &SortFilterHideProxyModel::sourceDataChanged);
+        connect(sourceModel, &QAbstractItemModel::rowsInserted, this, &SortFilterHideProxyModel::invalidateSortKeys);
+        connect(sourceModel, &QAbstractItemModel::rowsRemoved, this, &SortFilterHideProxyModel::invalidateSortKeys);
+        connect(sourceModel, &QAbstractItemModel::rowsMoved, this, &SortFilterHideProxyModel::invalidateSortKeys);
+        connect(sourceModel, &QAbstractItemModel::columnsInserted, this, &SortFilterHideProxyModel::invalidateSortKeys);
+        connect(sourceModel, &QAbstractItemModel::columnsRemoved, this, &SortFilterHideProxyModel::invalidateSortKeys);
+        connect(sourceModel, &QAbstractItemModel::columnsMoved, this, &SortFilterHideProxyModel::invalidateSortKeys);
+        connect(sourceModel, &QAbstractItemModel::layoutChanged, this, &SortFilterHideProxyModel::invalidateSortKeys);
+        connect(sourceModel, &QAbstractItemModel::modelReset, this, &SortFilterHideProxyModel::invalidateSortKeys);
+    }
+
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+}
+
 Qt::DropActions SortFilterHideProxyModel::supportedDragActions() const
 {
     return sourceModel()->supportedDragActions();
@@ -41,3 +65,62 @@ bool SortFilterHideProxyModel::filterAcceptsColumn(int sourceColumn, const QMode
 
     return sourceColumn >= m_hiddenColumns.size() || !m_hiddenColumns.at(sourceColumn);
 }
+
+/**
+ * Locale aware sorting of text compares collation keys that are built once
+ * per cell, instead of collating both strings again for every comparison.
+ */
+bool SortFilterHideProxyModel::lessThan(const QModelIndex& left, const QModelIndex& right) const
+{
+    if (!isSortLocaleAware() || left.parent().isValid() || !cacheSortKey(left) || !cacheSortKey(right)) {
+        return QSortFilterProxyModel::lessThan(left, right);
+    }
+
+    const auto& leftKey = *m_sortKeys.constFind(qMakePair(left.row(), left.column()));
+    const auto& rightKey = *m_sortKeys.constFind(qMakePair(right.row(), right.column()));
+    return leftKey.compare(rightKey) < 0;
+}
+
+/**
+ * Makes sure the collation key of the source `index` is cached. Returns false
+ * if the sort data is not text, in which case the default comparison is used.
+ */
+bool SortFilterHideProxyModel::cacheSortKey(const QModelIndex& index) const
+{
+    if (m_sortKeyRole != sortRole() || m_collator.caseSensitivity() != sortCaseSensitivity()) {
+        m_sortKeys.clear();
+        m_sortKeyRole = sortRole();
+        m_collator.setCaseSensitivity(sortCaseSensitivity());
+    }
+
+    const auto key = qMakePair(index.row(), index.column());
+    if (m_sortKeys.contains(key)) {
+        return true;
+    }
+
+    const QVariant value = sourceModel()->data(index, sortRole());
+    if (value.type() != QVariant::String) {
+        return false;
+    }
+
+    m_sortKeys.insert(key, m_collator.sortKey(value.toString()));
+    return true;
+}
+
+void SortFilterHideProxyModel::sourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight)
+{
+    if (topLeft.parent().isValid()) {
+        return;
+    }
+
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        for (int column = topLeft.column(); column <= bottomRight.column(); ++column) {
+            m_sortKeys.remove(qMakePair(row, column));
+        }
+    }
+}
+
+void SortFilterHideProxyModel::invalidateSortKeys()
+{
+    m_sortKeys.clear();
+}
@@ -19,6 +19,8 @@
 #define KEEPASSX_SORTFILTERHIDEPROXYMODEL_H
 
 #include <QBitArray>
+#include <QCollator>
+#include <QHash>
 #include <QSortFilterProxyModel>
 
 class SortFilterHideProxyModel : public QSortFilterProxyModel
@@ -27,14 +29,25 @@ class SortFilterHideProxyModel : public QSortFilterProxyModel
 
 public:
     explicit SortFilterHideProxyModel(QObject* parent = nullptr);
+    void setSourceModel(QAbstractItemModel* sourceModel) override;
     Qt::DropActions supportedDragActions() const override;
     void hideColumn(int column, bool hide);
 
 protected:
     bool filterAcceptsColumn(int sourceColumn, const QModelIndex& sourceParent) const override;
+    bool lessThan(const QModelIndex& left, const QModelIndex& right) const override;
+
+private slots:
+    void sourceDataChanged(const QModelIndex& topLeft, const QModelIndex& bottomRight);
+    void invalidateSortKeys();
 
 private:
+    bool cacheSortKey(const QModelIndex& index) const;
+
     QBitArray m_hiddenColumns;
+    mutable QCollator m_collator;
+    mutable int m_sortKeyRole;
+    mutable QHash<QPair<int, int>, QCollatorSortKey> m_sortKeys;
 };
 
 #endif // KEEPASSX_SORTFILTERHIDEPROXYMODEL_H
@@ -19,12 +19,13 @@
 #include "CsvImportWidget.h"
 #include "ui_CsvImportWidget.h"
 
+#include <QBuffer>
+#include <QFile>
 #include <QStringListModel>
 
-#include "core/Clock.h"
+#include "format/CsvImporter.h"
 #include "format/KeePass2Writer.h"
 #include "gui/MessageBox.h"
-#include "totp/totp.h"
 
 // I wanted to make the CSV import GUI future-proof, so if one day you need a new field,
 // all you have to do is add a field to m_columnHeader, and the GUI will follow:
@@ -92,13 +93,13 @@ CsvImportWidget::~CsvImportWidget()
 {
 }
 
-void CsvImportWidget::configParser()
+void CsvImportWidget::configParser(CsvParser* parser)
 {
-    m_parserModel->setBackslashSyntax(m_ui->checkBoxBackslash->isChecked());
-    m_parserModel->setComment(m_ui->comboBoxComment->currentText().at(0));
-    m_parserModel->setTextQualifier(m_ui->comboBoxTextQualifier->currentText().at(0));
-    m_parserModel->setCodec(m_ui->comboBoxCodec->currentText());
-    m_parserModel->setFieldSeparator(m_fieldSeparatorList.at(m_ui->comboBoxFieldSeparator->currentIndex()).at(0));
+    parser->setBackslashSyntax(m_ui->checkBoxBackslash->isChecked());
+    parser->setComment(m_ui->comboBoxComment->currentText().at(0));
+    parser->setTextQualifier(m_ui->comboBoxTextQualifier->currentText().at(0));
+    parser->setCodec(m_ui->comboBoxCodec->currentText());
+    parser->setFieldSeparator(m_fieldSeparatorList.at(m_ui->comboBoxFieldSeparator->currentIndex()).at(0));
 }
 
 void CsvImportWidget::updateTableview()
@@ -151,6 +152,7 @@ void CsvImportWidget::load(const QString& filename, Database* const db)
 {
     // QApplication::processEvents();
     m_db = db;
+    m_filename = filename;
     m_parserModel->setFilename(filename);
     m_ui->labelFilename->setText(filename);
     Group* group = m_db->rootGroup();
@@ -161,7 +163,7 @@ void CsvImportWidget::load(const QString& filename, Database* const db)
 
 void CsvImportWidget::parse()
 {
-    configParser();
+    configParser(m_parserModel);
     QApplication::setOverrideCursor(Qt::WaitCursor);
     // QApplication::processEvents();
     bool good = m_parserModel->parse();
@@ -190,62 +192,21 @@ QString CsvImportWidget::formatStatusText() const
 
 void CsvImportWidget::writeDatabase()
 {
-    setRootGroup();
-    for (int r = 0; r < m_parserModel->rowCount(); ++r) {
-        // use validity of second column as a GO/NOGO for all others fields
-        if (not m_parserModel->data(m_parserModel->index(r, 1)).isValid()) {
-            continue;
-        }
-        Entry* entry = new Entry();
-        entry->setUuid(QUuid::createUuid());
-        entry->setGroup(splitGroups(m_parserModel->data(m_parserModel->index(r, 0)).toString()));
-        entry->setTitle(m_parserModel->data(m_parserModel->index(r, 1)).toString());
-        entry->setUsername(m_parserModel->data(m_parserModel->index(r, 2)).toString());
-        entry->setPassword(m_parserModel->data(m_parserModel->index(r, 3)).toString());
-        entry->setUrl(m_parserModel->data(m_parserModel->index(r, 4)).toString());
-        entry->setNotes(m_parserModel->data(m_parserModel->index(r, 5)).toString());
+    // the file is parsed again as a stream, the preview only holds the first rows
+    CsvParser parser;
+    configParser(&parser);
 
-        auto otpString = m_parserModel->data(m_parserModel->index(r, 6));
-        if (otpString.isValid() && !otpString.toString().isEmpty()) {
-            auto totp = Totp::parseSettings(otpString.toString());
-            if (totp->key.isEmpty()) {
-                // Bare secret, use default TOTP settings
-                totp = Totp::parseSettings({}, otpString.toString());
-            }
-            entry->setTotp(totp);
-        }
+    CsvImporter importer(&parser);
+    for (int i = 0; i < CsvImporter::ColumnCount; ++i) {
+        importer.setColumn(static_cast<CsvImporter::Column>(i), m_parserModel->csvColumn(i));
+    }
+    importer.setSkippedRows(m_ui->spinBoxSkip->value());
 
-        bool ok;
-        int icon = m_parserModel->data(m_parserModel->index(r, 7)).toInt(&ok);
-        if (ok) {
-            entry->setIcon(icon);
-        }
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    QFile csv(m_filename);
+    importer.importFile(&csv, m_db);
+    QApplication::restoreOverrideCursor();
 
-        TimeInfo timeInfo;
-        if (m_parserModel->data(m_parserModel->index(r, 8)).isValid()) {
-            auto datetime = m_parserModel->data(m_parserModel->index(r, 8)).toString();
-            if (datetime.contains(QRegularExpression("^\\d+$"))) {
-                timeInfo.setLastModificationTime(Clock::datetimeUtc(datetime.toLongLong() * 1000));
-            } else {
-                auto lastModified = QDateTime::fromString(datetime, Qt::ISODate);
-                if (lastModified.isValid()) {
-                    timeInfo.setLastModificationTime(lastModified);
-                }
-            }
-        }
-        if (m_parserModel->data(m_parserModel->index(r, 9)).isValid()) {
-            auto datetime = m_parserModel->data(m_parserModel->index(r, 9)).toString();
-            if (datetime.contains(QRegularExpression("^\\d+$"))) {
-                timeInfo.setCreationTime(Clock::datetimeUtc(datetime.toLongLong() * 1000));
-            } else {
-                auto created = QDateTime::fromString(datetime, Qt::ISODate);
-                if (created.isValid()) {
-                    timeInfo.setCreationTime(created);
-                }
-            }
-        }
-        entry->setTimeInfo(timeInfo);
-    }
     QBuffer buffer;
     buffer.open(QBuffer::ReadWrite);
 
@@ -261,83 +222,6 @@ void CsvImportWidget::writeDatabase()
     emit editFinished(true);
 }
 
-void CsvImportWidget::setRootGroup()
-{
-    QString groupLabel;
-    QStringList groupList;
-    bool is_root = false;
-    bool is_empty = false;
-    bool is_label = false;
-
-    for (int r = 0; r < m_parserModel->rowCount(); ++r) {
-        // use validity of second column as a GO/NOGO for all others fields
-        if (not m_parserModel->data(m_parserModel->index(r, 1)).isValid()) {
-            continue;
-        }
-        groupLabel = m_parserModel->data(m_parserModel->index(r, 0)).toString();
-        // check if group name is either "root", "" (empty) or some other label
-        groupList = groupLabel.split("/", QString::SkipEmptyParts);
-        if (groupList.isEmpty()) {
-            is_empty = true;
-        } else if (not groupList.first().compare("Root", Qt::CaseSensitive)) {
-            is_root = true;
-        } else if (not groupLabel.compare("")) {
-            is_empty = true;
-        } else {
-            is_label = true;
-        }
-
-        groupList.clear();
-    }
-
-    if ((is_empty and is_root) or (is_label and not is_empty and is_root)) {
-        m_db->rootGroup()->setName("CSV IMPORTED");
-    } else {
-        m_db->rootGroup()->setName("Root");
-    }
-}
-
-Group* CsvImportWidget::splitGroups(const QString& label)
-{
-    // extract group names from nested path provided in "label"
-    Group* current = m_db->rootGroup();
-    if (label.isEmpty()) {
-        return current;
-    }
-
-    QStringList groupList = label.split("/", QString::SkipEmptyParts);
-    // avoid the creation of a subgroup with the same name as Root
-    if (m_db->rootGroup()->name() == "Root" && groupList.first() == "Root") {
-        groupList.removeFirst();
-    }
-
-    for (const QString& groupName : groupList) {
-        Group* children = hasChildren(current, groupName);
-        if (children == nullptr) {
-            Group* brandNew = new Group();
-            brandNew->setParent(current);
-            brandNew->setName(groupName);
-            brandNew->setUuid(QUuid::createUuid());
-            current = brandNew;
-        } else {
-            Q_ASSERT(children != nullptr);
-            current = children;
-        }
-    }
-    return current;
-}
-
-Group* CsvImportWidget::hasChildren(Group* current, const QString& groupName)
-{
-    // returns the group whose name is "groupName" and is child of "current" group
-    for (Group* group : current->children()) {
-        if (group->name() == groupName) {
-            return group;
-        }
-    }
-    return nullptr;
-}
-
 void CsvImportWidget::reject()
 {
     emit editFinished(false);
@@ -49,7 +49,6 @@ private slots:
     void skippedChanged(int rows);
     void writeDatabase();
     void updatePreview();
-    void setRootGroup();
     void reject();
 
 private:
@@ -59,13 +58,12 @@ private:
     QStringListModel* const m_comboModel;
     QList<QComboBox*> m_combos;
     Database* m_db;
+    QString m_filename;
 
     const QStringList m_columnHeader;
     QStringList m_fieldSeparatorList;
-    void configParser();
+    void configParser(CsvParser* parser);
     void updateTableview();
-    Group* splitGroups(const QString& label);
-    Group* hasChildren(Group* current, const QString& groupName);
     QString formatStatusText() const;
 };
 
@@ -19,10 +19,18 @@
 #include "CsvParserModel.h"
 
 #include <QFile>
+#include <limits>
+
+namespace
+{
+    // Only the first rows of the file are kept for the preview
+    const int PreviewRows = 1000;
+} // namespace
 
 CsvParserModel::CsvParserModel(QObject* parent)
     : QAbstractTableModel(parent)
     , m_skipped(0)
+    , m_totalRows(0)
 {
 }
 
@@ -37,38 +45,58 @@ void CsvParserModel::setFilename(const QString& filename)
 
 QString CsvParserModel::getFileInfo()
 {
+    int bytes = static_cast<int>(qMin<qint64>(getFileSize(), std::numeric_limits<int>::max()));
     QString a(tr("%1, %2, %3", "file info: bytes, rows, columns")
-                  .arg(tr("%n byte(s)", nullptr, getFileSize()),
-                       tr("%n row(s)", nullptr, getCsvRows()),
+                  .arg(tr("%n byte(s)", nullptr, bytes),
+                       tr("%n row(s)", nullptr, m_totalRows),
                        tr("%n column(s)", nullptr, qMax(0, getCsvCols() - 1))));
     return a;
 }
 
 bool CsvParserModel::parse()
 {
-    bool r;
     beginResetModel();
     m_columnMap.clear();
-    if (CsvParser::isFileLoaded()) {
-        r = CsvParser::reparse();
-    } else {
-        QFile csv(m_filename);
-        r = CsvParser::parse(&csv);
-    }
+    m_table.clear();
+    m_totalRows = 0;
+
+    // the whole file is scanned for its size and errors, but only the preview rows are kept
+    int maxCols = 0;
+    QFile csv(m_filename);
+    bool r = CsvParser::parse(&csv, [this, &maxCols](const CsvRow& row) {
+        if (m_table.size() < PreviewRows) {
+            m_table.append(row);
+        }
+        maxCols = qMax(maxCols, row.size());
+        ++m_totalRows;
+        return true;
+    });
+
     for (int i = 0; i < columnCount(); ++i) {
         m_columnMap.insert(i, 0);
     }
-    addEmptyColumn();
+    addEmptyColumn(maxCols);
     endResetModel();
     return r;
 }
 
-void CsvParserModel::addEmptyColumn()
+/**
+ * CSV column mapped to the given database column, -1 if it is not present.
+ */
+int CsvParserModel::csvColumn(int dbColumn) const
+{
+    return m_columnMap.value(dbColumn) - 1;
+}
+
+void CsvParserModel::addEmptyColumn(int columns)
 {
+    // fill shorter rows with empty placeholder columns as well
     for (int i = 0; i < m_table.size(); ++i) {
-        CsvRow r = m_table.at(i);
+        CsvRow& r = m_table[i];
         r.prepend(QString(""));
-        m_table.replace(i, r);
+        while (r.size() <= columns) {
+            r.append(QString(""));
+        }
     }
 }
 
@@ -34,6 +34,7 @@ public:
     void setFilename(const QString& filename);
     QString getFileInfo();
     bool parse();
+    int csvColumn(int dbColumn) const;
 
     void setHeaderLabels(const QStringList& labels);
     void mapColumns(int csvColumn, int dbColumn);
@@ -48,10 +49,11 @@ public slots:
 
 private:
     int m_skipped;
+    int m_totalRows;
     QString m_filename;
     QStringList m_columnHeader;
     // first column of model must be empty (aka combobox row "Not present in CSV file")
-    void addEmptyColumn();
+    void addEmptyColumn(int columns);
     // mapping CSV columns to keepassx columns
     QMap<int, int> m_columnMap;
 };
@@ -32,10 +32,12 @@
 
 EntryModel::EntryModel(QObject* parent)
     : QAbstractTableModel(parent)
-    , m_group(nullptr)
+    , m_batchUpdateDepth(0)
+    , m_batchResetBegun(false)
     , HiddenContentDisplay(QString("\u25cf").repeated(6))
     , DateFormat(Qt::DefaultLocaleShortDate)
 {
+    loadDisplaySettings();
     connect(config(), &Config::changed, this, &EntryModel::onConfigChanged);
 }
 
@@ -58,9 +60,18 @@ void EntryModel::setGroup(Group* group)
         return;
     }
 
+    if (m_batchUpdateDepth > 0) {
+        m_batchUpdateDepth = 0;
+        if (m_batchResetBegun) {
+            m_batchResetBegun = false;
+            endResetModel();
+        }
+    }
+
     beginResetModel();
 
     severConnections();
+    invalidateRows();
 
     m_group = group;
     m_allGroups.clear();
@@ -68,15 +79,27 @@ void EntryModel::setGroup(Group* group)
     m_orgEntries.clear();
 
     makeConnections(group);
+    if (group->database()) {
+        makeConnections(group->database());
+    }
 
     endResetModel();
 }
 
 void EntryModel::setEntries(const QList<Entry*>& entries)
 {
+    if (m_batchUpdateDepth > 0) {
+        m_batchUpdateDepth = 0;
+        if (m_batchResetBegun) {
+            m_batchResetBegun = false;
+            endResetModel();
+        }
+    }
+
     beginResetModel();
 
     severConnections();
+    invalidateRows();
 
     m_group = nullptr;
     m_allGroups.clear();
@@ -91,6 +114,7 @@ void EntryModel::setEntries(const QList<Entry*>& entries)
 
     for (Database* db : asConst(databases)) {
         Q_ASSERT(db);
+        makeConnections(db);
         const QList<Group*> groupList = db->rootGroup()->groupsRecursive(true);
         for (const Group* group : groupList) {
             m_allGroups.append(group);
@@ -134,7 +158,6 @@ QVariant EntryModel::data(const QModelIndex& index, int role) const
     }
 
     Entry* entry = entryFromIndex(index);
-    EntryAttributes* attr = entry->attributes();
 
     if (role == Qt::DisplayRole) {
         QString result;
@@ -145,56 +168,51 @@ QVariant EntryModel::data(const QModelIndex& index, int role) const
             }
             break;
         case Title:
-            result = entry->resolveMultiplePlaceholders(entry->title());
-            if (attr->isReference(EntryAttributes::TitleKey)) {
-                result.prepend(tr("Ref: ", "Reference abbreviation"));
+            return displayRow(entry).title;
+        case Username: {
+            if (entry->username().isEmpty() && !m_settings.emptyPlaceholder) {
+                return result;
             }
-            return result;
-        case Username:
-            if (config()->get(Config::GUI_HideUsernames).toBool()) {
-                result = EntryModel::HiddenContentDisplay;
-            } else {
-                result = entry->resolveMultiplePlaceholders(entry->username());
+            const auto& row = displayRow(entry);
+            if (!m_settings.hideUsernames) {
+                return row.username;
             }
-            if (attr->isReference(EntryAttributes::UserNameKey)) {
+            result = EntryModel::HiddenContentDisplay;
+            if (row.usernameRef) {
                 result.prepend(tr("Ref: ", "Reference abbreviation"));
             }
-            if (entry->username().isEmpty() && !config()->get(Config::Security_PasswordEmptyPlaceholder).toBool()) {
-                result = "";
-            }
             return result;
-        case Password:
-            if (config()->get(Config::GUI_HidePasswords).toBool()) {
-                result = EntryModel::HiddenContentDisplay;
-            } else {
-                result = entry->resolveMultiplePlaceholders(entry->password());
+        }
+        case Password: {
+            if (entry->password().isEmpty() && !m_settings.emptyPlaceholder) {
+                return result;
             }
-            if (attr->isReference(EntryAttributes::PasswordKey)) {
-                result.prepend(tr("Ref: ", "Reference abbreviation"));
+            const auto& row = displayRow(entry);
+            if (!m_settings.hidePasswords) {
+                return row.password;
             }
-            if (entry->password().isEmpty() && !config()->get(Config::Security_PasswordEmptyPlaceholder).toBool()) {
-                result = "";
+            result = EntryModel::HiddenContentDisplay;
+            if (row.passwordRef) {
+                result.prepend(tr("Ref: ", "Reference abbreviation"));
             }
             return result;
+        }
         case Url:
-            result = entry->resolveMultiplePlaceholders(entry->displayUrl());
-            if (attr->isReference(EntryAttributes::URLKey)) {
-                result.prepend(tr("Ref: ", "Reference abbreviation"));
+            return displayRow(entry).url;
+        case Notes: {
+            if (entry->notes().isEmpty()) {
+                return result;
             }
-            return result;
-        case Notes:
-            if (!entry->notes().isEmpty()) {
-                if (config()->get(Config::Security_HideNotes).toBool()) {
-                    result = EntryModel::HiddenContentDisplay;
-                } else {
-                    // Display only first line of notes in simplified format if not hidden
-                    result = entry->notes().section("\n", 0, 0).simplified();
-                }
-                if (attr->isReference(EntryAttributes::NotesKey)) {
-                    result.prepend(tr("Ref: ", "Reference abbreviation"));
-                }
+            const auto& row = displayRow(entry);
+            if (!m_settings.hideNotes) {
+                return row.notes;
+            }
+            result = EntryModel::HiddenContentDisplay;
+            if (row.notesRef) {
+                result.prepend(tr("Ref: ", "Reference abbreviation"));
             }
             return result;
+        }
         case Expires:
             // Display either date of expiry or 'Never'
             result = entry->timeInfo().expires()
@@ -242,9 +260,9 @@ QVariant EntryModel::data(const QModelIndex& index, int role) const
     } else if (role == Qt::UserRole) { // Qt::UserRole is used as sort role, see EntryView::EntryView()
         switch (index.column()) {
         case Username:
-            return entry->resolveMultiplePlaceholders(entry->username());
+            return displayRow(entry).usernameSortKey;
         case Password:
-            return entry->resolveMultiplePlaceholders(entry->password());
+            return displayRow(entry).passwordSortKey;
         case PasswordStrength: {
             if (!entry->password().isEmpty() && !entry->excludeFromReports()) {
                 return entry->passwordHealth()->score();
@@ -307,7 +325,9 @@ QVariant EntryModel::data(const QModelIndex& index, int role) const
                     break;
                 case PasswordHealth::Quality::Good:
                 case PasswordHealth::Quality::Excellent:
-                    color = statePalette.color(StateColorPalette::HealthExcellent);
+                    // Re-used passwords are never considered good, same as in the health check
+                    color = statePalette.color(reuseCount(entry) > 1 ? StateColorPalette::HealthBad
+                                                                     : StateColorPalette::HealthExcellent);
                     break;
                 }
 
@@ -324,7 +344,7 @@ QVariant EntryModel::data(const QModelIndex& index, int role) const
     } else if (role == Qt::ForegroundRole) {
         QColor foregroundColor;
         foregroundColor.setNamedColor(entry->foregroundColor());
-        if (entry->hasReferences()) {
+        if (displayRow(entry).hasReferences) {
             QPalette p;
             foregroundColor = p.color(QPalette::Current, QPalette::Text);
             int lightness =
@@ -342,7 +362,15 @@ QVariant EntryModel::data(const QModelIndex& index, int role) const
         }
     } else if (role == Qt::ToolTipRole) {
         if (index.column() == PasswordStrength && !entry->password().isEmpty() && !entry->excludeFromReports()) {
-            return entry->passwordHealth()->scoreReason();
+            QStringList reasons;
+            if (!entry->passwordHealth()->scoreReason().isEmpty()) {
+                reasons << entry->passwordHealth()->scoreReason();
+            }
+            const auto count = reuseCount(entry);
+            if (count > 1) {
+                reasons << tr("Password is used %1 time(s)", "", count).arg(count);
+            }
+            return reasons.join('\n');
         }
     }
 
@@ -495,6 +523,13 @@ void EntryModel::entryAboutToAdd(Entry* entry)
         return;
     }
 
+    if (deferToBatchUpdate()) {
+        if (!m_group) {
+            m_entries.append(entry);
+        }
+        return;
+    }
+
     beginInsertRows(QModelIndex(), m_entries.size(), m_entries.size());
     if (!m_group) {
         m_entries.append(entry);
@@ -503,7 +538,7 @@ void EntryModel::entryAboutToAdd(Entry* entry)
 
 void EntryModel::entryAdded(Entry* entry)
 {
-    if (!m_group && !m_orgEntries.contains(entry)) {
+    if ((!m_group && !m_orgEntries.contains(entry)) || deferToBatchUpdate()) {
         return;
     }
 
@@ -515,6 +550,14 @@ void EntryModel::entryAdded(Entry* entry)
 
 void EntryModel::entryAboutToRemove(Entry* entry)
 {
+    invalidateRow(entry);
+
+    if (deferToBatchUpdate()) {
+        // The entry may be deleted before the batch update is finished
+        m_entries.removeAll(entry);
+        return;
+    }
+
     beginRemoveRows(QModelIndex(), m_entries.indexOf(entry), m_entries.indexOf(entry));
     if (!m_group) {
         m_entries.removeAll(entry);
@@ -523,6 +566,10 @@ void EntryModel::entryAboutToRemove(Entry* entry)
 
 void EntryModel::entryRemoved()
 {
+    if (deferToBatchUpdate()) {
+        return;
+    }
+
     if (m_group) {
         m_entries = m_group->entries();
     }
@@ -531,6 +578,10 @@ void EntryModel::entryRemoved()
 
 void EntryModel::entryAboutToMoveUp(int row)
 {
+    if (deferToBatchUpdate()) {
+        return;
+    }
+
     beginMoveRows(QModelIndex(), row, row, QModelIndex(), row - 1);
     if (m_group) {
         m_entries.move(row, row - 1);
@@ -539,6 +590,10 @@ void EntryModel::entryAboutToMoveUp(int row)
 
 void EntryModel::entryMovedUp()
 {
+    if (deferToBatchUpdate()) {
+        return;
+    }
+
     if (m_group) {
         m_entries = m_group->entries();
     }
@@ -547,6 +602,10 @@ void EntryModel::entryMovedUp()
 
 void EntryModel::entryAboutToMoveDown(int row)
 {
+    if (deferToBatchUpdate()) {
+        return;
+    }
+
     beginMoveRows(QModelIndex(), row, row, QModelIndex(), row + 2);
     if (m_group) {
         m_entries.move(row, row + 1);
@@ -555,6 +614,10 @@ void EntryModel::entryAboutToMoveDown(int row)
 
 void EntryModel::entryMovedDown()
 {
+    if (deferToBatchUpdate()) {
+        return;
+    }
+
     if (m_group) {
         m_entries = m_group->entries();
     }
@@ -563,33 +626,196 @@ void EntryModel::entryMovedDown()
 
 void EntryModel::entryDataChanged(Entry* entry)
 {
+    if (deferToBatchUpdate()) {
+        return;
+    }
+
+    invalidateRow(entry);
     int row = m_entries.indexOf(entry);
     emit dataChanged(index(row, 0), index(row, columnCount() - 1));
 }
 
+/**
+ * Rows with references may resolve through any entry of the database,
+ * including ones outside of the displayed group.
+ */
+void EntryModel::referencedEntryChanged(Entry* entry)
+{
+    Q_UNUSED(entry);
+    if (m_referencingRows.isEmpty() || deferToBatchUpdate()) {
+        return;
+    }
+
+    const auto referencingRows = m_referencingRows;
+    m_referencingRows.clear();
+    for (const Entry* referencing : referencingRows) {
+        m_rowCache.remove(referencing);
+        int row = m_entries.indexOf(const_cast<Entry*>(referencing));
+        if (row >= 0) {
+            emit dataChanged(index(row, 0), index(row, columnCount() - 1));
+        }
+    }
+}
+
+void EntryModel::passwordReuseChanged()
+{
+    if (deferToBatchUpdate()) {
+        return;
+    }
+
+    emit dataChanged(index(0, PasswordStrength), index(rowCount() - 1, PasswordStrength));
+}
+
+/**
+ * Changes made during a batch update of a database are not reported one by
+ * one; the model is reset once all batches are finished instead.
+ */
+void EntryModel::batchUpdateStarted()
+{
+    ++m_batchUpdateDepth;
+}
+
+void EntryModel::batchUpdateFinished()
+{
+    if (m_batchUpdateDepth == 0 || --m_batchUpdateDepth > 0 || !m_batchResetBegun) {
+        return;
+    }
+
+    m_batchResetBegun = false;
+    if (m_group) {
+        m_entries = m_group->entries();
+    }
+    invalidateRows();
+    endResetModel();
+}
+
+/**
+ * Returns whether a change is left to the reset at the end of the batch update.
+ * The reset begins with the first change, so that batches without any changes,
+ * such as merging an unchanged database, keep the views as they are.
+ */
+bool EntryModel::deferToBatchUpdate()
+{
+    if (m_batchUpdateDepth == 0) {
+        return false;
+    }
+
+    if (!m_batchResetBegun) {
+        beginResetModel();
+        m_batchResetBegun = true;
+    }
+    return true;
+}
+
 void EntryModel::onConfigChanged(Config::ConfigKey key)
 {
     switch (key) {
     case Config::GUI_HideUsernames:
+        loadDisplaySettings();
         emit dataChanged(index(0, Username), index(rowCount() - 1, Username), {Qt::DisplayRole});
         break;
     case Config::GUI_HidePasswords:
+        loadDisplaySettings();
         emit dataChanged(index(0, Password), index(rowCount() - 1, Password), {Qt::DisplayRole});
         break;
+    case Config::Security_HideNotes:
+        loadDisplaySettings();
+        emit dataChanged(index(0, Notes), index(rowCount() - 1, Notes), {Qt::DisplayRole});
+        break;
+    case Config::Security_PasswordEmptyPlaceholder:
+        loadDisplaySettings();
+        emit dataChanged(index(0, Username), index(rowCount() - 1, Password), {Qt::DisplayRole});
+        break;
     default:
         break;
     }
 }
 
+void EntryModel::loadDisplaySettings()
+{
+    m_settings.hideUsernames = config()->get(Config::GUI_HideUsernames).toBool();
+    m_settings.hidePasswords = config()->get(Config::GUI_HidePasswords).toBool();
+    m_settings.hideNotes = config()->get(Config::Security_HideNotes).toBool();
+    m_settings.emptyPlaceholder = config()->get(Config::Security_PasswordEmptyPlaceholder).toBool();
+}
+
+/**
+ * Display strings of `entry` with placeholders resolved and references
+ * marked, computed on first use and kept until the entry changes.
+ */
+EntryModel::DisplayRow& EntryModel::displayRow(const Entry* entry) const
+{
+    auto it = m_rowCache.find(entry);
+    if (it != m_rowCache.end()) {
+        return it.value();
+    }
+
+    const EntryAttributes* attr = entry->attributes();
+    const QString refPrefix = tr("Ref: ", "Reference abbreviation");
+    DisplayRow row;
+
+    row.title = entry->resolveMultiplePlaceholders(entry->title());
+    if (attr->isReference(EntryAttributes::TitleKey)) {
+        row.title.prepend(refPrefix);
+    }
+
+    row.usernameSortKey = entry->resolveMultiplePlaceholders(entry->username());
+    row.usernameRef = attr->isReference(EntryAttributes::UserNameKey);
+    row.username = row.usernameRef ? refPrefix + row.usernameSortKey : row.usernameSortKey;
+
+    row.passwordSortKey = entry->resolveMultiplePlaceholders(entry->password());
+    row.passwordRef = attr->isReference(EntryAttributes::PasswordKey);
+    row.password = row.passwordRef ? refPrefix + row.passwordSortKey : row.passwordSortKey;
+
+    row.url = entry->resolveMultiplePlaceholders(entry->displayUrl());
+    if (attr->isReference(EntryAttributes::URLKey)) {
+        row.url.prepend(refPrefix);
+    }
+
+    // Display only first line of notes in simplified format if not hidden
+    row.notesRef = attr->isReference(EntryAttributes::NotesKey);
+    row.notes = entry->notes().section("\n", 0, 0).simplified();
+    if (row.notesRef) {
+        row.notes.prepend(refPrefix);
+    }
+
+    row.hasReferences = entry->hasReferences();
+    if (row.hasReferences) {
+        m_referencingRows.insert(entry);
+    }
+
+    return m_rowCache.insert(entry, row).value();
+}
+
+void EntryModel::invalidateRow(const Entry* entry)
+{
+    m_rowCache.remove(entry);
+    m_referencingRows.remove(entry);
+}
+
+void EntryModel::invalidateRows()
+{
+    m_rowCache.clear();
+    m_referencingRows.clear();
+}
+
 void EntryModel::severConnections()
 {
     if (m_group) {
-        disconnect(m_group, nullptr, this, nullptr);
+        disconnect(m_group.data(), nullptr, this, nullptr);
     }
 
     for (const Group* group : asConst(m_allGroups)) {
         disconnect(group, nullptr, this, nullptr);
     }
+
+    for (const auto& db : asConst(m_databases)) {
+        if (db) {
+            disconnect(db.data(), nullptr, this, nullptr);
+            disconnect(db->reuseIndex(), nullptr, this, nullptr);
+        }
+    }
+    m_databases.clear();
 }
 
 void EntryModel::makeConnections(const Group* group)
@@ -604,3 +830,22 @@ void EntryModel::makeConnections(const Group* group)
     connect(group, SIGNAL(entryMovedDown()), SLOT(entryMovedDown()));
     connect(group, SIGNAL(entryDataChanged(Entry*)), SLOT(entryDataChanged(Entry*)));
 }
+
+void EntryModel::makeConnections(const Database* db)
+{
+    connect(db->reuseIndex(), &PasswordReuseIndex::reuseChanged, this, &EntryModel::passwordReuseChanged);
+    connect(db, &Database::entryDataChanged, this, &EntryModel::referencedEntryChanged);
+    connect(db, &Database::entryAboutToRemove, this, &EntryModel::referencedEntryChanged);
+    connect(db, &Database::batchUpdateStarted, this, &EntryModel::batchUpdateStarted);
+    connect(db, &Database::batchUpdateFinished, this, &EntryModel::batchUpdateFinished);
+    m_databases.append(db);
+}
+
+/**
+ * Number of entries sharing the password of `entry`, including itself.
+ */
+int EntryModel::reuseCount(const Entry* entry) const
+{
+    const auto db = entry->database();
+    return db ? db->reuseIndex()->count(entry) : 0;
+}
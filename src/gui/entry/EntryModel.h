@@ -19,10 +19,14 @@
 #define KEEPASSX_ENTRYMODEL_H
 
 #include <QAbstractTableModel>
+#include <QHash>
 #include <QPixmap>
+#include <QPointer>
+#include <QSet>
 
 #include "core/Config.h"
 
+class Database;
 class Entry;
 class Group;
 
@@ -77,17 +81,59 @@ private slots:
     void entryAboutToMoveDown(int row);
     void entryMovedDown();
     void entryDataChanged(Entry* entry);
+    void referencedEntryChanged(Entry* entry);
+    void passwordReuseChanged();
+    void batchUpdateStarted();
+    void batchUpdateFinished();
 
     void onConfigChanged(Config::ConfigKey key);
 
 private:
+    // Config flags used while painting, read once instead of on every cell
+    struct DisplaySettings
+    {
+        bool hideUsernames = false;
+        bool hidePasswords = false;
+        bool hideNotes = false;
+        bool emptyPlaceholder = false;
+    };
+
+    // Resolved display strings of one entry, see displayRow()
+    struct DisplayRow
+    {
+        QString title;
+        QString username;
+        QString password;
+        QString url;
+        QString notes;
+        QString usernameSortKey;
+        QString passwordSortKey;
+        bool usernameRef = false;
+        bool passwordRef = false;
+        bool notesRef = false;
+        bool hasReferences = false;
+    };
+
+    bool deferToBatchUpdate();
+    DisplayRow& displayRow(const Entry* entry) const;
+    void invalidateRow(const Entry* entry);
+    void invalidateRows();
+    void loadDisplaySettings();
     void severConnections();
     void makeConnections(const Group* group);
+    void makeConnections(const Database* db);
+    int reuseCount(const Entry* entry) const;
 
-    Group* m_group;
+    QPointer<Group> m_group;
     QList<Entry*> m_entries;
     QList<Entry*> m_orgEntries;
     QList<const Group*> m_allGroups;
+    QList<QPointer<const Database>> m_databases;
+    int m_batchUpdateDepth;
+    bool m_batchResetBegun;
+    DisplaySettings m_settings;
+    mutable QHash<const Entry*, DisplayRow> m_rowCache;
+    mutable QSet<const Entry*> m_referencingRows;
 
     const QString HiddenContentDisplay;
     const Qt::DateFormat DateFormat;
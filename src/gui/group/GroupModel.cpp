@@ -26,15 +26,28 @@
 GroupModel::GroupModel(Database* db, QObject* parent)
     : QAbstractItemModel(parent)
     , m_db(nullptr)
+    , m_batchUpdating(false)
+    , m_batchResetBegun(false)
+    , m_pendingChange(PendingChange::None)
 {
     changeDatabase(db);
 }
 
 void GroupModel::changeDatabase(Database* newDb)
 {
+    if (m_batchUpdating) {
+        m_batchUpdating = false;
+        if (m_batchResetBegun) {
+            m_batchResetBegun = false;
+            endResetModel();
+        }
+    }
+
     beginResetModel();
 
     m_db = newDb;
+    m_fetchedGroups.clear();
+    m_rows.clear();
 
     // clang-format off
     connect(m_db, SIGNAL(groupDataChanged(Group*)), SLOT(groupDataChanged(Group*)));
@@ -44,6 +57,8 @@ void GroupModel::changeDatabase(Database* newDb)
     connect(m_db, SIGNAL(groupRemoved()), SLOT(groupRemoved()));
     connect(m_db, SIGNAL(groupAboutToMove(Group*,Group*,int)), SLOT(groupAboutToMove(Group*,Group*,int)));
     connect(m_db, SIGNAL(groupMoved()), SLOT(groupMoved()));
+    connect(m_db, SIGNAL(batchUpdateStarted()), SLOT(batchUpdateStarted()));
+    connect(m_db, SIGNAL(batchUpdateFinished()), SLOT(batchUpdateFinished()));
     // clang-format on
 
     endResetModel();
@@ -56,7 +71,55 @@ int GroupModel::rowCount(const QModelIndex& parent) const
         return 1;
     } else {
         const Group* group = groupFromIndex(parent);
-        return group->children().size();
+        return m_fetchedGroups.contains(group) ? group->children().size() : 0;
+    }
+}
+
+bool GroupModel::hasChildren(const QModelIndex& parent) const
+{
+    if (!parent.isValid()) {
+        return true;
+    }
+    return !groupFromIndex(parent)->children().isEmpty();
+}
+
+/**
+ * Children of a group are only reported to views once the group is expanded,
+ * so that very large trees do not have to be laid out up front.
+ */
+bool GroupModel::canFetchMore(const QModelIndex& parent) const
+{
+    if (!parent.isValid()) {
+        return false;
+    }
+    const Group* group = groupFromIndex(parent);
+    return !m_fetchedGroups.contains(group) && !group->children().isEmpty();
+}
+
+void GroupModel::fetchMore(const QModelIndex& parent)
+{
+    if (!canFetchMore(parent)) {
+        return;
+    }
+
+    const Group* group = groupFromIndex(parent);
+    beginInsertRows(parent, 0, group->children().size() - 1);
+    m_fetchedGroups.insert(group);
+    endInsertRows();
+}
+
+/**
+ * Populates all ancestors of `group` so that its index is known to views.
+ */
+void GroupModel::fetchParents(Group* group)
+{
+    QList<Group*> parents;
+    for (Group* parentGroup = group->parentGroup(); parentGroup; parentGroup = parentGroup->parentGroup()) {
+        parents.prepend(parentGroup);
+    }
+
+    for (Group* parentGroup : asConst(parents)) {
+        fetchMore(index(parentGroup));
     }
 }
 
@@ -106,11 +169,59 @@ QModelIndex GroupModel::parent(Group* group) const
             // parent is the root group
             return createIndex(0, 0, parentGroup);
         } else {
-            return createIndex(grandParentGroup->children().indexOf(parentGroup), 0, parentGroup);
+            return createIndex(row(parentGroup), 0, parentGroup);
         }
     }
 }
 
+/**
+ * Position of `group` among its siblings. The positions of all siblings are
+ * cached at once and dropped whenever the tree structure changes.
+ */
+int GroupModel::row(const Group* group) const
+{
+    const Group* parentGroup = group->parentGroup();
+    if (!parentGroup) {
+        return 0;
+    }
+
+    auto it = m_rows.constFind(group);
+    if (it != m_rows.constEnd()) {
+        return it.value();
+    }
+
+    const QList<Group*>& siblings = parentGroup->children();
+    for (int i = 0; i < siblings.size(); ++i) {
+        m_rows.insert(siblings.at(i), i);
+    }
+    return m_rows.value(group, -1);
+}
+
+/**
+ * Whether the children of `group` are currently reported to views.
+ */
+bool GroupModel::isPopulated(const Group* group) const
+{
+    for (; group; group = group->parentGroup()) {
+        if (!m_fetchedGroups.contains(group)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Groups without children have nothing to fetch, so a visible empty group is
+ * populated right away to have its first child reported.
+ */
+void GroupModel::prepareInsert(Group* parentGroup)
+{
+    if (parentGroup->children().isEmpty()
+        && (!parentGroup->parentGroup() || isPopulated(parentGroup->parentGroup()))) {
+        m_fetchedGroups.insert(parentGroup);
+    }
+}
+
 QVariant GroupModel::data(const QModelIndex& index, int role) const
 {
     if (!index.isValid()) {
@@ -156,15 +267,7 @@ QVariant GroupModel::headerData(int section, Qt::Orientation orientation, int ro
 
 QModelIndex GroupModel::index(Group* group) const
 {
-    int row;
-
-    if (!group->parentGroup()) {
-        row = 0;
-    } else {
-        row = group->parentGroup()->children().indexOf(group);
-    }
-
-    return createIndex(row, 0, group);
+    return createIndex(row(group), 0, group);
 }
 
 Group* GroupModel::groupFromIndex(const QModelIndex& index) const
@@ -296,7 +399,7 @@ bool GroupModel::dropMimeData(const QMimeData* data,
             if (sourceDb != targetDb) {
                 QUuid customIcon = entry->iconUuid();
                 if (!customIcon.isNull() && !targetDb->metadata()->hasCustomIcon(customIcon)) {
-                    targetDb->metadata()->addCustomIcon(customIcon, sourceDb->metadata()->customIcon(customIcon));
+                    targetDb->metadata()->addCustomIcon(customIcon, sourceDb->metadata()->customIconData(customIcon));
                 }
 
                 // Reset the UUID when moving across db boundary
@@ -360,62 +463,192 @@ QMimeData* GroupModel::mimeData(const QModelIndexList& indexes) const
 
 void GroupModel::groupDataChanged(Group* group)
 {
+    if (deferToBatchUpdate()) {
+        return;
+    }
+
+    if (group->parentGroup() && !isPopulated(group->parentGroup())) {
+        return;
+    }
+
     QModelIndex ix = index(group);
     emit dataChanged(ix, ix);
 }
 
 void GroupModel::groupAboutToRemove(Group* group)
 {
+    if (deferToBatchUpdate()) {
+        return;
+    }
+
     Q_ASSERT(group->parentGroup());
 
+    m_fetchedGroups.remove(group);
+    if (!isPopulated(group->parentGroup())) {
+        m_pendingChange = PendingChange::None;
+        return;
+    }
+
     QModelIndex parentIndex = parent(group);
     Q_ASSERT(parentIndex.isValid());
-    int pos = group->parentGroup()->children().indexOf(group);
+    int pos = row(group);
     Q_ASSERT(pos != -1);
 
     beginRemoveRows(parentIndex, pos, pos);
+    m_pendingChange = PendingChange::Remove;
 }
 
 void GroupModel::groupRemoved()
 {
-    endRemoveRows();
+    if (deferToBatchUpdate()) {
+        return;
+    }
+
+    m_rows.clear();
+    if (m_pendingChange == PendingChange::Remove) {
+        endRemoveRows();
+    }
+    m_pendingChange = PendingChange::None;
 }
 
 void GroupModel::groupAboutToAdd(Group* group, int index)
 {
+    if (deferToBatchUpdate()) {
+        return;
+    }
+
     Q_ASSERT(group->parentGroup());
 
+    prepareInsert(group->parentGroup());
+    if (!isPopulated(group->parentGroup())) {
+        m_pendingChange = PendingChange::None;
+        return;
+    }
+
     QModelIndex parentIndex = parent(group);
 
     beginInsertRows(parentIndex, index, index);
+    m_pendingChange = PendingChange::Insert;
 }
 
 void GroupModel::groupAdded()
 {
-    endInsertRows();
+    if (deferToBatchUpdate()) {
+        return;
+    }
+
+    m_rows.clear();
+    if (m_pendingChange == PendingChange::Insert) {
+        endInsertRows();
+    }
+    m_pendingChange = PendingChange::None;
 }
 
 void GroupModel::groupAboutToMove(Group* group, Group* toGroup, int pos)
 {
+    if (deferToBatchUpdate()) {
+        return;
+    }
+
     Q_ASSERT(group->parentGroup());
 
+    // Only the ends of the move that views know about are reported
+    bool fromPopulated = isPopulated(group->parentGroup());
+    prepareInsert(toGroup);
+    bool toPopulated = isPopulated(toGroup);
+
     QModelIndex oldParentIndex = parent(group);
     QModelIndex newParentIndex = index(toGroup);
-    int oldPos = group->parentGroup()->children().indexOf(group);
-    if (group->parentGroup() == toGroup && pos > oldPos) {
-        // beginMoveRows() has a bit different semantics than Group::setParent() and
-        // QList::move() when the new position is greater than the old
-        pos++;
-    }
+    int oldPos = row(group);
+
+    if (fromPopulated && toPopulated) {
+        if (group->parentGroup() == toGroup && pos > oldPos) {
+            // beginMoveRows() has a bit different semantics than Group::setParent() and
+            // QList::move() when the new position is greater than the old
+            pos++;
+        }
 
-    bool moveResult = beginMoveRows(oldParentIndex, oldPos, oldPos, newParentIndex, pos);
-    Q_UNUSED(moveResult);
-    Q_ASSERT(moveResult);
+        bool moveResult = beginMoveRows(oldParentIndex, oldPos, oldPos, newParentIndex, pos);
+        Q_UNUSED(moveResult);
+        Q_ASSERT(moveResult);
+        m_pendingChange = PendingChange::Move;
+    } else if (fromPopulated) {
+        beginRemoveRows(oldParentIndex, oldPos, oldPos);
+        m_pendingChange = PendingChange::Remove;
+    } else if (toPopulated) {
+        beginInsertRows(newParentIndex, pos, pos);
+        m_pendingChange = PendingChange::Insert;
+    } else {
+        m_pendingChange = PendingChange::None;
+    }
 }
 
 void GroupModel::groupMoved()
 {
-    endMoveRows();
+    if (deferToBatchUpdate()) {
+        return;
+    }
+
+    m_rows.clear();
+    switch (m_pendingChange) {
+    case PendingChange::Move:
+        endMoveRows();
+        break;
+    case PendingChange::Remove:
+        endRemoveRows();
+        break;
+    case PendingChange::Insert:
+        endInsertRows();
+        break;
+    case PendingChange::None:
+        break;
+    }
+    m_pendingChange = PendingChange::None;
+}
+
+/**
+ * Changes made during a batch update of the database are not reported one by
+ * one; the model is reset once the batch is finished instead.
+ */
+void GroupModel::batchUpdateStarted()
+{
+    m_batchUpdating = true;
+}
+
+void GroupModel::batchUpdateFinished()
+{
+    if (!m_batchUpdating) {
+        return;
+    }
+
+    m_batchUpdating = false;
+    if (!m_batchResetBegun) {
+        return;
+    }
+
+    m_batchResetBegun = false;
+    m_fetchedGroups.clear();
+    m_rows.clear();
+    m_pendingChange = PendingChange::None;
+    endResetModel();
+}
+
+/**
+ * Returns whether a change is left to the reset at the end of the batch update.
+ * The reset begins with the first change, so that batches without any changes
+ * keep the views, and their selection, as they are.
+ */
+bool GroupModel::deferToBatchUpdate()
+{
+    if (!m_batchUpdating) {
+        return false;
+    }
+
+    if (!m_batchResetBegun) {
+        beginResetModel();
+        m_batchResetBegun = true;
+    }
+    return true;
 }
 
 void GroupModel::sortChildren(Group* rootGroup, bool reverse)
@@ -426,6 +659,7 @@ void GroupModel::sortChildren(Group* rootGroup, bool reverse)
     collectIndexesRecursively(oldIndexes, rootGroup->children());
 
     rootGroup->sortChildrenRecursively(reverse);
+    m_rows.clear();
 
     QList<QModelIndex> newIndexes;
     collectIndexesRecursively(newIndexes, rootGroup->children());
@@ -441,6 +675,9 @@ void GroupModel::collectIndexesRecursively(QList<QModelIndex>& indexes, QList<Gr
 {
     for (auto group : groups) {
         indexes.append(index(group));
-        collectIndexesRecursively(indexes, group->children());
+        // Groups that are not populated have no indexes in use
+        if (m_fetchedGroups.contains(group)) {
+            collectIndexesRecursively(indexes, group->children());
+        }
     }
 }
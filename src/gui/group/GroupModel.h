@@ -19,6 +19,8 @@
 #define KEEPASSX_GROUPMODEL_H
 
 #include <QAbstractItemModel>
+#include <QHash>
+#include <QSet>
 
 class Database;
 class Group;
@@ -32,8 +34,12 @@ public:
     void changeDatabase(Database* newDb);
     QModelIndex index(Group* group) const;
     Group* groupFromIndex(const QModelIndex& index) const;
+    void fetchParents(Group* group);
 
     int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex& parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex& parent) const override;
+    void fetchMore(const QModelIndex& parent) override;
     int columnCount(const QModelIndex& parent = QModelIndex()) const override;
     QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
     QModelIndex parent(const QModelIndex& index) const override;
@@ -48,7 +54,19 @@ public:
     void sortChildren(Group* rootGroup, bool reverse = false);
 
 private:
+    enum class PendingChange
+    {
+        None,
+        Insert,
+        Remove,
+        Move
+    };
+
     QModelIndex parent(Group* group) const;
+    int row(const Group* group) const;
+    bool isPopulated(const Group* group) const;
+    void prepareInsert(Group* parentGroup);
+    bool deferToBatchUpdate();
     void collectIndexesRecursively(QList<QModelIndex>& indexes, QList<Group*> groups);
 
 private slots:
@@ -59,9 +77,16 @@ private slots:
     void groupAdded();
     void groupAboutToMove(Group* group, Group* toGroup, int pos);
     void groupMoved();
+    void batchUpdateStarted();
+    void batchUpdateFinished();
 
 private:
     Database* m_db;
+    bool m_batchUpdating;
+    bool m_batchResetBegun;
+    PendingChange m_pendingChange;
+    QSet<const Group*> m_fetchedGroups;
+    mutable QHash<const Group*, int> m_rows;
 };
 
 #endif // KEEPASSX_GROUPMODEL_H
@@ -29,6 +29,7 @@ GroupView::GroupView(Database* db, QWidget* parent)
     : QTreeView(parent)
     , m_model(new GroupModel(db, this))
     , m_updatingExpanded(false)
+    , m_restoringGroup(false)
 {
     QTreeView::setModel(m_model);
     setHeaderHidden(true);
@@ -39,8 +40,9 @@ GroupView::GroupView(Database* db, QWidget* parent)
     connect(this, SIGNAL(collapsed(QModelIndex)), SLOT(expandedChanged(QModelIndex)));
     connect(this, SIGNAL(clicked(QModelIndex)), SIGNAL(groupSelectionChanged()));
     connect(m_model, SIGNAL(rowsInserted(QModelIndex,int,int)), SLOT(syncExpandedState(QModelIndex,int,int)));
+    connect(m_model, SIGNAL(modelAboutToBeReset()), SLOT(modelAboutToBeReset()));
     connect(m_model, SIGNAL(modelReset()), SLOT(modelReset()));
-    connect(selectionModel(), SIGNAL(currentChanged(QModelIndex,QModelIndex)), SIGNAL(groupSelectionChanged()));
+    connect(selectionModel(), SIGNAL(currentChanged(QModelIndex,QModelIndex)), SLOT(emitGroupChanged()));
     // clang-format on
 
     new QShortcut(Qt::CTRL + Qt::Key_F10, this, SLOT(contextMenuShortcutPressed()), nullptr, Qt::WidgetShortcut);
@@ -117,18 +119,28 @@ void GroupView::expandedChanged(const QModelIndex& index)
 
 void GroupView::recInitExpanded(Group* group)
 {
+    QModelIndex index = m_model->index(group);
+    bool expand = group->isExpanded();
+
+    // Children of collapsed groups are initialized once the model populates them
+    if (expand && m_model->canFetchMore(index)) {
+        // syncExpandedState() takes care of the children as they are inserted
+        m_model->fetchMore(index);
+    } else if (expand) {
+        const QList<Group*> children = group->children();
+        for (Group* child : children) {
+            recInitExpanded(child);
+        }
+    }
+
     m_updatingExpanded = true;
-    expandGroup(group, group->isExpanded());
+    setExpanded(index, expand);
     m_updatingExpanded = false;
-
-    const QList<Group*> children = group->children();
-    for (Group* child : children) {
-        recInitExpanded(child);
-    }
 }
 
 void GroupView::expandGroup(Group* group, bool expand)
 {
+    m_model->fetchParents(group);
     QModelIndex index = m_model->index(group);
     setExpanded(index, expand);
 }
@@ -160,12 +172,37 @@ void GroupView::setCurrentGroup(Group* group)
     if (group == nullptr) {
         setCurrentIndex(QModelIndex());
     } else {
+        m_model->fetchParents(group);
         setCurrentIndex(m_model->index(group));
     }
 }
 
+void GroupView::emitGroupChanged()
+{
+    if (!m_restoringGroup) {
+        emit groupSelectionChanged();
+    }
+}
+
+void GroupView::modelAboutToBeReset()
+{
+    m_groupBeforeReset = currentGroup();
+}
+
 void GroupView::modelReset()
 {
-    recInitExpanded(m_model->groupFromIndex(m_model->index(0, 0)));
-    setCurrentIndex(m_model->index(0, 0));
+    Group* rootGroup = m_model->groupFromIndex(m_model->index(0, 0));
+    recInitExpanded(rootGroup);
+
+    // Keep the selection when the same database is reloaded, e.g. after a merge
+    Group* group = m_groupBeforeReset.data();
+    m_groupBeforeReset.clear();
+    if (group && group->database() == rootGroup->database()) {
+        // The group did not change for the rest of the application, e.g. an active search stays
+        m_restoringGroup = true;
+        setCurrentGroup(group);
+        m_restoringGroup = false;
+    } else {
+        setCurrentIndex(m_model->index(0, 0));
+    }
 }
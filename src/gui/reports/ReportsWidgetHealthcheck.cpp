@@ -102,6 +102,8 @@ Health::Health(QSharedPointer<Database> db)
     : m_db(db)
     , m_checker(db)
 {
+    QList<QPair<Group*, Entry*>> candidates;
+    QList<const Entry*> entries;
     for (auto group : db->rootGroup()->groupsRecursive(true)) {
         // Skip recycle bin
         if (group->isRecycled()) {
@@ -118,16 +120,22 @@ Health::Health(QSharedPointer<Database> db)
                 continue;
             }
 
-            // Evaluate this entry
-            const auto item = QSharedPointer<Item>(new Item(group, entry, m_checker.evaluate(entry)));
-            if (item->exclude) {
-                m_anyKnownBad = true;
-            }
+            candidates.append({group, entry});
+            entries.append(entry);
+        }
+    }
 
-            // Add entry if its password isn't at least "good"
-            if (item->health->quality() < PasswordHealth::Quality::Good) {
-                m_items.append(item);
-            }
+    // Evaluate all entries at once
+    const auto results = m_checker.evaluate(entries);
+    for (int i = 0; i < candidates.size(); ++i) {
+        const auto item = QSharedPointer<Item>(new Item(candidates[i].first, candidates[i].second, results[i]));
+        if (item->exclude) {
+            m_anyKnownBad = true;
+        }
+
+        // Add entry if its password isn't at least "good"
+        if (item->health->quality() < PasswordHealth::Quality::Good) {
+            m_items.append(item);
         }
     }
 
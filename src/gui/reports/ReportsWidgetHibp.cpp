@@ -19,11 +19,17 @@
 #include "ui_ReportsWidgetHibp.h"
 
 #include "config-keepassx.h"
+#include "core/AsyncTask.h"
 #include "core/Group.h"
+#include "core/HibpOffline.h"
 #include "core/Metadata.h"
+#include "gui/FileDialog.h"
 #include "gui/GuiTools.h"
 #include "gui/Icons.h"
+#include "gui/MessageBox.h"
 
+#include <QCryptographicHash>
+#include <QFileInfo>
 #include <QMenu>
 #include <QShortcut>
 #include <QSortFilterProxyModel>
@@ -75,6 +81,7 @@ ReportsWidgetHibp::ReportsWidgetHibp(QWidget* parent)
 
     connect(m_ui->validationButton, &QPushButton::pressed, [this] { startValidation(); });
 #endif
+    connect(m_ui->offlineButton, &QPushButton::pressed, [this] { startOfflineValidation(); });
 
     new QShortcut(Qt::Key_Delete, this, SLOT(deleteSelectedEntries()));
 }
@@ -92,13 +99,14 @@ void ReportsWidgetHibp::loadSettings(QSharedPointer<Database> db)
     m_error.clear();
     m_rowToEntry.clear();
     m_editedEntry = nullptr;
-#ifdef WITH_XC_NETWORKING
     m_ui->stackedWidget->setCurrentIndex(0);
     m_ui->validationButton->setEnabled(true);
+    m_ui->offlineButton->setEnabled(true);
     m_ui->progressBar->hide();
-#else
-    // Compiled without networking, can't do anything
-    m_ui->stackedWidget->setCurrentIndex(2);
+#ifndef WITH_XC_NETWORKING
+    // Compiled without networking, only the offline analysis is available
+    m_ui->label->setText(m_ui->networkNoticeLabel->text());
+    m_ui->validationButton->hide();
 #endif
 }
 
@@ -274,6 +282,83 @@ void ReportsWidgetHibp::startValidation()
 #endif
 }
 
+/*
+ * Check the passwords against a downloaded HIBP file. Text files are
+ * converted into a sorted index next to them the first time, after which
+ * each lookup only needs a binary search.
+ */
+void ReportsWidgetHibp::startOfflineValidation()
+{
+    const auto filter = QString("%1 (*.txt *.kpxhibp);;%2 (*)").arg(tr("HIBP files"), tr("All files"));
+    const auto fileName = fileDialog()->getOpenFileName(this, tr("Select HIBP file"), QString(), filter);
+    if (fileName.isEmpty()) {
+        return;
+    }
+
+    auto indexPath = fileName;
+    bool createIndex = false;
+    if (!HibpOffline::isIndex(fileName)) {
+        const QFileInfo info(fileName);
+        indexPath = info.absolutePath() + "/" + info.completeBaseName() + ".kpxhibp";
+        if (!HibpOffline::isIndex(indexPath)) {
+            auto ans = MessageBox::question(this,
+                                            tr("Create HIBP index"),
+                                            tr("The selected file needs to be indexed once, the index will be saved "
+                                               "as %1. This may take a while, do you want to continue?")
+                                                .arg(indexPath),
+                                            MessageBox::Continue | MessageBox::Cancel,
+                                            MessageBox::Continue);
+            if (ans != MessageBox::Continue) {
+                return;
+            }
+            createIndex = true;
+        }
+    }
+
+    // Hash the passwords here, the lookup itself runs in the background
+    QHash<QByteArray, QString> passwords;
+    for (const auto* entry : m_db->rootGroup()->entriesRecursive()) {
+        if (!entry->isRecycled() && !entry->password().isEmpty()) {
+            const auto sha1 = QCryptographicHash::hash(entry->password().toUtf8(), QCryptographicHash::Sha1);
+            passwords.insert(sha1, entry->password());
+        }
+    }
+
+    m_ui->validationButton->setEnabled(false);
+    m_ui->offlineButton->setEnabled(false);
+    m_ui->progressBar->setRange(0, 0);
+    m_ui->progressBar->show();
+
+    const auto sha1s = passwords.keys();
+    AsyncTask::runThenCallback(
+        [fileName, indexPath, createIndex, sha1s] {
+            QPair<QHash<QByteArray, int>, QString> result;
+            if (createIndex) {
+                QFile hibpFile(fileName);
+                if (!hibpFile.open(QFile::ReadOnly)) {
+                    result.second = tr("Failed to open HIBP file %1: %2").arg(fileName, hibpFile.errorString());
+                    return result;
+                }
+                if (!HibpOffline::createIndex(hibpFile, indexPath, &result.second)) {
+                    return result;
+                }
+            }
+            QFile index(indexPath);
+            HibpOffline::lookup(index, sha1s, result.first, &result.second);
+            return result;
+        },
+        this,
+        [this, passwords](const QPair<QHash<QByteArray, int>, QString>& result) {
+            for (auto it = result.first.constBegin(); it != result.first.constEnd(); ++it) {
+                m_pwndPasswords[passwords.value(it.key())] = qMax(it.value(), 1);
+            }
+            m_error = result.second;
+            m_ui->progressBar->hide();
+            m_ui->progressBar->setRange(0, 100);
+            makeHibpTable();
+        });
+}
+
 /*
  * Convert the number of times a password has been pwned into
  * a display text for the third table column.
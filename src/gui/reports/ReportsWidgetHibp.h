@@ -62,6 +62,7 @@ public slots:
 
 private:
     void startValidation();
+    void startOfflineValidation();
     static QString countToText(int count);
 
     QScopedPointer<Ui::ReportsWidgetHibp> m_ui;
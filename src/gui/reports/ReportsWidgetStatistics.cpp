@@ -99,6 +99,7 @@ namespace
         void gatherStats(const QList<Group*>& groups)
         {
             auto checker = HealthChecker(m_db);
+            QList<const Entry*> candidates;
 
             for (const auto* group : groups) {
                 // Don't count anything in the recycle bin
@@ -134,8 +135,8 @@ namespace
                         }
 
                         // Speed up Zxcvbn process by excluding very long passwords and most passphrases
-                        if (pwd.size() < 25 && checker.evaluate(entry)->quality() <= PasswordHealth::Quality::Weak) {
-                            ++weakPasswords;
+                        if (pwd.size() < 25) {
+                            candidates.append(entry);
                         }
 
                         if (entry->excludeFromReports()) {
@@ -147,6 +148,12 @@ namespace
                     }
                 }
             }
+
+            for (const auto& health : checker.evaluate(candidates)) {
+                if (health->quality() <= PasswordHealth::Quality::Weak) {
+                    ++weakPasswords;
+                }
+            }
         }
     };
 } // namespace
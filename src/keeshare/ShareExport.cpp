@@ -81,7 +81,7 @@ namespace
             targetEntry->setUpdateTimeinfo(updateTimeinfoEntry);
             const auto iconUuid = targetEntry->iconUuid();
             if (!iconUuid.isNull() && !targetMetadata->hasCustomIcon(iconUuid)) {
-                targetMetadata->addCustomIcon(iconUuid, sourceEntry->icon());
+                targetMetadata->addCustomIcon(iconUuid, sourceDb->metadata()->customIconData(iconUuid));
             }
         }
 
@@ -107,12 +107,15 @@ namespace
         return targetDb;
     }
 
-    ShareObserver::Result
-    intoSignedContainer(const QString& resolvedPath, const KeeShareSettings::Reference& reference, Database* targetDb)
+    ShareObserver::Result intoSignedContainer(const QString& resolvedPath,
+                                              const KeeShareSettings::Reference& reference,
+                                              const KeeShareSettings::Own& own,
+                                              Database* targetDb)
     {
 #if !defined(WITH_XC_KEESHARE_SECURE)
         Q_UNUSED(targetDb);
         Q_UNUSED(resolvedPath);
+        Q_UNUSED(own);
         return {reference.path,
                 ShareObserver::Result::Warning,
                 ShareExport::tr("Overwriting signed share container is not supported - export prevented")};
@@ -128,7 +131,6 @@ namespace
                 return {reference.path, ShareObserver::Result::Error, writer.errorString()};
             }
         }
-        const auto own = KeeShare::own();
         QuaZip zip(resolvedPath);
         zip.setFileNameCodec("UTF-8");
         const bool zipOpened = zip.open(QuaZip::mdCreate);
@@ -217,14 +219,33 @@ namespace
 
 } // namespace
 
-ShareObserver::Result ShareExport::intoContainer(const QString& resolvedPath,
-                                                 const KeeShareSettings::Reference& reference,
-                                                 const Group* group)
+/**
+ * Build the database exported for the share of `group`. This reads the source
+ * database and has to be done on its thread, the result may be written by
+ * writeContainer() on another thread but must be released on this one.
+ */
+QSharedPointer<Database> ShareExport::extractDatabase(const KeeShareSettings::Reference& reference,
+                                                      const Group* group)
+{
+    QSharedPointer<Database> targetDb(extractIntoDatabase(reference, group));
+    // Writing transforms the key which marks the database as modified, keep
+    // that from starting the modified timer from the writing thread
+    targetDb->setEmitModified(false);
+    return targetDb;
+}
+
+/**
+ * Write an extracted share database into its container. Only touches
+ * `targetDb` and the container file, so shares can be written in parallel.
+ */
+ShareObserver::Result ShareExport::writeContainer(const QString& resolvedPath,
+                                                  const KeeShareSettings::Reference& reference,
+                                                  const KeeShareSettings::Own& own,
+                                                  Database* targetDb)
 {
-    QScopedPointer<Database> targetDb(extractIntoDatabase(reference, group));
     const QFileInfo info(resolvedPath);
     if (KeeShare::isContainerType(info, KeeShare::signedContainerFileType())) {
-        return intoSignedContainer(resolvedPath, reference, targetDb.data());
+        return intoSignedContainer(resolvedPath, reference, own, targetDb);
     }
-    return intoUnsignedContainer(resolvedPath, reference, targetDb.data());
+    return intoUnsignedContainer(resolvedPath, reference, targetDb);
 }
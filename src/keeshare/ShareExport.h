@@ -27,8 +27,11 @@ class ShareExport
 {
     Q_DECLARE_TR_FUNCTIONS(ShareExport)
 public:
-    static ShareObserver::Result
-    intoContainer(const QString& resolvedPath, const KeeShareSettings::Reference& reference, const Group* group);
+    static QSharedPointer<Database> extractDatabase(const KeeShareSettings::Reference& reference, const Group* group);
+    static ShareObserver::Result writeContainer(const QString& resolvedPath,
+                                                const KeeShareSettings::Reference& reference,
+                                                const KeeShareSettings::Own& own,
+                                                Database* targetDb);
 
 private:
     ShareExport() = delete;
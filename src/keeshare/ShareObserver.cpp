@@ -22,7 +22,9 @@
 #include "keeshare/ShareExport.h"
 #include "keeshare/ShareImport.h"
 
+#include <QCryptographicHash>
 #include <QDir>
+#include <QtConcurrent>
 
 namespace
 {
@@ -34,6 +36,66 @@ namespace
 
     constexpr int FileWatchPeriod = 30;
     constexpr int FileWatchSize = 5;
+
+    void addStamp(QCryptographicHash& hash, const QString& value)
+    {
+        const auto data = value.toUtf8();
+        hash.addData(QByteArray::number(data.size()) + ':' + data);
+    }
+
+    void addStamp(QCryptographicHash& hash, const QDateTime& time)
+    {
+        hash.addData(QByteArray::number(time.toMSecsSinceEpoch()) + ';');
+    }
+
+    /**
+     * Digest of everything the export of `group` is built from. Entries
+     * are tracked by their modification time, which every edit, merge and
+     * import updates, together with their history size to catch history
+     * maintenance. Referenced values can change anywhere in the database,
+     * so they are taken resolved.
+     */
+    QByteArray exportStamp(const KeeShareSettings::Reference& reference,
+                           const Group* group,
+                           const QString& signer)
+    {
+        QCryptographicHash hash(QCryptographicHash::Sha256);
+        addStamp(hash, KeeShareSettings::Reference::serialize(reference));
+        addStamp(hash, signer);
+
+        // Renamed, added, removed and moved subgroups change the exported tree as well
+        for (const auto* child : group->groupsRecursive(true)) {
+            hash.addData(child->uuid().toRfc4122());
+            if (child->parentGroup()) {
+                hash.addData(child->parentGroup()->uuid().toRfc4122());
+            }
+            addStamp(hash, child->name());
+            addStamp(hash, child->timeInfo().lastModificationTime());
+            addStamp(hash, child->timeInfo().locationChanged());
+        }
+
+        for (const auto* entry : group->entriesRecursive(false)) {
+            hash.addData(entry->uuid().toRfc4122());
+            hash.addData(entry->group()->uuid().toRfc4122());
+            addStamp(hash, entry->timeInfo().lastModificationTime());
+            addStamp(hash, entry->timeInfo().locationChanged());
+            hash.addData(QByteArray::number(entry->historyItems().size()) + ';');
+            if (entry->hasReferences()) {
+                for (const auto& attribute : EntryAttributes::DefaultAttributes) {
+                    addStamp(hash, entry->resolveMultiplePlaceholders(entry->attributes()->value(attribute)));
+                }
+            }
+        }
+
+        // All deletions of the database are pushed to every share
+        const auto& deletedObjects = group->database()->deletedObjects();
+        hash.addData(QByteArray::number(deletedObjects.size()) + ';');
+        if (!deletedObjects.isEmpty()) {
+            hash.addData(deletedObjects.last().uuid.toRfc4122());
+            addStamp(hash, deletedObjects.last().deletionTime);
+        }
+        return hash.result();
+    }
 } // End Namespace
 
 ShareObserver::ShareObserver(QSharedPointer<Database> db, QObject* parent)
@@ -61,6 +123,7 @@ void ShareObserver::deinitialize()
     m_groupToReference.clear();
     m_shareToGroup.clear();
     m_fileWatchers.clear();
+    m_exportStates.clear();
 }
 
 void ShareObserver::reinitialize()
@@ -277,18 +340,56 @@ QList<ShareObserver::Result> ShareObserver::exportShares()
         return results;
     }
 
+    struct Export
+    {
+        QString resolvedPath;
+        KeeShareSettings::Reference config;
+        QByteArray stamp;
+        QSharedPointer<Database> targetDb;
+        Result result;
+    };
+
+    // Only write the shares that changed since their last export, or whose
+    // container was replaced or removed in the meantime
+    const auto own = KeeShare::own();
+    const auto signer = own.certificate.fingerprint();
+    QList<Export> exports;
     for (auto it = references.cbegin(); it != references.cend(); ++it) {
         const auto& reference = it.value().first();
         const QString resolvedPath = resolvePath(reference.config.path, m_db);
+        const auto stamp = exportStamp(reference.config, reference.group, signer);
+        const QFileInfo info(resolvedPath);
+        const auto state = m_exportStates.value(resolvedPath);
+        if (state.stamp == stamp && info.exists() && info.lastModified() == state.lastModified) {
+            continue;
+        }
+
         auto watcher = m_fileWatchers.value(resolvedPath);
         if (watcher) {
             watcher->stop();
         }
+        // Extracting reads the database and has to stay on this thread
+        const auto targetDb = ShareExport::extractDatabase(reference.config, reference.group);
+        exports << Export{resolvedPath, reference.config, stamp, targetDb, Result()};
+    }
 
-        results << ShareExport::intoContainer(resolvedPath, reference.config, reference.group);
+    // Serializing, signing and writing the containers is independent per share
+    QtConcurrent::blockingMap(exports, [&own](Export& job) {
+        job.result = ShareExport::writeContainer(job.resolvedPath, job.config, own, job.targetDb.data());
+    });
+
+    for (auto& job : exports) {
+        job.targetDb.reset();
+        if (job.result.isError() || job.result.isWarning()) {
+            m_exportStates.remove(job.resolvedPath);
+        } else {
+            m_exportStates.insert(job.resolvedPath, {job.stamp, QFileInfo(job.resolvedPath).lastModified()});
+        }
+        results << job.result;
 
+        auto watcher = m_fileWatchers.value(job.resolvedPath);
         if (watcher) {
-            watcher->start(resolvedPath, FileWatchPeriod, FileWatchSize);
+            watcher->start(job.resolvedPath, FileWatchPeriod, FileWatchSize);
         }
     }
     return results;
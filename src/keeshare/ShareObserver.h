@@ -18,6 +18,8 @@
 #ifndef KEEPASSXC_SHAREOBSERVER_H
 #define KEEPASSXC_SHAREOBSERVER_H
 
+#include <QDateTime>
+#include <QHash>
 #include <QMap>
 #include <QObject>
 
@@ -77,10 +79,18 @@ private:
     void notifyAbout(const QStringList& success, const QStringList& warning, const QStringList& error);
 
 private:
+    // Content of the last successful export to a container
+    struct ExportState
+    {
+        QByteArray stamp;
+        QDateTime lastModified;
+    };
+
     QSharedPointer<Database> m_db;
     QMap<QPointer<Group>, KeeShareSettings::Reference> m_groupToReference;
     QMap<QString, QPointer<Group>> m_shareToGroup;
     QMap<QString, QSharedPointer<FileWatcher>> m_fileWatchers;
+    QHash<QString, ExportState> m_exportStates;
     bool m_inFileUpdate = false;
 };
 
@@ -53,34 +53,31 @@ void NativeMessagingProxy::setupStandardInput()
     setmode(fileno(stdout), _O_BINARY);
 #endif
 
+    // Block on stdin in a worker thread, each message is prefixed with its size in native byte order
     QtConcurrent::run([this] {
-        while (std::cin.good()) {
-            if (std::cin.peek() != EOF) {
-                uint length = 0;
-                for (uint i = 0; i < sizeof(uint); ++i) {
-                    length |= getchar() << (i * 8);
-                }
-
-                QString msg;
-                msg.reserve(length);
-                for (uint i = 0; i < length; ++i) {
-                    msg.append(getchar());
-                }
-
-                if (msg.length() > 0) {
-                    emit stdinMessage(msg);
-                }
+        quint32 length = 0;
+        while (std::cin.read(reinterpret_cast<char*>(&length), sizeof(length))) {
+            if (length > static_cast<quint32>(BrowserShared::NATIVEMSG_MAX_LENGTH)) {
+                break;
+            }
+
+            QByteArray msg(static_cast<int>(length), Qt::Uninitialized);
+            if (!std::cin.read(msg.data(), length)) {
+                break;
+            }
+
+            if (!msg.isEmpty()) {
+                emit stdinMessage(msg);
             }
-            QThread::msleep(100);
         }
         QCoreApplication::quit();
     });
 }
 
-void NativeMessagingProxy::transferStdinMessage(const QString& msg)
+void NativeMessagingProxy::transferStdinMessage(const QByteArray& msg)
 {
     if (m_localSocket && m_localSocket->state() == QLocalSocket::ConnectedState) {
-        m_localSocket->write(msg.toUtf8(), msg.length());
+        m_localSocket->write(BrowserShared::frameMessage(msg));
         m_localSocket->flush();
     }
 }
@@ -102,14 +99,21 @@ void NativeMessagingProxy::setupLocalSocket()
 
 void NativeMessagingProxy::transferSocketMessage()
 {
-    auto msg = m_localSocket->readAll();
-    if (!msg.isEmpty()) {
-        // Explicitly write the message length as 1 byte chunks
-        uint len = msg.size();
+    // Replies can arrive split over several reads or coalesced into one
+    m_socketBuffer.append(m_localSocket->readAll());
+
+    QByteArray msg;
+    bool written = false;
+    while (BrowserShared::takeFrame(m_socketBuffer, msg)) {
+        // Native messaging expects the size in native byte order
+        quint32 len = msg.size();
         std::cout.write(reinterpret_cast<char*>(&len), sizeof(len));
+        std::cout.write(msg.constData(), msg.size());
+        written = true;
+    }
 
-        // Write the message and flush the stream
-        std::cout << msg.toStdString() << std::flush;
+    if (written) {
+        std::cout.flush();
     }
 }
 
@@ -31,11 +31,11 @@ public:
     ~NativeMessagingProxy() override = default;
 
 signals:
-    void stdinMessage(QString msg);
+    void stdinMessage(QByteArray msg);
 
 public slots:
     void transferSocketMessage();
-    void transferStdinMessage(const QString& msg);
+    void transferStdinMessage(const QByteArray& msg);
     void socketDisconnected();
 
 private:
@@ -44,6 +44,7 @@ private:
 
 private:
     QScopedPointer<QLocalSocket> m_localSocket;
+    QByteArray m_socketBuffer;
 
     Q_DISABLE_COPY(NativeMessagingProxy)
 };
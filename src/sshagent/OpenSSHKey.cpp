@@ -20,12 +20,52 @@
 
 #include "ASN1Key.h"
 #include "BinaryStream.h"
+#include "crypto/Random.h"
 #include "crypto/SymmetricCipher.h"
 
+#include <QCache>
+#include <QMutex>
 #include <QRegularExpression>
 #include <QStringList>
 
+#include <botan/mac.h>
 #include <botan/pwdhash.h>
+#include <botan/secmem.h>
+
+namespace
+{
+    // Derived bcrypt keys by a digest of the KDF inputs. Unlocking a database again
+    // reuses them instead of running the KDF for every encrypted key. The salt is
+    // unique per key file, so re-encrypting a key or changing its passphrase misses.
+    constexpr int MaxKeyDerivationCacheSize = 1024;
+
+    QMutex s_keyDerivationMutex;
+
+    QCache<QByteArray, Botan::secure_vector<uint8_t>>& keyDerivationCache()
+    {
+        static QCache<QByteArray, Botan::secure_vector<uint8_t>> cache(MaxKeyDerivationCacheSize);
+        return cache;
+    }
+
+    /*
+     * Identify the KDF inputs by a MAC keyed with a random per-process secret.
+     * A plain hash of the passphrase and the public salt would let anyone with
+     * a memory dump guess the passphrase without paying for bcrypt.
+     */
+    QByteArray keyDerivationCacheKey(const QByteArray& passphrase, const QByteArray& salt, quint32 rounds, int size)
+    {
+        static const Botan::secure_vector<uint8_t> secret = randomGen()->getRng()->random_vec(32);
+
+        auto mac = Botan::MessageAuthenticationCode::create_or_throw("HMAC(SHA-256)");
+        mac->set_key(secret);
+        const auto parameters = QByteArray::number(salt.size()) + ':' + salt + QByteArray::number(rounds) + ':'
+                                + QByteArray::number(size) + ':';
+        mac->update(reinterpret_cast<const uint8_t*>(parameters.constData()), parameters.size());
+        mac->update(reinterpret_cast<const uint8_t*>(passphrase.constData()), passphrase.size());
+        const auto digest = mac->final();
+        return QByteArray(reinterpret_cast<const char*>(digest.data()), static_cast<int>(digest.size()));
+    }
+} // namespace
 
 const QString OpenSSHKey::TYPE_DSA_PRIVATE = "DSA PRIVATE KEY";
 const QString OpenSSHKey::TYPE_RSA_PRIVATE = "RSA PRIVATE KEY";
@@ -300,6 +340,15 @@ bool OpenSSHKey::encrypted() const
     return (m_cipherName != "none");
 }
 
+/**
+ * Forget the keys derived from passphrases of encrypted keys.
+ */
+void OpenSSHKey::clearKeyDerivationCache()
+{
+    QMutexLocker locker(&s_keyDerivationMutex);
+    keyDerivationCache().clear();
+}
+
 bool OpenSSHKey::openKey(const QString& passphrase)
 {
     QScopedPointer<SymmetricCipher> cipher(new SymmetricCipher());
@@ -342,18 +391,33 @@ bool OpenSSHKey::openKey(const QString& passphrase)
             optionStream.read(rounds);
 
             QByteArray decryptKey(keySize + blockSize, '\0');
-            try {
-                auto baPass = passphrase.toUtf8();
-                auto pwhash = Botan::PasswordHashFamily::create_or_throw("Bcrypt-PBKDF")->from_iterations(rounds);
-                pwhash->derive_key(reinterpret_cast<uint8_t*>(decryptKey.data()),
-                                   decryptKey.size(),
-                                   baPass.constData(),
-                                   baPass.size(),
-                                   reinterpret_cast<const uint8_t*>(salt.constData()),
-                                   salt.size());
-            } catch (std::exception& e) {
-                m_error = tr("Key derivation failed: %1").arg(e.what());
-                return false;
+            auto baPass = passphrase.toUtf8();
+            auto cacheKey = keyDerivationCacheKey(baPass, salt, rounds, decryptKey.size());
+
+            QMutexLocker locker(&s_keyDerivationMutex);
+            auto cached = keyDerivationCache().object(cacheKey);
+            if (cached) {
+                std::copy(cached->begin(), cached->end(), decryptKey.begin());
+            }
+            locker.unlock();
+
+            if (!cached) {
+                try {
+                    auto pwhash = Botan::PasswordHashFamily::create_or_throw("Bcrypt-PBKDF")->from_iterations(rounds);
+                    pwhash->derive_key(reinterpret_cast<uint8_t*>(decryptKey.data()),
+                                       decryptKey.size(),
+                                       baPass.constData(),
+                                       baPass.size(),
+                                       reinterpret_cast<const uint8_t*>(salt.constData()),
+                                       salt.size());
+                } catch (std::exception& e) {
+                    m_error = tr("Key derivation failed: %1").arg(e.what());
+                    return false;
+                }
+
+                locker.relock();
+                keyDerivationCache().insert(
+                    cacheKey, new Botan::secure_vector<uint8_t>(decryptKey.constBegin(), decryptKey.constEnd()));
             }
 
             keyData = decryptKey.left(keySize);
@@ -50,6 +50,8 @@ public:
 
     void clearPrivate();
 
+    static void clearKeyDerivationCache();
+
     bool readPublic(BinaryStream& stream);
     bool readPrivate(BinaryStream& stream);
     bool writePublic(BinaryStream& stream);
@@ -19,6 +19,7 @@
 #include "SSHAgent.h"
 
 #include "core/Config.h"
+#include "core/Global.h"
 #include "core/Group.h"
 #include "core/Metadata.h"
 #include "sshagent/BinaryStream.h"
@@ -35,6 +36,10 @@
 
 Q_GLOBAL_STATIC(SSHAgent, s_sshAgent);
 
+SSHAgent::SSHAgent() = default;
+
+SSHAgent::~SSHAgent() = default;
+
 SSHAgent* SSHAgent::instance()
 {
     return s_sshAgent;
@@ -49,6 +54,8 @@ void SSHAgent::setEnabled(bool enabled)
 {
     if (isEnabled() && !enabled) {
         removeAllIdentities();
+        disconnectAgent();
+        OpenSSHKey::clearKeyDerivationCache();
     }
 
     config()->set(Config::SSHAgent_Enabled, enabled);
@@ -64,6 +71,7 @@ QString SSHAgent::authSockOverride() const
 void SSHAgent::setAuthSockOverride(QString& authSockOverride)
 {
     config()->set(Config::SSHAgent_AuthSockOverride, authSockOverride);
+    disconnectAgent();
 }
 
 #ifdef Q_OS_WIN
@@ -120,34 +128,118 @@ bool SSHAgent::isAgentRunning() const
 
 bool SSHAgent::sendMessage(const QByteArray& in, QByteArray& out)
 {
+    QList<QByteArray> replies;
+    if (!sendMessages({in}, replies)) {
+        return false;
+    }
+
+    out = replies.first();
+    return true;
+}
+
+/**
+ * Send several requests to the agent at once and read their replies.
+ * The connection to the agent is kept open for later requests.
+ *
+ * @param in requests
+ * @param out replies, in the order of the requests
+ * @return true on success
+ */
+bool SSHAgent::sendMessages(const QList<QByteArray>& in, QList<QByteArray>& out)
+{
+    out.clear();
+
 #ifdef Q_OS_WIN
     if (!useOpenSSH()) {
-        return sendMessagePageant(in, out);
+        for (const auto& message : in) {
+            QByteArray reply;
+            if (!sendMessagePageant(message, reply)) {
+                return false;
+            }
+            out.append(reply);
+        }
+        return true;
     }
 #endif
 
-    QLocalSocket socket;
-    BinaryStream stream(&socket);
+    // The agent may have closed a connection kept from earlier requests,
+    // retry once with a new connection in that case.
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        bool reused = isConnected();
+        if (!reused && !connectAgent()) {
+            return false;
+        }
 
-    socket.connectToServer(socketPath());
-    if (!socket.waitForConnected(500)) {
-        m_error = tr("Agent connection failed.");
-        return false;
+        if (exchangeMessages(in, out)) {
+            return true;
+        }
+
+        disconnectAgent();
+        if (!reused) {
+            break;
+        }
     }
 
-    stream.writeString(in);
+    return false;
+}
+
+bool SSHAgent::exchangeMessages(const QList<QByteArray>& in, QList<QByteArray>& out)
+{
+    BinaryStream stream(m_socket.data());
+
+    // the agent answers the requests of a connection in order, write them all before reading
+    for (const auto& message : in) {
+        if (!stream.writeString(message)) {
+            m_error = tr("Agent protocol error.");
+            return false;
+        }
+    }
     stream.flush();
 
-    if (!stream.readString(out)) {
-        m_error = tr("Agent protocol error.");
-        return false;
+    out.clear();
+    for (int i = 0; i < in.size(); ++i) {
+        QByteArray reply;
+        if (!stream.readString(reply)) {
+            out.clear();
+            m_error = tr("Agent protocol error.");
+            return false;
+        }
+        out.append(reply);
     }
 
-    socket.close();
+    return true;
+}
+
+bool SSHAgent::isConnected() const
+{
+    return m_socket && m_socket->state() == QLocalSocket::ConnectedState && m_socketPath == socketPath();
+}
+
+bool SSHAgent::connectAgent()
+{
+    disconnectAgent();
+
+    m_socketPath = socketPath();
+    m_socket.reset(new QLocalSocket());
+    m_socket->connectToServer(m_socketPath);
+    if (!m_socket->waitForConnected(500)) {
+        m_socket.reset();
+        m_error = tr("Agent connection failed.");
+        return false;
+    }
 
     return true;
 }
 
+void SSHAgent::disconnectAgent()
+{
+    if (m_socket) {
+        m_socket->abort();
+        m_socket.reset();
+    }
+    m_identitiesAge.invalidate();
+}
+
 #ifdef Q_OS_WIN
 bool SSHAgent::sendMessagePageant(const QByteArray& in, QByteArray& out)
 {
@@ -233,6 +325,18 @@ bool SSHAgent::addIdentity(OpenSSHKey& key, const KeeAgentSettings& settings, co
         return false;
     }
 
+    m_identitiesAge.invalidate();
+
+    QByteArray responseData;
+    if (!sendMessage(addIdentityRequest(key, settings), responseData)) {
+        return false;
+    }
+
+    return addIdentityReply(responseData, key, settings, databaseUuid);
+}
+
+QByteArray SSHAgent::addIdentityRequest(OpenSSHKey& key, const KeeAgentSettings& settings) const
+{
     QByteArray requestData;
     BinaryStream request(&requestData);
 
@@ -250,12 +354,15 @@ bool SSHAgent::addIdentity(OpenSSHKey& key, const KeeAgentSettings& settings, co
         request.write(SSH_AGENT_CONSTRAIN_CONFIRM);
     }
 
-    QByteArray responseData;
-    if (!sendMessage(requestData, responseData)) {
-        return false;
-    }
+    return requestData;
+}
 
-    if (responseData.length() < 1 || static_cast<quint8>(responseData[0]) != SSH_AGENT_SUCCESS) {
+bool SSHAgent::addIdentityReply(const QByteArray& reply,
+                                const OpenSSHKey& key,
+                                const KeeAgentSettings& settings,
+                                const QUuid& databaseUuid)
+{
+    if (reply.length() < 1 || static_cast<quint8>(reply[0]) != SSH_AGENT_SUCCESS) {
         m_error =
             tr("Agent refused this identity. Possible reasons include:") + "\n" + tr("The key has already been added.");
 
@@ -283,24 +390,41 @@ bool SSHAgent::addIdentity(OpenSSHKey& key, const KeeAgentSettings& settings, co
  * @return true on success
  */
 bool SSHAgent::removeIdentity(OpenSSHKey& key)
+{
+    return removeIdentities({key});
+}
+
+/**
+ * Remove several identities from the SSH agent in one go.
+ *
+ * @param keys identities to remove
+ * @return true on success
+ */
+bool SSHAgent::removeIdentities(QList<OpenSSHKey> keys)
 {
     if (!isAgentRunning()) {
         m_error = tr("No agent running, cannot remove identity.");
         return false;
     }
 
-    QByteArray requestData;
-    BinaryStream request(&requestData);
+    m_identitiesAge.invalidate();
 
-    QByteArray keyData;
-    BinaryStream keyStream(&keyData);
-    key.writePublic(keyStream);
+    QList<QByteArray> requests;
+    for (auto& key : keys) {
+        QByteArray requestData;
+        BinaryStream request(&requestData);
 
-    request.write(SSH_AGENTC_REMOVE_IDENTITY);
-    request.writeString(keyData);
+        QByteArray keyData;
+        BinaryStream keyStream(&keyData);
+        key.writePublic(keyStream);
 
-    QByteArray responseData;
-    return sendMessage(requestData, responseData);
+        request.write(SSH_AGENTC_REMOVE_IDENTITY);
+        request.writeString(keyData);
+        requests.append(requestData);
+    }
+
+    QList<QByteArray> responses;
+    return sendMessages(requests, responses);
 }
 
 /**
@@ -378,15 +502,20 @@ bool SSHAgent::listIdentities(QList<QSharedPointer<OpenSSHKey>>& list)
  */
 bool SSHAgent::checkIdentity(const OpenSSHKey& key, bool& loaded)
 {
-    QList<QSharedPointer<OpenSSHKey>> list;
-
-    if (!listIdentities(list)) {
-        return false;
+    // keys can expire or be removed by other clients, so the list is only reused for a short time
+    if (!m_identitiesAge.isValid() || m_identitiesAge.hasExpired(IDENTITIES_CACHE_MSEC)) {
+        QList<QSharedPointer<OpenSSHKey>> list;
+        if (!listIdentities(list)) {
+            m_identitiesAge.invalidate();
+            return false;
+        }
+        m_identities = list;
+        m_identitiesAge.start();
     }
 
     loaded = false;
 
-    for (const auto& it : list) {
+    for (const auto& it : asConst(m_identities)) {
         if (*it == key) {
             loaded = true;
             break;
@@ -401,15 +530,19 @@ bool SSHAgent::checkIdentity(const OpenSSHKey& key, bool& loaded)
  */
 void SSHAgent::removeAllIdentities()
 {
+    QList<OpenSSHKey> keys;
     auto it = m_addedKeys.begin();
     while (it != m_addedKeys.end()) {
         // Remove key if requested to remove on lock
         if (it.value().second) {
-            OpenSSHKey key = it.key();
-            removeIdentity(key);
+            keys.append(it.key());
         }
         it = m_addedKeys.erase(it);
     }
+
+    if (!keys.isEmpty()) {
+        removeIdentities(keys);
+    }
 }
 
 /**
@@ -432,20 +565,22 @@ void SSHAgent::databaseLocked(QSharedPointer<Database> db)
         return;
     }
 
+    QList<OpenSSHKey> keys;
     auto it = m_addedKeys.begin();
     while (it != m_addedKeys.end()) {
         if (it.value().first != db->uuid()) {
             ++it;
             continue;
         }
-        OpenSSHKey key = it.key();
         if (it.value().second) {
-            if (!removeIdentity(key)) {
-                emit error(m_error);
-            }
+            keys.append(it.key());
         }
         it = m_addedKeys.erase(it);
     }
+
+    if (!keys.isEmpty() && !removeIdentities(keys)) {
+        emit error(m_error);
+    }
 }
 
 void SSHAgent::databaseUnlocked(QSharedPointer<Database> db)
@@ -454,6 +589,10 @@ void SSHAgent::databaseUnlocked(QSharedPointer<Database> db)
         return;
     }
 
+    QList<OpenSSHKey> keys;
+    QList<KeeAgentSettings> keySettings;
+    QList<QByteArray> requests;
+
     for (Entry* e : db->rootGroup()->entriesRecursive()) {
         if (db->metadata()->recycleBinEnabled() && e->group() == db->metadata()->recycleBin()) {
             continue;
@@ -475,9 +614,37 @@ void SSHAgent::databaseUnlocked(QSharedPointer<Database> db)
             continue;
         }
 
-        // Add key to agent; ignore errors if we have previously added the key
-        bool known_key = m_addedKeys.contains(key);
-        if (!addIdentity(key, settings, db->uuid()) && !known_key) {
+        // Keys owned by another database are not added, like in addIdentity()
+        if (m_addedKeys.contains(key) && m_addedKeys[key].first != db->uuid()) {
+            continue;
+        }
+
+        requests.append(addIdentityRequest(key, settings));
+        keys.append(key);
+        keySettings.append(settings);
+    }
+
+    if (keys.isEmpty()) {
+        return;
+    }
+
+    if (!isAgentRunning()) {
+        emit error(tr("No agent running, cannot add identity."));
+        return;
+    }
+
+    // Add all keys in one batch instead of a round trip per key
+    m_identitiesAge.invalidate();
+    QList<QByteArray> responses;
+    if (!sendMessages(requests, responses)) {
+        emit error(m_error);
+        return;
+    }
+
+    for (int i = 0; i < keys.size(); ++i) {
+        // Ignore errors if we have previously added the key
+        bool known_key = m_addedKeys.contains(keys.at(i));
+        if (!addIdentityReply(responses.at(i), keys.at(i), keySettings.at(i), db->uuid()) && !known_key) {
             emit error(m_error);
         }
     }
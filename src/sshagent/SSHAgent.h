@@ -19,19 +19,23 @@
 #ifndef KEEPASSXC_SSHAGENT_H
 #define KEEPASSXC_SSHAGENT_H
 
+#include <QElapsedTimer>
 #include <QHash>
+#include <QScopedPointer>
 
 #include "OpenSSHKey.h"
 
 class KeeAgentSettings;
 class Database;
+class QLocalSocket;
 
 class SSHAgent : public QObject
 {
     Q_OBJECT
 
 public:
-    ~SSHAgent() override = default;
+    SSHAgent();
+    ~SSHAgent() override;
     static SSHAgent* instance();
 
     bool isEnabled() const;
@@ -73,7 +77,22 @@ private:
     const quint8 SSH_AGENT_CONSTRAIN_LIFETIME = 1;
     const quint8 SSH_AGENT_CONSTRAIN_CONFIRM = 2;
 
+    // how long checkIdentity() trusts the last identity list of the agent
+    const qint64 IDENTITIES_CACHE_MSEC = 1000;
+
     bool sendMessage(const QByteArray& in, QByteArray& out);
+    bool sendMessages(const QList<QByteArray>& in, QList<QByteArray>& out);
+    bool exchangeMessages(const QList<QByteArray>& in, QList<QByteArray>& out);
+    bool isConnected() const;
+    bool connectAgent();
+    void disconnectAgent();
+
+    QByteArray addIdentityRequest(OpenSSHKey& key, const KeeAgentSettings& settings) const;
+    bool addIdentityReply(const QByteArray& reply,
+                          const OpenSSHKey& key,
+                          const KeeAgentSettings& settings,
+                          const QUuid& databaseUuid);
+    bool removeIdentities(QList<OpenSSHKey> keys);
 #ifdef Q_OS_WIN
     bool sendMessagePageant(const QByteArray& in, QByteArray& out);
 
@@ -83,6 +102,13 @@ private:
 
     QHash<OpenSSHKey, QPair<QUuid, bool>> m_addedKeys;
     QString m_error;
+
+    // connection kept open between requests
+    QScopedPointer<QLocalSocket> m_socket;
+    QString m_socketPath;
+
+    QList<QSharedPointer<OpenSSHKey>> m_identities;
+    QElapsedTimer m_identitiesAge;
 };
 
 static inline SSHAgent* sshAgent()
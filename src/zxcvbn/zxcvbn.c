@@ -159,20 +159,118 @@ static int Cardinality(const uint8_t *Str, int Len)
 }
 
 /**********************************************************************************
- * Allocate a ZxcMatch_t struct, clear it to zero
+ * Match arena. Holds the ZxcMatch_t structs of one password evaluation in blocks
+ * that are kept for the next evaluation, instead of allocating every match from
+ * the heap. Matches discarded during an evaluation are put on a free list.
  */
-static ZxcMatch_t *AllocMatch()
+#define ARENA_BLOCK_MATCHES 256
+
+typedef struct ZxcArenaBlock
+{
+    struct ZxcArenaBlock *Next;
+    ZxcMatch_t Matches[ARENA_BLOCK_MATCHES];
+} ZxcArenaBlock_t;
+
+struct ZxcArena
 {
-    ZxcMatch_t *p = MallocFn(ZxcMatch_t, 1);
+    ZxcArenaBlock_t *Blocks;    /* All blocks, used in list order */
+    ZxcArenaBlock_t *Current;   /* Block matches are currently taken from */
+    int              Used;      /* Number of matches taken from the current block */
+    ZxcMatch_t      *Free;      /* Matches discarded during the current evaluation */
+};
+
+ZxcArena_t *ZxcvbnNewArena(void)
+{
+    ZxcArena_t *Arena = MallocFn(ZxcArena_t, 1);
+    Arena->Blocks = MallocFn(ZxcArenaBlock_t, 1);
+    Arena->Blocks->Next = 0;
+    Arena->Current = Arena->Blocks;
+    Arena->Used = 0;
+    Arena->Free = 0;
+    return Arena;
+}
+
+void ZxcvbnFreeArena(ZxcArena_t *Arena)
+{
+    ZxcArenaBlock_t *b;
+    if (!Arena)
+        return;
+    while(Arena->Blocks)
+    {
+        b = Arena->Blocks->Next;
+        FreeFn(Arena->Blocks);
+        Arena->Blocks = b;
+    }
+    FreeFn(Arena);
+}
+
+/**********************************************************************************
+ * Make all matches of the arena available again.
+ */
+static void ResetArena(ZxcArena_t *Arena)
+{
+    Arena->Current = Arena->Blocks;
+    Arena->Used = 0;
+    Arena->Free = 0;
+}
+
+/**********************************************************************************
+ * Allocate a ZxcMatch_t struct, clear it to zero. Taken from the heap if Arena is
+ * null, otherwise from the arena.
+ */
+static ZxcMatch_t *AllocMatch(ZxcArena_t *Arena)
+{
+    ZxcMatch_t *p;
+    if (!Arena)
+    {
+        p = MallocFn(ZxcMatch_t, 1);
+    }
+    else if (Arena->Free)
+    {
+        p = Arena->Free;
+        Arena->Free = p->Next;
+    }
+    else
+    {
+        if (Arena->Used >= ARENA_BLOCK_MATCHES)
+        {
+            /* Current block is full, move to the next one and add it if needed */
+            if (!Arena->Current->Next)
+            {
+                ZxcArenaBlock_t *b = MallocFn(ZxcArenaBlock_t, 1);
+                b->Next = 0;
+                Arena->Current->Next = b;
+            }
+            Arena->Current = Arena->Current->Next;
+            Arena->Used = 0;
+        }
+        p = Arena->Current->Matches + Arena->Used++;
+    }
     memset(p, 0, sizeof *p);
     return p;
 }
 
+/**********************************************************************************
+ * Release a ZxcMatch_t struct allocated by AllocMatch(Arena).
+ */
+static void FreeMatch(ZxcArena_t *Arena, ZxcMatch_t *p)
+{
+    if (!Arena)
+    {
+        FreeFn(p);
+    }
+    else
+    {
+        p->Next = Arena->Free;
+        Arena->Free = p;
+    }
+}
+
 /**********************************************************************************
  * Add new match struct to linked list of matches. List ordered with shortest at
  * head of list. Note: passed new match struct in parameter Nu may be de allocated.
  */
-static void AddResult(ZxcMatch_t **HeadRef, ZxcMatch_t *Nu, int MaxLen)
+static void AddResult(ZxcArena_t *Arena, ZxcMatch_t **HeadRef, ZxcMatch_t *Nu, int MaxLen)
 {
     /* Adjust the entropy to be used for calculations depending on whether the passed match is
      * at the begining, middle or end of the password
@@ -198,13 +296,13 @@ static void AddResult(ZxcMatch_t **HeadRef, ZxcMatch_t *Nu, int MaxLen)
         if ((*HeadRef)->MltEnpy <= Nu->MltEnpy)
         {
             /* Existing entry has lower entropy - keep it, discard new entry */
-            FreeFn(Nu);
+            FreeMatch(Arena, Nu);
         }
         else
         {
             /* New entry has lower entropy - replace existing entry */
             Nu->Next = (*HeadRef)->Next;
-            FreeFn(*HeadRef);
+            FreeMatch(Arena, *HeadRef);
             *HeadRef = Nu;
         }
     }
@@ -219,7 +317,7 @@ static void AddResult(ZxcMatch_t **HeadRef, ZxcMatch_t *Nu, int MaxLen)
 /**********************************************************************************
  * See if the match is repeated. If it is then add a new repeated match to the results.
  */
-static void AddMatchRepeats(ZxcMatch_t **Result, ZxcMatch_t *Match, const uint8_t *Passwd, int MaxLen)
+static void AddMatchRepeats(ZxcArena_t *Arena, ZxcMatch_t **Result, ZxcMatch_t *Match, const uint8_t *Passwd, int MaxLen)
 {
     int Len = Match->Length;
     const uint8_t *Rpt = Passwd + Len;
@@ -230,12 +328,12 @@ static void AddMatchRepeats(ZxcMatch_t **Result, ZxcMatch_t *Match, const uint8_
         if (strncmp((const char *)Passwd, (const char *)Rpt, Len) == 0)
         {
             /* Found a repeat */
-            ZxcMatch_t *p = AllocMatch();
+            ZxcMatch_t *p = AllocMatch(Arena);
             p->Entrpy = Match->Entrpy + log(RepeatCount);
             p->Type = (ZxcTypeMatch_t)(Match->Type + MULTIPLE_MATCH);
             p->Length = Len * RepeatCount;
             p->Begin = Match->Begin;
-            AddResult(Result, p, MaxLen);
+            AddResult(Arena, Result, p, MaxLen);
         }
         else
             break;
@@ -622,7 +720,7 @@ static void DictionaryEntropy(ZxcMatch_t *m, DictMatchInfo_t *Extra, const uint8
 /**********************************************************************************
  * Function that does the word matching
  */
-static void DoDictMatch(const uint8_t *Passwd, int Start, int MaxLen, DictWork_t *Wrk, ZxcMatch_t **Result, DictMatchInfo_t *Extra, int Lev)
+static void DoDictMatch(ZxcArena_t *Arena, const uint8_t *Passwd, int Start, int MaxLen, DictWork_t *Wrk, ZxcMatch_t **Result, DictMatchInfo_t *Extra, int Lev)
 {
     int Len;
     uint8_t TempLeet[LEET_NORM_MAP_SIZE];
@@ -699,7 +797,7 @@ static void DoDictMatch(const uint8_t *Passwd, int Start, int MaxLen, DictWork_t
                             w.LeetCnv[i] = *r;
                             AddLeetChr(*r, -1, w.Leeted, w.UnLeet);
                         }
-                        DoDictMatch(Pwd, Passwd - Pwd, MaxLen - Len, &w, Result, Extra, Lev+1);
+                        DoDictMatch(Arena, Pwd, Passwd - Pwd, MaxLen - Len, &w, Result, Extra, Lev+1);
                     }
                 }
                 return;
@@ -753,7 +851,7 @@ static void DoDictMatch(const uint8_t *Passwd, int Start, int MaxLen, DictWork_t
             memcpy(Extra->UnLeet, Wrk->UnLeet, sizeof Extra->UnLeet);
             memcpy(Extra->Leeted, Wrk->Leeted, sizeof Extra->Leeted);
 
-            p = AllocMatch();
+            p = AllocMatch(Arena);
             if (x)
                 p->Type = DICT_LEET_MATCH;
             else
@@ -761,8 +859,8 @@ static void DoDictMatch(const uint8_t *Passwd, int Start, int MaxLen, DictWork_t
             p->Length = Wrk->PwdLength + Len + 1;
             p->Begin = Wrk->Begin;
             DictionaryEntropy(p, Extra, Pwd);
-            AddMatchRepeats(Result, p, Pwd, MaxLen);
-            AddResult(Result, p, MaxLen);
+            AddMatchRepeats(Arena, Result, p, Pwd, MaxLen);
+            AddResult(Arena, Result, p, MaxLen);
             ++Ord;
         }
     }
@@ -777,7 +875,7 @@ static void DoDictMatch(const uint8_t *Passwd, int Start, int MaxLen, DictWork_t
  *  Start   Where in the password to start attempting to match
  *  MaxLen  Maximum number characters to consider
  */
-static void UserMatch(ZxcMatch_t **Result, const char *Words[], const uint8_t *Passwd, int Start, int MaxLen)
+static void UserMatch(ZxcArena_t *Arena, ZxcMatch_t **Result, const char *Words[], const uint8_t *Passwd, int Start, int MaxLen)
 {
     int Rank;
     if (!Words)
@@ -870,7 +968,7 @@ static void UserMatch(ZxcMatch_t **Result, const char *Words[], const uint8_t *P
         }
         if (Len)
         {
-            ZxcMatch_t *p = AllocMatch();
+            ZxcMatch_t *p = AllocMatch(Arena);
             if (!Leets)
                 p->Type = USER_MATCH;
             else
@@ -883,8 +981,8 @@ static void UserMatch(ZxcMatch_t **Result, const char *Words[], const uint8_t *P
             Extra.NumLeet = Leets;
             Extra.Rank = Rank+1;
             DictionaryEntropy(p, &Extra, Passwd);
-            AddMatchRepeats(Result, p, Passwd, MaxLen);
-            AddResult(Result, p, MaxLen);
+            AddMatchRepeats(Arena, Result, p, Passwd, MaxLen);
+            AddResult(Arena, Result, p, MaxLen);
         }
     }
 }
@@ -897,7 +995,7 @@ static void UserMatch(ZxcMatch_t **Result, const char *Words[], const uint8_t *P
  *  Start   Where in the password to start attempting to match
  *  MaxLen  Maximum number characters to consider
  */
-static void DictionaryMatch(ZxcMatch_t **Result, const uint8_t *Passwd, int Start, int MaxLen)
+static void DictionaryMatch(ZxcArena_t *Arena, ZxcMatch_t **Result, const uint8_t *Passwd, int Start, int MaxLen)
 {
     DictWork_t Wrk;
     DictMatchInfo_t Extra;
@@ -907,7 +1005,7 @@ static void DictionaryMatch(ZxcMatch_t **Result, const uint8_t *Passwd, int Star
     Wrk.Ordinal = 1;
     Wrk.StartLoc = ROOT_NODE_LOC;
     Wrk.Begin = Start;
-    DoDictMatch(Passwd+Start, 0, MaxLen, &Wrk, Result, &Extra, 0);
+    DoDictMatch(Arena, Passwd+Start, 0, MaxLen, &Wrk, Result, &Extra, 0);
 }
 
 
@@ -1146,7 +1244,7 @@ static int DoSptlMatch(const uint8_t *Passwd, int MaxLen, const Keyboard_t *Keyb
  *  Start   Where in the password to start attempting to match
  *  MaxLen  Maximum number characters to consider
  */
-static void SpatialMatch(ZxcMatch_t **Result, const uint8_t *Passwd, int Start, int MaxLen)
+static void SpatialMatch(ZxcArena_t *Arena, ZxcMatch_t **Result, const uint8_t *Passwd, int Start, int MaxLen)
 {
     unsigned int Indx;
     int Len, CurLen;
@@ -1203,13 +1301,13 @@ static void SpatialMatch(ZxcMatch_t **Result, const uint8_t *Passwd, int Start,
                     if (Degree > 0.0)
                         Entropy += log(Degree);
                 }
-                p = AllocMatch();
+                p = AllocMatch(Arena);
                 p->Type = SPATIAL_MATCH;
                 p->Begin = Start;
                 p->Entrpy = Entropy;
                 p->Length = Len;
-                AddMatchRepeats(Result, p, Passwd, MaxLen);
-                AddResult(Result, p, MaxLen);
+                AddMatchRepeats(Arena, Result, p, Passwd, MaxLen);
+                AddResult(Arena, Result, p, MaxLen);
             }
         }
     }
@@ -1255,7 +1353,7 @@ static const char DateSeperators[] = "/\\-_. ";
 /**********************************************************************************
  * Try to match the password with the formats above.
  */
-static void DateMatch(ZxcMatch_t **Result, const uint8_t *Passwd, int Start, int MaxLen)
+static void DateMatch(ZxcArena_t *Arena, ZxcMatch_t **Result, const uint8_t *Passwd, int Start, int MaxLen)
 {
     int CurFmt;
     int YrLen = 0;
@@ -1335,7 +1433,7 @@ static void DateMatch(ZxcMatch_t **Result, const uint8_t *Passwd, int Start, int
         {
             /* String matched the date, store result */
             double e;
-            ZxcMatch_t *p = AllocMatch();
+            ZxcMatch_t *p = AllocMatch(Arena);
 
             if (Len <= 4)
                 e = log(MAX_YEAR - MIN_YEAR + 1.0);
@@ -1349,8 +1447,8 @@ static void DateMatch(ZxcMatch_t **Result, const uint8_t *Passwd, int Start, int
             p->Type = DATE_MATCH;
             p->Length = Len;
             p->Begin = Start;
-            AddMatchRepeats(Result, p, Passwd, MaxLen);
-            AddResult(Result, p, MaxLen);
+            AddMatchRepeats(Arena, Result, p, Passwd, MaxLen);
+            AddResult(Arena, Result, p, MaxLen);
             PrevLen = Len;
         }
     }
@@ -1371,7 +1469,7 @@ static void DateMatch(ZxcMatch_t **Result, const uint8_t *Passwd, int Start, int
  *  Start   Where in the password to start attempting to match
  *  MaxLen  Maximum number characters to consider
  */
-static void RepeatMatch(ZxcMatch_t **Result, const uint8_t *Passwd, int Start, int MaxLen)
+static void RepeatMatch(ZxcArena_t *Arena, ZxcMatch_t **Result, const uint8_t *Passwd, int Start, int MaxLen)
 {
     int Len, i;
     uint8_t c;
@@ -1386,12 +1484,12 @@ static void RepeatMatch(ZxcMatch_t **Result, const uint8_t *Passwd, int Start, i
         double Card = Cardinality(&c, 1);
         for(i = Len; i >= MIN_REPEAT_LEN; --i)
         {
-            ZxcMatch_t *p = AllocMatch();
+            ZxcMatch_t *p = AllocMatch(Arena);
             p->Type = REPEATS_MATCH;
             p->Begin = Start;
             p->Length = i;
             p->Entrpy = log(Card * i);
-            AddResult(Result, p, MaxLen);
+            AddResult(Arena, Result, p, MaxLen);
         }
     }
 
@@ -1406,12 +1504,12 @@ static void RepeatMatch(ZxcMatch_t **Result, const uint8_t *Passwd, int Start, i
             {
                 /* Found a repeat */
                 int c = Cardinality(Passwd, Len);
-                ZxcMatch_t *p = AllocMatch();
+                ZxcMatch_t *p = AllocMatch(Arena);
                 p->Entrpy = log((double)c) * Len + log(RepeatCount);
                 p->Type = (ZxcTypeMatch_t)(BRUTE_MATCH + MULTIPLE_MATCH);
                 p->Length = Len * RepeatCount;
                 p->Begin = Start;
-                AddResult(Result, p, MaxLen);
+                AddResult(Arena, Result, p, MaxLen);
             }
             else
                 break;
@@ -1436,7 +1534,7 @@ static void RepeatMatch(ZxcMatch_t **Result, const uint8_t *Passwd, int Start, i
  *  Start   Where in the password to start attempting to match
  *  MaxLen  Maximum number characters to consider
  */
-static void SequenceMatch(ZxcMatch_t **Result, const uint8_t *Passwd, int Start, int MaxLen)
+static void SequenceMatch(ZxcArena_t *Arena, ZxcMatch_t **Result, const uint8_t *Passwd, int Start, int MaxLen)
 {
     int Len=0;
     int SetLow, SetHigh, Dir;
@@ -1520,14 +1618,14 @@ static void SequenceMatch(ZxcMatch_t **Result, const uint8_t *Passwd, int Start,
 
         for(i = Len; i >= MIN_SEQUENCE_LEN; --i)
         {
-            ZxcMatch_t *p = AllocMatch();
+            ZxcMatch_t *p = AllocMatch(Arena);
             /* Add new result to head of list as it has lower entropy */
             p->Type = SEQUENCE_MATCH;
             p->Begin = Start;
             p->Length = i;
             p->Entrpy = e + log((double)i);
-            AddMatchRepeats(Result, p, Pwd, MaxLen);
-            AddResult(Result, p, MaxLen);
+            AddMatchRepeats(Arena, Result, p, Pwd, MaxLen);
+            AddResult(Arena, Result, p, MaxLen);
         }
     }
 }
@@ -1570,6 +1668,15 @@ typedef struct
  * Main function of the zxcvbn password entropy estimation
  */
 double ZxcvbnMatch(const char *Pwd, const char *UserDict[], ZxcMatch_t **Info)
+{
+    return ZxcvbnMatchArena(0, Pwd, UserDict, Info);
+}
+
+/**********************************************************************************
+ * Main function of the zxcvbn password entropy estimation, taking the matches from
+ * the given arena (or the heap if Arena is null)
+ */
+double ZxcvbnMatchArena(ZxcArena_t *Arena, const char *Pwd, const char *UserDict[], ZxcMatch_t **Info)
 {
     int i, j;
     ZxcMatch_t *Zp;
@@ -1579,7 +1686,10 @@ double ZxcvbnMatch(const char *Pwd, const char *UserDict[], ZxcMatch_t **Info)
     const uint8_t *Passwd = (const uint8_t *)Pwd;
     uint8_t *RevPwd;
     /* Create the paths */
-    Node_t *Nodes = MallocFn(Node_t, Len+1);
+    Node_t *Nodes;
+    if (Arena)
+        ResetArena(Arena);
+    Nodes = MallocFn(Node_t, Len+1);
     memset(Nodes, 0, (Len+1) * sizeof *Nodes);
     i = Cardinality(Passwd, Len);
     e = log((double)i);
@@ -1589,12 +1699,12 @@ double ZxcvbnMatch(const char *Pwd, const char *UserDict[], ZxcMatch_t **Info)
     {
         int MaxLen = Len - i;
         /* Add all the 'paths' between groups of chars in the password, for current starting char */
-        UserMatch(&(Nodes[i].Paths), UserDict, Passwd, i, MaxLen);
-        DictionaryMatch(&(Nodes[i].Paths), Passwd, i, MaxLen);
-        DateMatch(&(Nodes[i].Paths), Passwd, i, MaxLen);
-        SpatialMatch(&(Nodes[i].Paths), Passwd, i, MaxLen);
-        SequenceMatch(&(Nodes[i].Paths), Passwd, i, MaxLen);
-        RepeatMatch(&(Nodes[i].Paths), Passwd, i, MaxLen);
+        UserMatch(Arena, &(Nodes[i].Paths), UserDict, Passwd, i, MaxLen);
+        DictionaryMatch(Arena, &(Nodes[i].Paths), Passwd, i, MaxLen);
+        DateMatch(Arena, &(Nodes[i].Paths), Passwd, i, MaxLen);
+        SpatialMatch(Arena, &(Nodes[i].Paths), Passwd, i, MaxLen);
+        SequenceMatch(Arena, &(Nodes[i].Paths), Passwd, i, MaxLen);
+        RepeatMatch(Arena, &(Nodes[i].Paths), Passwd, i, MaxLen);
 
         /* Initially set distance to nearly infinite */
         Nodes[i].Dist = DBL_MAX;
@@ -1609,8 +1719,8 @@ double ZxcvbnMatch(const char *Pwd, const char *UserDict[], ZxcMatch_t **Info)
     {
         ZxcMatch_t *Path = 0;
         int MaxLen = Len - i;
-        DictionaryMatch(&Path, RevPwd, i, MaxLen);
-        UserMatch(&Path, UserDict, RevPwd, i, MaxLen);
+        DictionaryMatch(Arena, &Path, RevPwd, i, MaxLen);
+        UserMatch(Arena, &Path, UserDict, RevPwd, i, MaxLen);
 
         /* Now transfer any reverse matches to the normal results */
         while(Path)
@@ -1618,7 +1728,7 @@ double ZxcvbnMatch(const char *Pwd, const char *UserDict[], ZxcMatch_t **Info)
             ZxcMatch_t *Nxt = Path->Next;
             Path->Next = 0;
             Path->Begin = Len - (Path->Begin + Path->Length);
-            AddResult(&(Nodes[Path->Begin].Paths), Path, MaxLen);
+            AddResult(Arena, &(Nodes[Path->Begin].Paths), Path, MaxLen);
             Path = Nxt;
         }
     }
@@ -1650,12 +1760,12 @@ double ZxcvbnMatch(const char *Pwd, const char *UserDict[], ZxcMatch_t **Info)
         {
             if (RevPwd[j])
             {
-                Zp = AllocMatch();
+                Zp = AllocMatch(Arena);
                 Zp->Type = BRUTE_MATCH;
                 Zp->Begin = i;
                 Zp->Length = j - i;
                 Zp->Entrpy = e * (j - i);
-                AddResult(&(Nodes[i].Paths), Zp, MaxLen);
+                AddResult(Arena, &(Nodes[i].Paths), Zp, MaxLen);
             }
         }
     }
@@ -1733,7 +1843,7 @@ double ZxcvbnMatch(const char *Pwd, const char *UserDict[], ZxcMatch_t **Info)
                 else
                 {
                     /* Not going on info list, so free it */
-                    FreeFn(Xp);
+                    FreeMatch(Arena, Xp);
                 }
                 Xp = p;
             }
@@ -1747,7 +1857,7 @@ double ZxcvbnMatch(const char *Pwd, const char *UserDict[], ZxcMatch_t **Info)
         while(Zp)
         {
             ZxcMatch_t *p = Zp->Next;
-            FreeFn(Zp);
+            FreeMatch(Arena, Zp);
             Zp = p;
         }
     }
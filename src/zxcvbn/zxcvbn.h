@@ -77,6 +77,12 @@ struct ZxcMatch
 };
 typedef struct ZxcMatch ZxcMatch_t;
 
+/* Opaque match arena, see ZxcvbnNewArena() */
+typedef struct ZxcArena ZxcArena_t;
+
+/* Defined when the ZxcvbnMatchArena() family of functions is available */
+#define ZXCVBN_HAVE_ARENA 1
+
 
 #ifdef __cplusplus
 extern "C" {
@@ -124,6 +130,27 @@ double ZxcvbnMatch(const char *Passwd, const char *UserDict[], ZxcMatch_t **Info
  */
 void ZxcvbnFreeInfo(ZxcMatch_t *Info);
 
+/**********************************************************************************
+ * Create a match arena. The matches found while evaluating a password are taken
+ * from the arena, and the arena memory is reused for the next password instead of
+ * allocating every match from the heap. The dictionary data is read only, so
+ * ZxcvbnMatchArena() may be called from several threads at once as long as each
+ * thread uses its own arena.
+ */
+ZxcArena_t *ZxcvbnNewArena(void);
+
+/**********************************************************************************
+ * Free a match arena created by ZxcvbnNewArena().
+ */
+void ZxcvbnFreeArena(ZxcArena_t *Arena);
+
+/**********************************************************************************
+ * Same as ZxcvbnMatch(), but taking the matches from the given arena. Information
+ * returned in the Info parameter is owned by the arena, it stays valid until the
+ * next call with the same arena and must not be passed to ZxcvbnFreeInfo().
+ */
+double ZxcvbnMatchArena(ZxcArena_t *Arena, const char *Passwd, const char *UserDict[], ZxcMatch_t **Info);
+
 #ifdef __cplusplus
 }
 #endif
@@ -18,12 +18,17 @@
 #include "TestBrowser.h"
 
 #include "browser/BrowserSettings.h"
+#include "browser/BrowserShared.h"
 #include "core/Group.h"
 #include "core/Tools.h"
 #include "crypto/Crypto.h"
 
 #include <QJsonObject>
+#include <QMutex>
+#include <QSemaphore>
+#include <QSignalSpy>
 #include <QTest>
+#include <QtConcurrent>
 
 #include <botan/sodium.h>
 
@@ -50,6 +55,11 @@ void TestBrowser::init()
     m_browserAction.reset(new BrowserAction());
 }
 
+void TestBrowser::cleanup()
+{
+    m_browserService->m_requestHandler = {};
+}
+
 /**
  * Tests for BrowserAction
  */
@@ -91,6 +101,33 @@ void TestBrowser::testDecryptMessage()
     QCOMPARE(decrypted["action"].toString(), QString("test-action"));
 }
 
+void TestBrowser::testSessionKeyReset()
+{
+    QJsonObject message;
+    message["action"] = "test-action";
+
+    m_browserAction->m_publicKey = SERVERPUBLICKEY;
+    m_browserAction->m_secretKey = SERVERSECRETKEY;
+    m_browserAction->m_clientPublicKey = PUBLICKEY;
+    auto encrypted = m_browserAction->encryptMessage(message, NONCE);
+    QVERIFY(!m_browserAction->m_sharedKey.empty());
+
+    // The shared key is reused for later messages of the session
+    QCOMPARE(m_browserAction->decryptMessage(encrypted, NONCE)["action"].toString(), QString("test-action"));
+    QVERIFY(m_browserAction->decryptMessage(encrypted, "AAAA").isEmpty());
+
+    // A key exchange starts a new session, old messages can't be decrypted anymore
+    QJsonObject json;
+    json["action"] = "change-public-keys";
+    json["publicKey"] = PUBLICKEY;
+    json["nonce"] = NONCE;
+    m_browserAction->processClientMessage(json);
+    QVERIFY(m_browserAction->m_sharedKey.empty());
+    QVERIFY(m_browserAction->decryptMessage(encrypted, NONCE).isEmpty());
+    QVERIFY(!m_browserAction->m_sharedKey.empty());
+    QVERIFY(m_browserAction->encryptMessage(message, NONCE) != encrypted);
+}
+
 void TestBrowser::testGetBase64FromKey()
 {
     unsigned char pk[crypto_box_PUBLICKEYBYTES];
@@ -627,3 +664,208 @@ void TestBrowser::testBestMatchingWithAdditionalURLs()
     QCOMPARE(sorted.length(), 1);
     QCOMPARE(sorted[0]->url(), urls[0]);
 }
+
+void TestBrowser::testSearchEntriesIndexUpdates()
+{
+    auto db = QSharedPointer<Database>::create();
+    auto* root = db->rootGroup();
+
+    auto* group = new Group();
+    group->setParent(root);
+    QStringList urls = {"https://github.com/login", "https://example.com"};
+    auto entries = createEntries(urls, group);
+    QStringList rootUrls = {"https://github.com/"};
+    auto rootEntries = createEntries(rootUrls, root);
+
+    // Results keep the database order
+    auto result = m_browserService->searchEntries(db, "https://github.com", "https://github.com/session");
+    QCOMPARE(result.length(), 2);
+    QCOMPARE(result[0], rootEntries[0]);
+    QCOMPARE(result[1], entries[0]);
+
+    // Changed and additional URLs are picked up
+    entries[1]->setUrl("https://www.github.com");
+    entries[0]->attributes()->set(BrowserService::ADDITIONAL_URL, "https://keepassxc.org");
+    result = m_browserService->searchEntries(db, "https://www.github.com", "https://www.github.com/session");
+    QCOMPARE(result.length(), 3);
+    result = m_browserService->searchEntries(db, "https://keepassxc.org", "https://keepassxc.org");
+    QCOMPARE(result.length(), 1);
+    QCOMPARE(result[0], entries[0]);
+
+    // Removed entries and entries added with a group are accounted for
+    delete entries[1];
+    auto* otherGroup = new Group();
+    QStringList otherUrls = {"https://github.com/other"};
+    auto otherEntries = createEntries(otherUrls, otherGroup);
+    otherGroup->setParent(root);
+    result = m_browserService->searchEntries(db, "https://www.github.com", "https://www.github.com/session");
+    QCOMPARE(result.length(), 3);
+    QVERIFY(result.contains(otherEntries[0]));
+
+    // A replaced root group is indexed again
+    auto* newRoot = new Group();
+    newRoot->setUuid(QUuid::createUuid());
+    auto newEntries = createEntries(otherUrls, newRoot);
+    auto* oldRoot = db->rootGroup();
+    db->setRootGroup(newRoot);
+    delete oldRoot;
+    result = m_browserService->searchEntries(db, "https://github.com", "https://github.com/session");
+    QCOMPARE(result.length(), 1);
+    QCOMPARE(result[0], newEntries[0]);
+}
+
+void TestBrowser::testMessageFraming()
+{
+    const QByteArray first = R"({"action":"get-databasehash"})";
+    const QByteArray second = R"({"action":"test-associate"})";
+
+    // Coalesced messages are split apart
+    QByteArray buffer = BrowserShared::frameMessage(first) + BrowserShared::frameMessage(second);
+    QVERIFY(BrowserShared::isFramed(buffer));
+    QByteArray message;
+    QVERIFY(BrowserShared::takeFrame(buffer, message));
+    QCOMPARE(message, first);
+    QVERIFY(BrowserShared::takeFrame(buffer, message));
+    QCOMPARE(message, second);
+    QVERIFY(buffer.isEmpty());
+
+    // A split message is only taken once complete
+    const auto frame = BrowserShared::frameMessage(first);
+    buffer = frame.left(2);
+    QVERIFY(!BrowserShared::takeFrame(buffer, message));
+    buffer.append(frame.mid(2, 10));
+    QVERIFY(!BrowserShared::takeFrame(buffer, message));
+    buffer.append(frame.mid(12));
+    QVERIFY(BrowserShared::takeFrame(buffer, message));
+    QCOMPARE(message, first);
+
+    // Oversized frames are dropped, bare JSON is recognized
+    buffer = QByteArray::fromHex("7fffffff") + first;
+    QVERIFY(!BrowserShared::takeFrame(buffer, message));
+    QVERIFY(buffer.isEmpty());
+    QVERIFY(!BrowserShared::isFramed(first));
+}
+
+void TestBrowser::testRunOnGuiThread()
+{
+    auto* guiThread = QThread::currentThread();
+    auto onGuiThread = [guiThread] { return QThread::currentThread() == guiThread; };
+    QVERIFY(m_browserService->runOnGuiThread<bool>(onGuiThread));
+
+    auto future =
+        QtConcurrent::run([this, onGuiThread] { return m_browserService->runOnGuiThread<bool>(onGuiThread); });
+    // The worker waits for the GUI thread, keep processing events
+    QTRY_VERIFY(future.isFinished());
+    QVERIFY(future.result());
+}
+
+namespace
+{
+    QJsonObject clientRequest(const QString& clientID, int id)
+    {
+        QJsonObject message;
+        message["clientID"] = clientID;
+        message["id"] = id;
+        return message;
+    }
+} // namespace
+
+void TestBrowser::testRequestQueueOrder()
+{
+    QMutex mutex;
+    int running = 0;
+    int maxRunning = 0;
+    m_browserService->m_requestHandler = [&](const QJsonObject& message) {
+        {
+            QMutexLocker locker(&mutex);
+            maxRunning = qMax(maxRunning, ++running);
+        }
+        // Earlier requests take longer, they must still be answered first
+        QThread::msleep(static_cast<unsigned long>(10 * (5 - message["id"].toInt())));
+        {
+            QMutexLocker locker(&mutex);
+            --running;
+        }
+        return message;
+    };
+
+    QSignalSpy spyReplies(m_browserService, SIGNAL(clientReplySent(QJsonObject)));
+    for (int i = 0; i < 5; ++i) {
+        m_browserService->processClientMessage(clientRequest(CLIENTID, i));
+    }
+
+    QTRY_COMPARE(spyReplies.count(), 5);
+    for (int i = 0; i < 5; ++i) {
+        QCOMPARE(spyReplies.at(i).first().toJsonObject()["id"].toInt(), i);
+    }
+    QCOMPARE(maxRunning, 1);
+    QVERIFY(m_browserService->m_pendingRequests.isEmpty());
+    QVERIFY(m_browserService->m_busyClients.isEmpty());
+}
+
+void TestBrowser::testRequestQueueConcurrentClients()
+{
+    // The first client waits for the second one, which only works if both run at the same time
+    QSemaphore firstStarted;
+    QSemaphore secondDone;
+    m_browserService->m_requestHandler = [&](const QJsonObject& message) {
+        auto reply = message;
+        if (message["clientID"].toString() == "first") {
+            firstStarted.release();
+            reply["concurrent"] = secondDone.tryAcquire(1, 5000);
+        } else {
+            reply["concurrent"] = firstStarted.tryAcquire(1, 5000);
+            secondDone.release();
+        }
+        return reply;
+    };
+
+    QSignalSpy spyReplies(m_browserService, SIGNAL(clientReplySent(QJsonObject)));
+    m_browserService->processClientMessage(clientRequest("first", 0));
+    m_browserService->processClientMessage(clientRequest("second", 0));
+
+    QTRY_COMPARE_WITH_TIMEOUT(spyReplies.count(), 2, 15000);
+    for (const auto& reply : spyReplies) {
+        QVERIFY(reply.first().toJsonObject()["concurrent"].toBool());
+    }
+}
+
+void TestBrowser::testRequestQueueShutdown()
+{
+    QSemaphore started;
+    QSemaphore proceed;
+    QAtomicInt handled;
+    QAtomicInt servedByGui;
+    m_browserService->m_requestHandler = [&](const QJsonObject& message) {
+        handled.ref();
+        started.release();
+        proceed.tryAcquire(1, 5000);
+        // Blocks on the GUI thread while it is shutting down
+        if (m_browserService->runOnGuiThread<bool>([] { return true; })) {
+            servedByGui.ref();
+        }
+        return message;
+    };
+
+    QSignalSpy spyReplies(m_browserService, SIGNAL(clientReplySent(QJsonObject)));
+    for (int i = 0; i < 3; ++i) {
+        m_browserService->processClientMessage(clientRequest(CLIENTID, i));
+    }
+    QVERIFY(started.tryAcquire(1, 5000));
+
+    proceed.release();
+    m_browserService->shutdownRequests();
+
+    // The request in flight finished without the GUI thread, the queued ones were dropped
+    QCOMPARE(handled.load(), 1);
+    QCOMPARE(servedByGui.load(), 0);
+    QVERIFY(m_browserService->m_pendingRequests.isEmpty());
+
+    // Requests arriving after shutdown are ignored
+    m_browserService->processClientMessage(clientRequest(CLIENTID, 3));
+    QTRY_VERIFY(m_browserService->m_busyClients.isEmpty());
+    QCOMPARE(handled.load(), 1);
+    QCOMPARE(spyReplies.count(), 0);
+
+    m_browserService->m_shuttingDown = false;
+}
@@ -30,10 +30,12 @@ class TestBrowser : public QObject
 private slots:
     void initTestCase();
     void init();
+    void cleanup();
 
     void testChangePublicKeys();
     void testEncryptMessage();
     void testDecryptMessage();
+    void testSessionKeyReset();
     void testGetBase64FromKey();
     void testIncrementNonce();
 
@@ -50,6 +52,12 @@ private slots:
     void testValidURLs();
     void testBestMatchingCredentials();
     void testBestMatchingWithAdditionalURLs();
+    void testSearchEntriesIndexUpdates();
+    void testMessageFraming();
+    void testRunOnGuiThread();
+    void testRequestQueueOrder();
+    void testRequestQueueConcurrentClients();
+    void testRequestQueueShutdown();
 
 private:
     QList<Entry*> createEntries(QStringList& urls, Group* root) const;
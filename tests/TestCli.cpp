@@ -30,6 +30,7 @@
 #include "cli/Add.h"
 #include "cli/AddGroup.h"
 #include "cli/Analyze.h"
+#include "cli/Batch.h"
 #include "cli/Clip.h"
 #include "cli/Create.h"
 #include "cli/Diceware.h"
@@ -47,10 +48,13 @@
 #include "cli/Open.h"
 #include "cli/Remove.h"
 #include "cli/RemoveGroup.h"
+#include "cli/Rotate.h"
 #include "cli/Show.h"
 #include "cli/Utils.h"
 
 #include <QClipboard>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QSignalSpy>
 #include <QTest>
 #include <QtConcurrent>
@@ -215,6 +219,7 @@ void TestCli::testBatchCommands()
     Commands::setupCommands(false);
     QVERIFY(Commands::getCommand("add"));
     QVERIFY(Commands::getCommand("analyze"));
+    QVERIFY(Commands::getCommand("batch"));
     QVERIFY(Commands::getCommand("clip"));
     QVERIFY(Commands::getCommand("close"));
     QVERIFY(Commands::getCommand("db-create"));
@@ -234,9 +239,10 @@ void TestCli::testBatchCommands()
     QVERIFY(Commands::getCommand("open"));
     QVERIFY(Commands::getCommand("rm"));
     QVERIFY(Commands::getCommand("rmdir"));
+    QVERIFY(Commands::getCommand("rotate"));
     QVERIFY(Commands::getCommand("show"));
     QVERIFY(!Commands::getCommand("doesnotexist"));
-    QCOMPARE(Commands::getCommands().size(), 22);
+    QCOMPARE(Commands::getCommands().size(), 24);
 }
 
 void TestCli::testInteractiveCommands()
@@ -263,9 +269,10 @@ void TestCli::testInteractiveCommands()
     QVERIFY(Commands::getCommand("quit"));
     QVERIFY(Commands::getCommand("rm"));
     QVERIFY(Commands::getCommand("rmdir"));
+    QVERIFY(Commands::getCommand("rotate"));
     QVERIFY(Commands::getCommand("show"));
     QVERIFY(!Commands::getCommand("doesnotexist"));
-    QCOMPARE(Commands::getCommands().size(), 22);
+    QCOMPARE(Commands::getCommands().size(), 23);
 }
 
 void TestCli::testAdd()
@@ -433,6 +440,91 @@ void TestCli::testAnalyze()
     QVERIFY(output.contains("123"));
     m_stderr->readLine(); // Skip password prompt
     QCOMPARE(m_stderr->readAll(), QByteArray());
+
+    // The index is created on first use and can be passed as HIBP file afterwards
+    QScopedPointer<QTemporaryDir> testDir(new QTemporaryDir());
+    const QString indexPath = testDir->path() + "/hibp.kpxhibp";
+    setInput("a");
+    execCmd(analyzeCmd, {"analyze", "--hibp", hibpPath, "--hibp-index", indexPath, m_dbFile->fileName()});
+    output = m_stdout->readAll();
+    QVERIFY(output.contains("Creating HIBP index"));
+    QVERIFY(output.contains("Sample Entry"));
+    QVERIFY(output.contains("123"));
+    m_stderr->readLine();
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+
+    setInput("a");
+    execCmd(analyzeCmd, {"analyze", "--hibp", indexPath, m_dbFile->fileName()});
+    output = m_stdout->readAll();
+    QVERIFY(!output.contains("Creating HIBP index"));
+    QVERIFY(output.contains("Sample Entry"));
+    QVERIFY(output.contains("123"));
+    m_stderr->readLine();
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+
+    // The health report works without a HIBP file
+    setInput("a");
+    execCmd(analyzeCmd, {"analyze", "--health", m_dbFile->fileName()});
+    output = m_stdout->readAll();
+    QVERIFY(output.contains("Password for 'Sample Entry' has score"));
+    m_stderr->readLine();
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+}
+
+void TestCli::testBatch()
+{
+    Commands::setupCommands(false);
+    Batch batchCmd;
+    QVERIFY(!batchCmd.name.isEmpty());
+    QVERIFY(batchCmd.getDescriptionLine().contains(batchCmd.name));
+
+    setInput({"a",
+              "add -u batchuser /batch-entry",
+              "# comment lines are ignored",
+              R"({"command": "mkdir", "arguments": ["/batch-group"], "id": "mk"})",
+              "mv /batch-entry /batch-group",
+              "show -a UserName /batch-group/batch-entry"});
+    execCmd(batchCmd, {"batch", m_dbFile->fileName()});
+    m_stderr->readLine(); // Skip password prompt
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+
+    QList<QJsonObject> results;
+    while (!m_stdout->atEnd()) {
+        results << QJsonDocument::fromJson(m_stdout->readLine()).object();
+    }
+    QCOMPARE(results.size(), 5);
+    QCOMPARE(results[0]["command"].toString(), QString("add"));
+    QCOMPARE(results[0]["exitCode"].toInt(), EXIT_SUCCESS);
+    QVERIFY(results[0]["output"].toString().contains("Successfully added entry batch-entry."));
+    QCOMPARE(results[1]["id"].toString(), QString("mk"));
+    QCOMPARE(results[1]["line"].toInt(), 4);
+    QCOMPARE(results[2]["exitCode"].toInt(), EXIT_SUCCESS);
+    QCOMPARE(results[3]["output"].toString(), QString("batchuser\n"));
+    QCOMPARE(results[4]["executed"].toInt(), 4);
+    QCOMPARE(results[4]["failed"].toInt(), 0);
+    QVERIFY(results[4]["saved"].toBool());
+
+    auto db = readDatabase();
+    auto* entry = db->rootGroup()->findEntryByPath("/batch-group/batch-entry");
+    QVERIFY(entry);
+    QCOMPARE(entry->username(), QString("batchuser"));
+
+    // Failing commands are reported and stop the batch without saving.
+    setInput({"a", "rm /batch-group/batch-entry", "open /other.kdbx", "ls"});
+    execCmd(batchCmd, {"batch", "--stop-on-error", m_dbFile->fileName()});
+    results.clear();
+    while (!m_stdout->atEnd()) {
+        results << QJsonDocument::fromJson(m_stdout->readLine()).object();
+    }
+    QCOMPARE(results.size(), 3);
+    QCOMPARE(results[0]["exitCode"].toInt(), EXIT_SUCCESS);
+    QCOMPARE(results[1]["exitCode"].toInt(), EXIT_FAILURE);
+    QVERIFY(results[1]["error"].toString().contains("not available in batch mode"));
+    QCOMPARE(results[2]["failed"].toInt(), 1);
+    QVERIFY(!results[2]["saved"].toBool());
+
+    db = readDatabase();
+    QVERIFY(db->rootGroup()->findEntryByPath("/batch-group/batch-entry"));
 }
 
 void TestCli::testClip()
@@ -975,6 +1067,20 @@ void TestCli::testExport()
     QVERIFY(csvData.contains(QByteArray(
         "\"NewDatabase\",\"Sample Entry\",\"User Name\",\"Password\",\"http://www.somesite.com/\",\"Notes\"")));
 
+    // JSON Lines exporting
+    setInput("a");
+    execCmd(exportCmd, {"export", "-f", "jsonl", m_dbFile->fileName()});
+    auto json = QJsonDocument::fromJson(m_stdout->readLine()).object();
+    QCOMPARE(json["path"].toString(), QString("/Sample Entry"));
+    QCOMPARE(json["Password"].toString(), QString("Password"));
+    QVERIFY(json.contains("Created"));
+
+    setInput("a");
+    execCmd(exportCmd, {"export", "-f", "jsonl", "--fields", "URL", m_dbFile->fileName()});
+    json = QJsonDocument::fromJson(m_stdout->readLine()).object();
+    QCOMPARE(json["URL"].toString(), QString("http://www.somesite.com/"));
+    QVERIFY(!json.contains("Password"));
+
     // test invalid format
     setInput("a");
     execCmd(exportCmd, {"export", "-f", "yaml", m_dbFile->fileName()});
@@ -1043,6 +1149,18 @@ void TestCli::testGenerate()
     // Testing with invalid word count format
     execCmd(generateCmd, {"generate", "-L", "bleuh"});
     QCOMPARE(m_stderr->readLine(), QByteArray("Invalid password length bleuh\n"));
+
+    // Generating many passwords at once
+    execCmd(generateCmd, {"generate", "-L", "12", "-c", "500"});
+    const auto passwords = QString::fromUtf8(m_stdout->readAll()).split('\n', QString::SkipEmptyParts);
+    QCOMPARE(passwords.size(), 500);
+    for (const auto& password : passwords) {
+        QCOMPARE(password.size(), 12);
+    }
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+
+    execCmd(generateCmd, {"generate", "-c", "0"});
+    QCOMPARE(m_stderr->readLine(), QByteArray("Invalid password count 0\n"));
 }
 
 void TestCli::testImport()
@@ -1142,6 +1260,41 @@ void TestCli::testImport()
 
     db = readDatabase(databaseFilenameQuiet, "a");
     QVERIFY(db);
+
+    // CSV import with the columns of the CSV export
+    QString csvFilename = testDir->path() + "/import.csv";
+    QFile csvFile(csvFilename);
+    QVERIFY(csvFile.open(QIODevice::WriteOnly));
+    csvFile.write("\"Title\",\"Group\",\"Username\",\"Password\",\"Notes\"\n"
+                  "\"Entry 1\",\"Root/Imported/Sub\",\"user1\",\"pass1\",\"multi\nline\"\n"
+                  "\"Entry 2\",\"Root\",\"user2\",\"pass2\",\"\"\n");
+    csvFile.close();
+
+    databaseFilename = testDir->path() + "/testImportCsv.kdbx";
+    setInput({"a", "a"});
+    execCmd(importCmd, {"import", "-p", "-f", "csv", csvFilename, databaseFilename});
+    m_stderr->readLine();
+    m_stderr->readLine();
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+    QCOMPARE(m_stdout->readLine(), QByteArray("Successfully imported database.\n"));
+
+    db = readDatabase(databaseFilename, "a");
+    QVERIFY(db);
+    entry = db->rootGroup()->findEntryByPath("/Imported/Sub/Entry 1");
+    QVERIFY(entry);
+    QCOMPARE(entry->username(), QString("user1"));
+    QCOMPARE(entry->password(), QString("pass1"));
+    QCOMPARE(entry->notes(), QString("multi\nline"));
+    entry = db->rootGroup()->findEntryByPath("/Entry 2");
+    QVERIFY(entry);
+    QCOMPARE(entry->username(), QString("user2"));
+
+    // Unknown format
+    databaseFilename = testDir->path() + "/testImportFormat.kdbx";
+    execCmd(importCmd, {"import", "-f", "yaml", csvFilename, databaseFilename});
+    QCOMPARE(m_stdout->readAll(), QByteArray());
+    QCOMPARE(m_stderr->readAll(), QByteArray("Unsupported format yaml\n"));
+    QVERIFY(!QFileInfo::exists(databaseFilename));
 }
 
 void TestCli::testKeyFileOption()
@@ -1208,6 +1361,16 @@ void TestCli::testList()
                         "eMail/\n"
                         "Homebanking/\n"));
 
+    // JSON output
+    setInput("a");
+    execCmd(listCmd, {"ls", "--json", m_dbFile->fileName()});
+    auto json = QJsonDocument::fromJson(m_stdout->readLine()).object();
+    QCOMPARE(json["type"].toString(), QString("entry"));
+    QCOMPARE(json["Title"].toString(), QString("Sample Entry"));
+    json = QJsonDocument::fromJson(m_stdout->readLine()).object();
+    QCOMPARE(json["type"].toString(), QString("group"));
+    QCOMPARE(json["path"].toString(), QString("/General/"));
+
     // Quiet option
     setInput("a");
     execCmd(listCmd, {"ls", "-q", m_dbFile->fileName()});
@@ -1321,6 +1484,20 @@ void TestCli::testLocate()
     execCmd(locateCmd, {"locate", tmpFile.fileName(), "Entry"});
     QCOMPARE(m_stdout->readAll(),
              QByteArray("/Sample Entry\n/General/New Entry\n/Homebanking/Subgroup/Subgroup Entry\n"));
+
+    // JSON output with field selection
+    setInput("a");
+    execCmd(locateCmd, {"locate", "--json", "--fields", "Title,UserName", tmpFile.fileName(), "Entry"});
+    auto json = QJsonDocument::fromJson(m_stdout->readLine()).object();
+    QCOMPARE(json["path"].toString(), QString("/Sample Entry"));
+    QCOMPARE(json["Title"].toString(), QString("Sample Entry"));
+    QCOMPARE(json["UserName"].toString(), QString("User Name"));
+    QVERIFY(!json.contains("Password"));
+    QCOMPARE(QJsonDocument::fromJson(m_stdout->readLine()).object()["path"].toString(),
+             QString("/General/New Entry"));
+    QCOMPARE(QJsonDocument::fromJson(m_stdout->readLine()).object()["path"].toString(),
+             QString("/Homebanking/Subgroup/Subgroup Entry"));
+    QVERIFY(m_stdout->atEnd());
 }
 
 void TestCli::testMerge()
@@ -1694,6 +1871,81 @@ void TestCli::testRemoveQuiet()
     QVERIFY(!db->rootGroup()->findEntryByPath(QString("/%1/Sample Entry").arg(Group::tr("Recycle Bin"))));
 }
 
+void TestCli::testRotate()
+{
+    Rotate rotateCmd;
+    QVERIFY(!rotateCmd.name.isEmpty());
+    QVERIFY(rotateCmd.getDescriptionLine().contains(rotateCmd.name));
+
+    // a group or a search query is required
+    setInput("a");
+    execCmd(rotateCmd, {"rotate", m_dbFile->fileName()});
+    m_stderr->readLine(); // skip password prompt
+    QCOMPARE(m_stderr->readAll(), QByteArray("Select the entries to rotate with a group or a search query.\n"));
+    QCOMPARE(m_stdout->readAll(), QByteArray());
+
+    setInput("a");
+    execCmd(rotateCmd, {"rotate", m_dbFile->fileName(), "/invalid"});
+    m_stderr->readLine(); // skip password prompt
+    QCOMPARE(m_stderr->readAll(), QByteArray("Cannot find group /invalid.\n"));
+
+    // dry run does not change the database
+    setInput("a");
+    execCmd(rotateCmd, {"rotate", "--dry-run", m_dbFile->fileName(), "/Homebanking"});
+    QCOMPARE(m_stdout->readAll(),
+             QByteArray("Homebanking/Subgroup/Subgroup Entry\n"
+                        "Would rotate 1 password(s).\n"));
+
+    auto db = readDatabase();
+    auto* entry = db->rootGroup()->findEntryByPath("/Sample Entry");
+    auto* subEntry = db->rootGroup()->findEntryByPath("/Homebanking/Subgroup/Subgroup Entry");
+    QVERIFY(entry);
+    QVERIFY(subEntry);
+    const QString password = entry->password();
+    const QString subPassword = subEntry->password();
+
+    // rotate the whole database with the given generator settings
+    setInput("a");
+    execCmd(rotateCmd, {"rotate", "-L", "24", m_dbFile->fileName(), "/"});
+    m_stderr->readLine(); // skip password prompt
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+    QCOMPARE(m_stdout->readAll(),
+             QByteArray("Sample Entry\n"
+                        "Homebanking/Subgroup/Subgroup Entry\n"
+                        "Rotated 2 password(s).\n"));
+
+    db = readDatabase();
+    entry = db->rootGroup()->findEntryByPath("/Sample Entry");
+    subEntry = db->rootGroup()->findEntryByPath("/Homebanking/Subgroup/Subgroup Entry");
+    QCOMPARE(entry->password().size(), 24);
+    QCOMPARE(subEntry->password().size(), 24);
+    QVERIFY(entry->password() != password);
+    QVERIFY(subEntry->password() != subPassword);
+    QCOMPARE(entry->historyItems().last()->password(), password);
+    QCOMPARE(subEntry->historyItems().last()->password(), subPassword);
+
+    // rotate only the entries matching a search query
+    const QString rotatedPassword = entry->password();
+    const QString subRotatedPassword = subEntry->password();
+    setInput("a");
+    execCmd(rotateCmd, {"rotate", "-q", "--search", "title:Sample", m_dbFile->fileName()});
+    QCOMPARE(m_stderr->readAll(), QByteArray());
+    QCOMPARE(m_stdout->readAll(), QByteArray());
+
+    db = readDatabase();
+    entry = db->rootGroup()->findEntryByPath("/Sample Entry");
+    subEntry = db->rootGroup()->findEntryByPath("/Homebanking/Subgroup/Subgroup Entry");
+    QVERIFY(entry->password() != rotatedPassword);
+    QCOMPARE(entry->historyItems().last()->password(), rotatedPassword);
+    QCOMPARE(subEntry->password(), subRotatedPassword);
+
+    // nothing matches the query
+    setInput("a");
+    execCmd(rotateCmd, {"rotate", "--search", "title:Nothing", m_dbFile->fileName()});
+    m_stderr->readLine(); // skip password prompt
+    QCOMPARE(m_stderr->readAll(), QByteArray("No entries to rotate.\n"));
+}
+
 void TestCli::testShow()
 {
     Show showCmd;
@@ -1775,6 +2027,44 @@ void TestCli::testShow()
     execCmd(showCmd, {"show", m_dbFile->fileName(), "-a", "Testattribute1", "/Sample Entry"});
     QCOMPARE(m_stdout->readAll(), QByteArray());
     QVERIFY(m_stderr->readAll().contains("ERROR: attribute Testattribute1 is ambiguous"));
+
+    // JSON output masks protected default attributes
+    setInput("a");
+    execCmd(showCmd, {"show", "--json", m_dbFile->fileName(), "/Sample Entry"});
+    auto json = QJsonDocument::fromJson(m_stdout->readAll()).object();
+    QCOMPARE(json["type"].toString(), QString("entry"));
+    QCOMPARE(json["Title"].toString(), QString("Sample Entry"));
+    QCOMPARE(json["Password"].toString(), QString("PROTECTED"));
+
+    setInput("a");
+    execCmd(showCmd, {"show", "--json", "-a", "Password", m_dbFile->fileName(), "/Sample Entry"});
+    json = QJsonDocument::fromJson(m_stdout->readAll()).object();
+    QCOMPARE(json["Password"].toString(), QString("Password"));
+    QVERIFY(!json.contains("Title"));
+
+    // Unknown and ambiguous attributes fail like in the text output
+    setInput("a");
+    QCOMPARE(execCmd(showCmd,
+                     {"show", "--json", "-a", "DoesNotExist", "-a", "Title", m_dbFile->fileName(), "/Sample Entry"}),
+             EXIT_FAILURE);
+    QVERIFY(m_stderr->readAll().contains("ERROR: unknown attribute DoesNotExist.\n"));
+    json = QJsonDocument::fromJson(m_stdout->readAll()).object();
+    QCOMPARE(json["Title"].toString(), QString("Sample Entry"));
+    QVERIFY(!json.contains("DoesNotExist"));
+
+    setInput("a");
+    QCOMPARE(execCmd(showCmd, {"show", "--json", "-a", "Testattribute1", m_dbFile->fileName(), "/Sample Entry"}),
+             EXIT_FAILURE);
+    QVERIFY(m_stderr->readAll().contains("ERROR: attribute Testattribute1 is ambiguous"));
+    m_stdout->readAll();
+
+    // Only the TOTP is shown unless attributes are asked for
+    setInput("a");
+    QCOMPARE(execCmd(showCmd, {"show", "--json", "-t", m_dbFile->fileName(), "/Sample Entry"}), EXIT_SUCCESS);
+    json = QJsonDocument::fromJson(m_stdout->readAll()).object();
+    QVERIFY(isTotp(json["TOTP"].toString().toLatin1()));
+    QVERIFY(!json.contains("Title"));
+    QVERIFY(!json.contains("Password"));
 }
 
 void TestCli::testInvalidDbFiles()
@@ -47,6 +47,7 @@ private slots:
     void testAdd();
     void testAddGroup();
     void testAnalyze();
+    void testBatch();
     void testClip();
     void testCommandParsing_data();
     void testCommandParsing();
@@ -73,6 +74,7 @@ private slots:
     void testRemove();
     void testRemoveGroup();
     void testRemoveQuiet();
+    void testRotate();
     void testShow();
     void testInvalidDbFiles();
     void testYubiKeyOption();
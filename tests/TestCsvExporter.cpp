@@ -110,3 +110,32 @@ void TestCsvExporter::testNestedGroups()
             .append(ExpectedHeaderLine)
             .append("\"Passwords/Test Group Name/Test Sub Group Name\",\"Test Entry Title\",\"\",\"\",\"\",\"\"")));
 }
+
+void TestCsvExporter::testLargeGroup()
+{
+    // Enough entries to span several parallel chunks and output buffers
+    const int count = 5000;
+    Group* groupRoot = m_db->rootGroup();
+    for (int i = 0; i < count; ++i) {
+        auto* entry = new Entry();
+        entry->setGroup(groupRoot);
+        entry->setTitle(QString("Entry %1").arg(i));
+        entry->setPassword(QString("Password \"%1\"").arg(i));
+    }
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::ReadWrite));
+    QVERIFY(m_csvExporter->exportDatabase(&buffer, m_db));
+    auto parallel = buffer.buffer();
+
+    m_csvExporter->setParallelFormatting(false);
+    QCOMPARE(m_csvExporter->exportDatabase(m_db).toUtf8(), parallel);
+
+    const auto lines = QString::fromUtf8(parallel).split("\n", QString::SkipEmptyParts);
+    QCOMPARE(lines.size(), count + 1);
+    QCOMPARE(lines.first() + "\n", ExpectedHeaderLine);
+    for (int i = 0; i < count; ++i) {
+        QVERIFY(lines[i + 1].startsWith(
+            QString("\"Passwords\",\"Entry %1\",\"\",\"Password \"\"%1\"\"\",").arg(i)));
+    }
+}
@@ -19,6 +19,7 @@
 #include "TestCsvParser.h"
 
 #include <QTest>
+#include <QTextStream>
 
 QTEST_GUILESS_MAIN(TestCsvParser)
 
@@ -344,3 +345,30 @@ void TestCsvParser::testUnicode()
     QVERIFY(t.at(0).at(2) == "3śAż");
     QVERIFY(t.at(0).at(3) == "żac");
 }
+
+void TestCsvParser::testRowCallback()
+{
+    // large enough to be decoded in several chunks
+    QTextStream out(file.data());
+    for (int i = 0; i < 50000; ++i) {
+        out << i << ",\"multi\r\nline " << i << "\",\"quote \"\"" << i << "\"\"\"\n";
+    }
+    QVERIFY(parser->parse(file.data()));
+    t = parser->getCsvTable();
+    QCOMPARE(t.size(), 50000);
+
+    CsvTable rows;
+    QVERIFY(parser->parse(file.data(), [&rows](const CsvRow& row) {
+        rows.append(row);
+        return true;
+    }));
+    QCOMPARE(rows, t);
+    QCOMPARE(rows.at(49999).at(0), QString("49999"));
+    QCOMPARE(rows.at(49999).at(1), QString("multi\nline 49999"));
+    QCOMPARE(rows.at(49999).at(2), QString("quote \"49999\""));
+
+    // parsing stops as soon as the callback asks for it
+    int count = 0;
+    QVERIFY(parser->parse(file.data(), [&count](const CsvRow&) { return ++count < 10; }));
+    QCOMPARE(count, 10);
+}
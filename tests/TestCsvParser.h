@@ -57,6 +57,7 @@ private slots:
     void testQuoted();
     void testMultiline();
     void testColumns();
+    void testRowCallback();
 
 private:
     QScopedPointer<QTemporaryFile> file;
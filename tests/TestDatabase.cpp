@@ -19,7 +19,9 @@
 #include "TestDatabase.h"
 
 #include <QRegularExpression>
+#include <QSaveFile>
 #include <QSignalSpy>
+#include <QTemporaryFile>
 #include <QTest>
 
 #include "config-keepassx-tests.h"
@@ -137,6 +139,79 @@ void TestDatabase::testSignals()
     QCOMPARE(spyDiscarded.count(), 1);
 }
 
+void TestDatabase::testFileReplaced()
+{
+    TemporaryFile tempFile;
+    QVERIFY(tempFile.copyFromFile(dbFileName));
+
+    auto db = QSharedPointer<Database>::create();
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(QSharedPointer<PasswordKey>::create("a"));
+    QString error;
+    QVERIFY(db->open(tempFile.fileName(), key, &error));
+
+    // Short delay to allow file system settling to reduce test failures
+    Tools::wait(100);
+
+    QSignalSpy spyFileChanged(db.data(), SIGNAL(databaseFileChanged()));
+
+    // Other files in the same directory are not mistaken for the database
+    QTemporaryFile otherFile(QFileInfo(tempFile.fileName()).absolutePath() + "/XXXXXX.tmp");
+    QVERIFY(otherFile.open());
+    QVERIFY(otherFile.write("other") > 0);
+    otherFile.close();
+    Tools::wait(200);
+    QCOMPARE(spyFileChanged.count(), 0);
+
+    // Atomic saves replace the file by a rename, which has to be noticed every time
+    for (int i = 1; i <= 2; ++i) {
+        QSaveFile saveFile(tempFile.fileName());
+        QVERIFY(saveFile.open(QIODevice::WriteOnly));
+        QVERIFY(saveFile.write(QByteArray("replaced ") + QByteArray::number(i)) > 0);
+        QVERIFY(saveFile.commit());
+        QTRY_COMPARE(spyFileChanged.count(), i);
+        Tools::wait(100);
+    }
+}
+
+void TestDatabase::testBatchUpdate()
+{
+    auto db = QSharedPointer<Database>::create();
+    QSignalSpy spyStarted(db.data(), SIGNAL(batchUpdateStarted()));
+    QSignalSpy spyFinished(db.data(), SIGNAL(batchUpdateFinished()));
+    QSignalSpy spyModified(db.data(), SIGNAL(modified()));
+
+    db->beginBatchUpdate();
+    db->beginBatchUpdate();
+    QVERIFY(db->isBatchUpdating());
+    QCOMPARE(spyStarted.count(), 1);
+
+    for (int i = 0; i < 10; ++i) {
+        auto group = new Group();
+        group->setName(QString("group%1").arg(i));
+        group->setParent(db->rootGroup());
+        auto entry = new Entry();
+        entry->setTitle(QString("entry%1").arg(i));
+        entry->setGroup(group);
+    }
+
+    // The modified signal is held back while the batch is running
+    Tools::wait(300);
+    QVERIFY(db->isModified());
+    QCOMPARE(spyModified.count(), 0);
+
+    db->endBatchUpdate();
+    QVERIFY(db->isBatchUpdating());
+    QCOMPARE(spyFinished.count(), 0);
+
+    db->endBatchUpdate();
+    QVERIFY(!db->isBatchUpdating());
+    QCOMPARE(spyFinished.count(), 1);
+    QTRY_COMPARE(spyModified.count(), 1);
+    Tools::wait(300);
+    QCOMPARE(spyModified.count(), 1);
+}
+
 void TestDatabase::testEmptyRecycleBinOnDisabled()
 {
     QString filename = QString(KEEPASSX_TEST_DATA_DIR).append("/RecycleBinDisabled.kdbx");
@@ -30,6 +30,8 @@ private slots:
     void testOpen();
     void testSave();
     void testSignals();
+    void testFileReplaced();
+    void testBatchUpdate();
     void testEmptyRecycleBinOnDisabled();
     void testEmptyRecycleBinOnNotCreated();
     void testEmptyRecycleBinOnEmpty();
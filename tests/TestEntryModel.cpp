@@ -20,6 +20,7 @@
 #include <QSignalSpy>
 #include <QTest>
 
+#include "core/Config.h"
 #include "core/DatabaseIcons.h"
 #include "core/Group.h"
 #include "crypto/Crypto.h"
@@ -37,6 +38,7 @@ void TestEntryModel::initTestCase()
 {
     qRegisterMetaType<QModelIndex>("QModelIndex");
     QVERIFY(Crypto::init());
+    Config::createTempFileInstance();
 }
 
 void TestEntryModel::test()
@@ -127,6 +129,75 @@ void TestEntryModel::test()
     delete model;
 }
 
+void TestEntryModel::testDisplayCache()
+{
+    Database* db = new Database();
+
+    Entry* entry1 = new Entry();
+    entry1->setGroup(db->rootGroup());
+    entry1->setTitle("title1");
+    entry1->setUsername("user1");
+    entry1->setPassword("password1");
+    entry1->setNotes("first line\nsecond line");
+
+    Entry* entry2 = new Entry();
+    entry2->setGroup(db->rootGroup());
+    entry2->setTitle("title2");
+    entry2->setUsername(QString("{REF:U@I:%1}").arg(entry1->uuidToHex()));
+
+    EntryModel* model = new EntryModel(this);
+    ModelTest* modelTest = new ModelTest(model, this);
+    model->setGroup(db->rootGroup());
+
+    config()->set(Config::GUI_HideUsernames, false);
+    config()->set(Config::GUI_HidePasswords, false);
+    config()->set(Config::Security_HideNotes, false);
+
+    QCOMPARE(model->data(model->index(0, EntryModel::Title)).toString(), QString("title1"));
+    QCOMPARE(model->data(model->index(0, EntryModel::Notes)).toString(), QString("first line"));
+    QCOMPARE(model->data(model->index(1, EntryModel::Username)).toString(), QString("Ref: user1"));
+    QCOMPARE(model->data(model->index(1, EntryModel::Username), Qt::UserRole).toString(), QString("user1"));
+
+    // Changing an entry refreshes its row and the rows referencing it
+    entry1->setTitle("changed");
+    entry1->setUsername("user2");
+    QCOMPARE(model->data(model->index(0, EntryModel::Title)).toString(), QString("changed"));
+    QCOMPARE(model->data(model->index(0, EntryModel::Username)).toString(), QString("user2"));
+    QCOMPARE(model->data(model->index(1, EntryModel::Username)).toString(), QString("Ref: user2"));
+
+    // Config changes apply without waiting for the entry to change
+    QSignalSpy spyDataChanged(model, SIGNAL(dataChanged(QModelIndex, QModelIndex)));
+    config()->set(Config::GUI_HidePasswords, true);
+    QCOMPARE(spyDataChanged.count(), 1);
+    QCOMPARE(model->data(model->index(0, EntryModel::Password)).toString(), QString("\u25cf").repeated(6));
+    QCOMPARE(model->data(model->index(0, EntryModel::Password), Qt::UserRole).toString(), QString("password1"));
+    config()->set(Config::GUI_HidePasswords, false);
+    QCOMPARE(model->data(model->index(0, EntryModel::Password)).toString(), QString("password1"));
+
+    config()->set(Config::Security_HideNotes, true);
+    QCOMPARE(model->data(model->index(0, EntryModel::Notes)).toString(), QString("\u25cf").repeated(6));
+    config()->set(Config::Security_HideNotes, false);
+
+    // References into other groups are refreshed and repainted as well
+    Group* otherGroup = new Group();
+    otherGroup->setParent(db->rootGroup());
+    Entry* entry3 = new Entry();
+    entry3->setGroup(otherGroup);
+    entry3->setPassword("password3");
+    entry2->setPassword(QString("{REF:P@I:%1}").arg(entry3->uuidToHex()));
+    QCOMPARE(model->data(model->index(1, EntryModel::Password)).toString(), QString("Ref: password3"));
+
+    spyDataChanged.clear();
+    entry3->setPassword("password4");
+    QCOMPARE(spyDataChanged.count(), 1);
+    QCOMPARE(spyDataChanged.first().first().value<QModelIndex>().row(), 1);
+    QCOMPARE(model->data(model->index(1, EntryModel::Password)).toString(), QString("Ref: password4"));
+
+    delete modelTest;
+    delete model;
+    delete db;
+}
+
 void TestEntryModel::testAttachmentsModel()
 {
     EntryAttachments* entryAttachments = new EntryAttachments(this);
@@ -355,6 +426,57 @@ void TestEntryModel::testProxyModel()
     delete db;
 }
 
+void TestEntryModel::testProxyModelSort()
+{
+    EntryModel* modelSource = new EntryModel(this);
+    SortFilterHideProxyModel* modelProxy = new SortFilterHideProxyModel(this);
+    modelProxy->setSourceModel(modelSource);
+    modelProxy->setDynamicSortFilter(true);
+    modelProxy->setSortLocaleAware(true);
+    modelProxy->setSortRole(Qt::UserRole);
+
+    ModelTest* modelTest = new ModelTest(modelProxy, this);
+
+    Database* db = new Database();
+    QList<Entry*> entries;
+    for (const auto& title : {"b", "a", "c"}) {
+        auto entry = new Entry();
+        entry->setTitle(title);
+        entry->setGroup(db->rootGroup());
+        entries << entry;
+    }
+
+    modelSource->setGroup(db->rootGroup());
+    modelProxy->sort(EntryModel::Title, Qt::AscendingOrder);
+
+    auto titles = [modelProxy]() {
+        QStringList result;
+        for (int row = 0; row < modelProxy->rowCount(); ++row) {
+            result << modelProxy->data(modelProxy->index(row, EntryModel::Title)).toString();
+        }
+        return result;
+    };
+    QCOMPARE(titles(), QStringList({"a", "b", "c"}));
+
+    // Cached keys are dropped when an entry changes
+    entries.at(1)->setTitle("d");
+    QCOMPARE(titles(), QStringList({"b", "c", "d"}));
+
+    // and when rows are added
+    auto entry = new Entry();
+    entry->setTitle("a");
+    entry->setGroup(db->rootGroup());
+    QCOMPARE(titles(), QStringList({"a", "b", "c", "d"}));
+
+    modelProxy->sort(EntryModel::Title, Qt::DescendingOrder);
+    QCOMPARE(titles(), QStringList({"d", "c", "b", "a"}));
+
+    delete modelTest;
+    delete modelProxy;
+    delete modelSource;
+    delete db;
+}
+
 void TestEntryModel::testDatabaseDelete()
 {
     EntryModel* model = new EntryModel(this);
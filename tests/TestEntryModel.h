@@ -27,12 +27,14 @@ class TestEntryModel : public QObject
 private slots:
     void initTestCase();
     void test();
+    void testDisplayCache();
     void testAttachmentsModel();
     void testAttributesModel();
     void testDefaultIconModel();
     void testCustomIconModel();
     void testAutoTypeAssociationsModel();
     void testProxyModel();
+    void testProxyModelSort();
     void testDatabaseDelete();
 };
 
@@ -33,6 +33,28 @@ void TestFdoSecrets::testDhIetf1024Sha256Aes128CbcPkcs7()
     QVERIFY(cipher.isValid());
 }
 
+void TestFdoSecrets::testEncryptAll()
+{
+    using FdoSecrets::Secret;
+
+    FdoSecrets::DhIetf1024Sha256Aes128CbcPkcs7 cipher(randomGen()->randomArray(128));
+    QVERIFY(cipher.isValid());
+
+    QList<Secret> inputs;
+    for (int i = 0; i != 3; ++i) {
+        inputs << Secret{nullptr, {}, QByteArray(i * 10 + 1, 'a' + i), QStringLiteral("text/plain")};
+    }
+
+    const auto outputs = cipher.encryptAll(inputs);
+    QCOMPARE(outputs.size(), inputs.size());
+    QVERIFY(outputs.at(0).parameters != outputs.at(1).parameters);
+    for (int i = 0; i != inputs.size(); ++i) {
+        QVERIFY(outputs.at(i).value != inputs.at(i).value);
+        QCOMPARE(outputs.at(i).contentType, inputs.at(i).contentType);
+        QCOMPARE(cipher.decrypt(outputs.at(i)).value, inputs.at(i).value);
+    }
+}
+
 void TestFdoSecrets::testCrazyAttributeKey()
 {
     using FdoSecrets::Collection;
@@ -149,3 +149,133 @@ void TestGroupModel::test()
     delete modelTest;
     delete model;
 }
+
+void TestGroupModel::testLazyPopulation()
+{
+    Database* db = new Database();
+    Group* groupRoot = db->rootGroup();
+
+    Group* group1 = new Group();
+    group1->setName("group1");
+    group1->setParent(groupRoot);
+
+    Group* group11 = new Group();
+    group11->setName("group11");
+    group11->setParent(group1);
+
+    GroupModel* model = new GroupModel(db, this);
+
+    QSignalSpy spyAboutToAdd(model, SIGNAL(rowsAboutToBeInserted(QModelIndex, int, int)));
+    QSignalSpy spyAboutToRemove(model, SIGNAL(rowsAboutToBeRemoved(QModelIndex, int, int)));
+    QSignalSpy spyAboutToMove(model, SIGNAL(rowsAboutToBeMoved(QModelIndex, int, int, QModelIndex, int)));
+    QSignalSpy spyDataChanged(model, SIGNAL(dataChanged(QModelIndex, QModelIndex)));
+
+    // Children are only reported once fetched
+    QModelIndex indexRoot = model->index(0, 0);
+    QCOMPARE(model->rowCount(indexRoot), 0);
+    QVERIFY(model->hasChildren(indexRoot));
+    QVERIFY(model->canFetchMore(indexRoot));
+
+    model->fetchMore(indexRoot);
+    QCOMPARE(spyAboutToAdd.count(), 1);
+    QCOMPARE(model->rowCount(indexRoot), 1);
+    QVERIFY(!model->canFetchMore(indexRoot));
+
+    QModelIndex index1 = model->index(0, 0, indexRoot);
+    QCOMPARE(model->data(index1).toString(), QString("group1"));
+    QCOMPARE(model->rowCount(index1), 0);
+    QVERIFY(model->canFetchMore(index1));
+
+    // Changes below groups that were not fetched are not reported
+    Group* group12 = new Group();
+    group12->setName("group12");
+    group12->setParent(group1);
+    group11->setName("changed");
+    group12->setParent(group1, 0);
+    QCOMPARE(spyAboutToAdd.count(), 1);
+    QCOMPARE(spyAboutToMove.count(), 0);
+    QCOMPARE(spyDataChanged.count(), 0);
+
+    // Moving out of a group that was not fetched shows up as an insert
+    group12->setParent(groupRoot);
+    QCOMPARE(spyAboutToAdd.count(), 2);
+    QCOMPARE(model->rowCount(indexRoot), 2);
+    QCOMPARE(model->index(group12).row(), 1);
+
+    // Empty groups are populated right away
+    Group* group2 = new Group();
+    group2->setName("group2");
+    group2->setParent(group12);
+    QCOMPARE(spyAboutToAdd.count(), 3);
+    QCOMPARE(model->rowCount(model->index(group12)), 1);
+
+    // Moving into a group that was not fetched shows up as a removal
+    group12->setParent(group1);
+    QCOMPARE(spyAboutToRemove.count(), 1);
+    QCOMPARE(model->rowCount(indexRoot), 1);
+
+    // Fetching the parents of a group makes its index usable
+    model->fetchParents(group2);
+    QModelIndex index2 = model->index(group2);
+    QCOMPARE(model->data(index2).toString(), QString("group2"));
+    QCOMPARE(model->parent(index2), model->index(group12));
+    QCOMPARE(model->rowCount(index1), 2);
+
+    ModelTest* modelTest = new ModelTest(model, this);
+
+    delete modelTest;
+    delete model;
+    delete db;
+}
+
+void TestGroupModel::testBatchUpdate()
+{
+    Database* db = new Database();
+    Group* group1 = new Group();
+    group1->setName("group1");
+    group1->setParent(db->rootGroup());
+
+    GroupModel* model = new GroupModel(db, this);
+    ModelTest* modelTest = new ModelTest(model, this);
+
+    QSignalSpy spyAboutToAdd(model, SIGNAL(rowsAboutToBeInserted(QModelIndex, int, int)));
+    QSignalSpy spyAboutToRemove(model, SIGNAL(rowsAboutToBeRemoved(QModelIndex, int, int)));
+    QSignalSpy spyDataChanged(model, SIGNAL(dataChanged(QModelIndex, QModelIndex)));
+    QSignalSpy spyAboutToReset(model, SIGNAL(modelAboutToBeReset()));
+    QSignalSpy spyReset(model, SIGNAL(modelReset()));
+
+    // A batch without changes leaves the model alone
+    db->beginBatchUpdate();
+    db->endBatchUpdate();
+    QCOMPARE(spyAboutToReset.count(), 0);
+    QCOMPARE(spyReset.count(), 0);
+
+    db->beginBatchUpdate();
+    QCOMPARE(spyAboutToReset.count(), 0);
+    for (int i = 0; i < 10; ++i) {
+        auto group = new Group();
+        group->setName(QString("group%1").arg(i));
+        group->setParent(group1);
+    }
+    QCOMPARE(spyAboutToReset.count(), 1);
+    group1->setName("changed");
+    delete group1->children().first();
+    db->endBatchUpdate();
+
+    // A single reset replaces the per-group notifications
+    QCOMPARE(spyReset.count(), 1);
+    QCOMPARE(spyAboutToAdd.count(), 0);
+    QCOMPARE(spyAboutToRemove.count(), 0);
+    QCOMPARE(spyDataChanged.count(), 0);
+
+    QModelIndex indexRoot = model->index(0, 0);
+    model->fetchMore(indexRoot);
+    QModelIndex index1 = model->index(0, 0, indexRoot);
+    QCOMPARE(model->data(index1).toString(), QString("changed"));
+    model->fetchMore(index1);
+    QCOMPARE(model->rowCount(index1), 9);
+
+    delete modelTest;
+    delete model;
+    delete db;
+}
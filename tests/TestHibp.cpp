@@ -23,7 +23,10 @@
 
 #include <QBuffer>
 #include <QByteArray>
+#include <QCryptographicHash>
+#include <QDir>
 #include <QList>
+#include <QTemporaryDir>
 #include <QTest>
 
 QTEST_GUILESS_MAIN(TestHibp)
@@ -118,3 +121,106 @@ void TestHibp::testPwned()
     QCOMPARE(findings[1].first, entry4);
     QCOMPARE(findings[1].second, 456);
 }
+
+void TestHibp::testIndex()
+{
+    // not sorted by hash, as in the files ordered by prevalence
+    QByteArray hibpContents("62cdb7020ff920e5aa642c3d4066950dd1f01f4d:456\r\n" // SHA-1 of "bar"
+                            "0BEEC7B5EA3F0FDBC95D0DD47F3C5BC275DA8A33:123\r\n" // SHA-1 of "foo"
+                            "\r\n"
+                            "8843D7F92416211DE9EBB963FF4CE28125932878:7"); // SHA-1 of "foobar"
+    QBuffer hibpBuffer(&hibpContents);
+    QVERIFY(hibpBuffer.open(QIODevice::ReadOnly));
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString indexPath = tempDir.path() + "/hibp.kpxhibp";
+
+    QString error;
+    QVERIFY(HibpOffline::createIndex(hibpBuffer, indexPath, &error));
+    QCOMPARE(error, QString());
+    QVERIFY(HibpOffline::isIndex(indexPath));
+    // only the index itself is left behind
+    QCOMPARE(QDir(tempDir.path()).entryList(QDir::Files), QStringList() << "hibp.kpxhibp");
+
+    Group* root = m_db->rootGroup();
+
+    Entry* entry1 = new Entry();
+    entry1->setPassword("foo");
+    entry1->setGroup(root);
+
+    Entry* entry2 = new Entry();
+    entry2->setPassword("xyz");
+    entry2->setGroup(root);
+
+    Entry* entry3 = new Entry();
+    entry3->setPassword("foobar");
+    entry3->setGroup(root);
+
+    Entry* entry4 = new Entry();
+    entry4->setPassword("bar");
+    m_db->recycleEntry(entry4);
+
+    QFile index(indexPath);
+    QList<QPair<const Entry*, int>> findings;
+    QVERIFY(HibpOffline::indexReport(m_db, index, findings, &error));
+    QCOMPARE(error, QString());
+    QCOMPARE(findings.size(), 2);
+    QCOMPARE(findings[0].first, entry1);
+    QCOMPARE(findings[0].second, 123);
+    QCOMPARE(findings[1].first, entry3);
+    QCOMPARE(findings[1].second, 7);
+
+    QHash<QByteArray, int> counts;
+    const auto bar = QCryptographicHash::hash("bar", QCryptographicHash::Sha1);
+    QVERIFY(HibpOffline::lookup(index, {bar}, counts, &error));
+    QCOMPARE(counts.value(bar), 456);
+}
+
+void TestHibp::testBadIndex()
+{
+    QByteArray hibpContents(TEST_BAD_HIBP_CONTENTS);
+    QBuffer hibpBuffer(&hibpContents);
+    QVERIFY(hibpBuffer.open(QIODevice::ReadOnly));
+
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString indexPath = tempDir.path() + "/hibp.kpxhibp";
+
+    QString error;
+    QVERIFY(!HibpOffline::createIndex(hibpBuffer, indexPath, &error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(!QFile::exists(indexPath));
+
+    // a text file is not an index
+    QFile textFile(tempDir.path() + "/hibp.txt");
+    QVERIFY(textFile.open(QIODevice::WriteOnly));
+    textFile.write(TEST_HIBP_CONTENTS);
+    textFile.close();
+    QVERIFY(!HibpOffline::isIndex(textFile.fileName()));
+
+    QList<QPair<const Entry*, int>> findings;
+    error.clear();
+    QVERIFY(!HibpOffline::indexReport(m_db, textFile, findings, &error));
+    QVERIFY(!error.isEmpty());
+    QCOMPARE(findings.size(), 0);
+
+    // bucket offsets pointing past the records are rejected
+    hibpContents = TEST_HIBP_CONTENTS;
+    QBuffer validBuffer(&hibpContents);
+    QVERIFY(validBuffer.open(QIODevice::ReadOnly));
+    error.clear();
+    QVERIFY(HibpOffline::createIndex(validBuffer, indexPath, &error));
+
+    QFile index(indexPath);
+    QVERIFY(index.open(QIODevice::ReadWrite));
+    QVERIFY(index.seek(24 + 8 * 0x8000));
+    QCOMPARE(index.write(QByteArray(8, '\xff')), qint64(8));
+    index.close();
+
+    QHash<QByteArray, int> counts;
+    const auto foo = QCryptographicHash::hash("foo", QCryptographicHash::Sha1);
+    QVERIFY(!HibpOffline::lookup(index, {foo}, counts, &error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(counts.isEmpty());
+}
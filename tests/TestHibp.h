@@ -34,6 +34,8 @@ private slots:
     void testEmpty();
     void testIoError();
     void testPwned();
+    void testIndex();
+    void testBadIndex();
 
 private:
     QSharedPointer<Database> m_db;
@@ -719,4 +719,15 @@ void TestModified::testBlockModifiedSignal()
     QCOMPARE(spyEntryAttributesModified.count(), 0);
     QCOMPARE(spyEntryAttachmentModified.count(), 0);
     QCOMPARE(spyEntryAutoTypeAssociationsModified.count(), 0);
+
+    // Changes made while the signal is blocked must not leave a pending signal behind
+    QScopedPointer<Database> db2(new Database());
+    QSignalSpy spyDb2Modified(db2.data(), SIGNAL(modified()));
+    db2->setEmitModified(false);
+    db2->metadata()->setName("Blocked");
+    db2->rootGroup()->addEntryWithPath("/def");
+    QVERIFY(db2->isModified());
+    db2->setEmitModified(true);
+    QTest::qWait(300);
+    QCOMPARE(spyDb2Modified.count(), 0);
 }
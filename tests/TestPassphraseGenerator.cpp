@@ -52,3 +52,21 @@ void TestPassphraseGenerator::testWordCase()
     QRegularExpression regex("^([A-Z][a-z]* ?)+$");
     QVERIFY(regex.match(passphrase).hasMatch());
 }
+
+void TestPassphraseGenerator::testBulk()
+{
+    PassphraseGenerator generator;
+    generator.setWordSeparator(" ");
+    generator.setWordCount(4);
+    generator.setWordCase(PassphraseGenerator::TITLECASE);
+    QVERIFY(generator.isValid());
+
+    // Enough words to convert the whole word list up front
+    const auto passphrases = generator.generatePassphrases(5000);
+    QCOMPARE(passphrases.size(), 5000);
+
+    QRegularExpression regex("^[A-Z][a-z-]*( [A-Z][a-z-]*){3}$");
+    for (const auto& passphrase : passphrases) {
+        QVERIFY2(regex.match(passphrase).hasMatch(), qPrintable(passphrase));
+    }
+}
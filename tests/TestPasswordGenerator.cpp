@@ -141,3 +141,20 @@ void TestPasswordGenerator::testLookalikeExclusion()
     regex.setPattern("^[^lBGIO0168﹒]+$");
     QVERIFY(regex.match(password).hasMatch());
 }
+
+void TestPasswordGenerator::testBulk()
+{
+    PasswordGenerator generator;
+    generator.setCharClasses(PasswordGenerator::CharClass::LowerLetters | PasswordGenerator::CharClass::Numbers);
+    generator.setFlags(PasswordGenerator::GeneratorFlag::CharFromEveryGroup);
+    generator.setLength(8);
+    QVERIFY(generator.isValid());
+
+    const auto passwords = generator.generatePasswords(1000);
+    QCOMPARE(passwords.size(), 1000);
+
+    QRegularExpression regex(R"(^(?=.*[a-z])(?=.*[0-9])[a-z0-9]{8}$)");
+    for (const auto& password : passwords) {
+        QVERIFY2(regex.match(password).hasMatch(), qPrintable(password));
+    }
+}
@@ -29,6 +29,7 @@ private slots:
     void testAdditionalChars();
     void testCharClasses();
     void testLookalikeExclusion();
+    void testBulk();
 };
 
 #endif // KEEPASSXC_TESTPASSWORDGENERATOR_H
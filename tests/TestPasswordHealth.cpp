@@ -17,12 +17,57 @@
 
 #include "TestPasswordHealth.h"
 
+#include "core/Database.h"
+#include "core/Group.h"
+#include "core/Metadata.h"
 #include "core/PasswordHealth.h"
+#include "zxcvbn.h"
 
+#include <QScopedPointer>
+#include <QSignalSpy>
 #include <QTest>
 
 QTEST_GUILESS_MAIN(TestPasswordHealth)
 
+namespace
+{
+#ifdef ZXCVBN_HAVE_ARENA
+    struct ArenaDeleter
+    {
+        static void cleanup(ZxcArena_t* arena)
+        {
+            ZxcvbnFreeArena(arena);
+        }
+    };
+    using ArenaPointer = QScopedPointer<ZxcArena_t, ArenaDeleter>;
+
+    /*
+     * Compare the result of ZxcvbnMatchArena() with the one of ZxcvbnMatch()
+     * for the same password, including the list of matches.
+     */
+    void compareWithArena(ZxcArena_t* arena, const QByteArray& password)
+    {
+        ZxcMatch_t* expectedInfo = nullptr;
+        const double expected = ZxcvbnMatch(password.constData(), nullptr, &expectedInfo);
+        ZxcMatch_t* info = nullptr;
+        const double entropy = ZxcvbnMatchArena(arena, password.constData(), nullptr, &info);
+
+        QCOMPARE(entropy, expected);
+        auto expectedMatch = expectedInfo;
+        auto match = info;
+        for (; expectedMatch && match; expectedMatch = expectedMatch->Next, match = match->Next) {
+            QCOMPARE(static_cast<int>(match->Type), static_cast<int>(expectedMatch->Type));
+            QCOMPARE(match->Begin, expectedMatch->Begin);
+            QCOMPARE(match->Length, expectedMatch->Length);
+            QCOMPARE(match->Entrpy, expectedMatch->Entrpy);
+        }
+        QVERIFY(!expectedMatch);
+        QVERIFY(!match);
+        ZxcvbnFreeInfo(expectedInfo);
+    }
+#endif
+} // namespace
+
 void TestPasswordHealth::initTestCase()
 {
 }
@@ -64,3 +109,147 @@ void TestPasswordHealth::testNoDb()
     QVERIFY(excellent.scoreReason().isEmpty());
     QVERIFY(excellent.scoreDetails().isEmpty());
 }
+
+void TestPasswordHealth::testBatch()
+{
+    auto db = QSharedPointer<Database>::create();
+    QList<const Entry*> entries;
+    for (const auto& pwd : {"secret", "Yohb2ChR4", "secret", "MIhIN9UKrgtPL2hp", ""}) {
+        auto entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setTitle(QString("Entry %1").arg(entries.size()));
+        entry->setPassword(pwd);
+        entry->setGroup(db->rootGroup());
+        entries << entry;
+    }
+
+    const HealthChecker checker(db);
+    const auto healths = checker.evaluate(entries);
+    QCOMPARE(healths.size(), entries.size());
+    for (int i = 0; i < entries.size(); ++i) {
+        const auto single = checker.evaluate(entries[i]);
+        QCOMPARE(healths[i]->score(), single->score());
+        QCOMPARE(healths[i]->entropy(), single->entropy());
+        QCOMPARE(healths[i]->scoreReason(), single->scoreReason());
+    }
+
+    // Reused passwords are reported on both entries
+    QVERIFY(healths[0]->scoreReason().contains("Password is used 2 time(s)"));
+    QVERIFY(healths[2]->scoreReason().contains("Password is used 2 time(s)"));
+    QVERIFY(!healths[1]->scoreReason().contains("Password is used"));
+}
+
+void TestPasswordHealth::testReuseIndex()
+{
+    auto db = QSharedPointer<Database>::create();
+    db->metadata()->setRecycleBinEnabled(true);
+    auto index = db->reuseIndex();
+    QSignalSpy spyChanged(index, SIGNAL(reuseChanged()));
+
+    QList<Entry*> entries;
+    for (const auto& pwd : {"secret", "secret", "other"}) {
+        auto entry = new Entry();
+        entry->setUuid(QUuid::createUuid());
+        entry->setPassword(pwd);
+        entry->setGroup(db->rootGroup());
+        entries << entry;
+    }
+
+    QCOMPARE(index->count(entries[0]), 2);
+    QCOMPARE(index->count(entries[1]), 2);
+    QCOMPARE(index->count(entries[2]), 1);
+    QCOMPARE(index->entries("secret").size(), 2);
+    QVERIFY(index->entries("unused").isEmpty());
+
+    // Changing a password updates the index without a rebuild
+    spyChanged.clear();
+    entries[2]->setPassword("secret");
+    QCOMPARE(spyChanged.count(), 1);
+    QCOMPARE(index->count(entries[0]), 3);
+    QCOMPARE(index->entries("other").size(), 0);
+
+    entries[0]->setPassword("");
+    QCOMPARE(index->count(entries[0]), 0);
+    QCOMPARE(index->count(entries[1]), 2);
+
+    // Recycled and deleted entries are not counted
+    db->recycleEntry(entries[1]);
+    QCOMPARE(index->count(entries[1]), 0);
+    QCOMPARE(index->count(entries[2]), 1);
+
+    auto entry = new Entry();
+    entry->setUuid(QUuid::createUuid());
+    entry->setPassword("secret");
+    entry->setGroup(db->rootGroup());
+    QCOMPARE(index->count(entries[2]), 2);
+    delete entry;
+    QCOMPARE(index->count(entries[2]), 1);
+
+    // A new group structure rebuilds the index
+    auto group = new Group();
+    group->setUuid(QUuid::createUuid());
+    group->setParent(db->rootGroup());
+    entries[0]->setGroup(group);
+    entries[0]->setPassword("secret");
+    QCOMPARE(index->count(entries[2]), 2);
+    QCOMPARE(index->entries("secret").size(), 2);
+}
+
+void TestPasswordHealth::testMatchArena_data()
+{
+    QTest::addColumn<QString>("password");
+
+    // the same passwords as the estimate command tests
+    QTest::newRow("Dictionary") << "password";
+    QTest::newRow("Spatial") << "zxcv";
+    QTest::newRow("Spatial(Rep)") << "sdfgsdfg";
+    QTest::newRow("Dictionary / Sequence") << "password123";
+    QTest::newRow("Dict+Leet") << "p455w0rd";
+    QTest::newRow("Dictionary(Rep)") << "hellohello";
+    QTest::newRow("Sequence(Rep) / Dictionary") << "456456foobar";
+    QTest::newRow("Bruteforce(Rep) / Bruteforce") << "xzxzy";
+    QTest::newRow("Dictionary / Date(Rep)") << "pass20182018";
+    QTest::newRow("Dictionary / Date / Bruteforce") << "mypass2018-2";
+    QTest::newRow("Strong Password") << "E*!%.Qw{t.X,&bafw)\"Q!ah$%;U/";
+    QTest::newRow("Strong Passphrase") << "squint wooing resupply dangle isolation axis headsman";
+}
+
+void TestPasswordHealth::testMatchArena()
+{
+#ifdef ZXCVBN_HAVE_ARENA
+    QFETCH(QString, password);
+
+    ArenaPointer arena(ZxcvbnNewArena());
+    compareWithArena(arena.data(), password.toUtf8());
+#else
+    QSKIP("zxcvbn is built without match arenas");
+#endif
+}
+
+void TestPasswordHealth::testMatchArenaReuse()
+{
+#ifdef ZXCVBN_HAVE_ARENA
+    // The long passwords need more matches than the arena holds at first
+    const QList<QByteArray> passwords{"password",
+                                      "squint wooing resupply dangle isolation axis headsman",
+                                      "zxcv",
+                                      QByteArray("correcthorsebatterystaple").repeated(12),
+                                      "",
+                                      "mypass2018-2",
+                                      QByteArray("prompter-ream-oversleep-step-extortion-quarrel ").repeated(6),
+                                      "p455w0rd"};
+
+    ArenaPointer arena(ZxcvbnNewArena());
+    for (int round = 0; round < 2; ++round) {
+        for (const auto& password : passwords) {
+            compareWithArena(arena.data(), password);
+            if (QTest::currentTestFailed()) {
+                qWarning("Arena result differs for a password of length %d", password.size());
+                return;
+            }
+        }
+    }
+#else
+    QSKIP("zxcvbn is built without match arenas");
+#endif
+}
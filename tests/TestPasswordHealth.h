@@ -27,6 +27,11 @@ class TestPasswordHealth : public QObject
 private slots:
     void initTestCase();
     void testNoDb();
+    void testBatch();
+    void testReuseIndex();
+    void testMatchArena_data();
+    void testMatchArena();
+    void testMatchArenaReuse();
 };
 
 #endif // KEEPASSX_TESTPASSWORDHEALTH_H
@@ -21,6 +21,7 @@
 #include "crypto/Random.h"
 
 #include <QTest>
+#include <QVector>
 
 QTEST_GUILESS_MAIN(TestRandomGenerator)
 
@@ -58,3 +59,25 @@ void TestRandomGenerator::testUIntRange()
         QVERIFY(rand < 200);
     }
 }
+
+void TestRandomGenerator::testBuffer()
+{
+    RandomBuffer buffer(16);
+    QVERIFY(buffer.randomUInt(0) == 0);
+    QVERIFY(buffer.randomUInt(1) == 0);
+
+    // Cover the one, two and four byte draws and refills of the small buffer
+    QVector<int> counts(6);
+    for (int i = 0; i < 6000; ++i) {
+        const auto rand = buffer.randomUInt(6);
+        QVERIFY(rand < 6);
+        ++counts[rand];
+        QVERIFY(buffer.randomUInt(1000) < 1000);
+        QVERIFY(buffer.randomUInt(100000U) < 100000U);
+    }
+
+    // Every value should come up, far from a biased or broken distribution
+    for (int count : counts) {
+        QVERIFY(count > 500);
+    }
+}
@@ -17,6 +17,8 @@
 
 #include "TestSSHAgent.h"
 #include "core/Config.h"
+#include "core/Database.h"
+#include "core/Group.h"
 #include "crypto/Crypto.h"
 #include "sshagent/KeeAgentSettings.h"
 #include "sshagent/SSHAgent.h"
@@ -79,9 +81,9 @@ void TestSSHAgent::initTestCase()
                                       "MEBQY=\n"
                                       "-----END OPENSSH PRIVATE KEY-----\n");
 
-    const QByteArray keyData = keyString.toLatin1();
+    m_keyData = keyString.toLatin1();
 
-    QVERIFY(m_key.parsePKCS1PEM(keyData));
+    QVERIFY(m_key.parsePKCS1PEM(m_keyData));
 }
 
 void TestSSHAgent::testConfiguration()
@@ -211,6 +213,38 @@ void TestSSHAgent::testConfirmConstraint()
     QVERIFY(agent.checkIdentity(m_key, keyInAgent) && !keyInAgent);
 }
 
+void TestSSHAgent::testDatabaseUnlockLock()
+{
+    SSHAgent agent;
+    agent.setEnabled(true);
+    agent.setAuthSockOverride(m_agentSocketFileName);
+
+    QVERIFY(agent.isAgentRunning());
+
+    QSharedPointer<Database> db(new Database());
+    auto entry = new Entry();
+    entry->setGroup(db->rootGroup());
+    entry->attachments()->set("id_ed25519", m_keyData);
+
+    KeeAgentSettings settings;
+    settings.setAllowUseOfSshKey(true);
+    settings.setAddAtDatabaseOpen(true);
+    settings.setRemoveAtDatabaseClose(true);
+    settings.setSelectedType("attachment");
+    settings.setAttachmentName("id_ed25519");
+    settings.toEntry(entry);
+
+    bool keyInAgent;
+    QVERIFY(agent.checkIdentity(m_key, keyInAgent) && !keyInAgent);
+
+    // keys of the database are added on unlock and removed on lock
+    agent.databaseUnlocked(db);
+    QVERIFY(agent.checkIdentity(m_key, keyInAgent) && keyInAgent);
+
+    agent.databaseLocked(db);
+    QVERIFY(agent.checkIdentity(m_key, keyInAgent) && !keyInAgent);
+}
+
 void TestSSHAgent::cleanupTestCase()
 {
     if (m_agentProcess.state() != QProcess::NotRunning) {
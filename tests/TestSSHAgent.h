@@ -34,6 +34,7 @@ private slots:
     void testRemoveOnClose();
     void testLifetimeConstraint();
     void testConfirmConstraint();
+    void testDatabaseUnlockLock();
     void cleanupTestCase();
 
 private:
@@ -41,6 +42,7 @@ private:
     QString m_agentSocketFileName;
     QProcess m_agentProcess;
     OpenSSHKey m_key;
+    QByteArray m_keyData;
     QUuid m_uuid;
 };
 
@@ -17,12 +17,18 @@
 
 #include "TestSharing.h"
 
+#include <QTemporaryDir>
 #include <QTest>
 #include <QXmlStreamReader>
 
+#include "core/Config.h"
+#include "core/Group.h"
 #include "crypto/Crypto.h"
 #include "crypto/Random.h"
+#include "keeshare/KeeShare.h"
 #include "keeshare/KeeShareSettings.h"
+#include "keeshare/ShareObserver.h"
+#include "keys/PasswordKey.h"
 
 #include <botan/rsa.h>
 
@@ -38,6 +44,8 @@ Q_DECLARE_METATYPE(QList<KeeShareSettings::ScopedCertificate>)
 void TestSharing::initTestCase()
 {
     QVERIFY(Crypto::init());
+    Config::createTempFileInstance();
+    KeeShare::init(this);
 }
 
 void TestSharing::testNullObjects()
@@ -245,6 +253,71 @@ void TestSharing::testSettingsSerialization_data()
                        << QList<KeeShareSettings::ScopedCertificate>({certificate1});
 }
 
+void TestSharing::testExportOnlyChangedShares()
+{
+    QTemporaryDir tempDir;
+    QVERIFY(tempDir.isValid());
+    const QString sharePath = tempDir.path() + "/share.kdbx";
+
+    KeeShareSettings::Active active;
+    active.out = true;
+    KeeShare::setActive(active);
+
+    auto key = QSharedPointer<CompositeKey>::create();
+    key->addKey(QSharedPointer<PasswordKey>::create("a"));
+    auto db = QSharedPointer<Database>::create();
+    QVERIFY(db->setKey(key));
+
+    auto* sharedGroup = new Group();
+    sharedGroup->setName("Shared");
+    sharedGroup->setParent(db->rootGroup());
+    auto* sharedEntry = new Entry();
+    sharedEntry->setTitle("Shared entry");
+    sharedEntry->setGroup(sharedGroup);
+
+    KeeShareSettings::Reference reference;
+    reference.type = KeeShareSettings::ExportTo;
+    reference.path = "share.kdbx";
+    reference.password = "b";
+    KeeShare::setReferenceTo(sharedGroup, reference);
+
+    QVERIFY(db->saveAs(tempDir.path() + "/database.kdbx"));
+
+    ShareObserver observer(db);
+    QStringList messages;
+    connect(&observer, &ShareObserver::sharingMessage, [&messages](QString message, MessageWidget::MessageType) {
+        messages << message;
+    });
+
+    // The first save after opening always writes the shares
+    db->markAsModified();
+    QVERIFY(db->save());
+    QCOMPARE(messages.size(), 1);
+    QVERIFY(QFile::exists(sharePath));
+
+    // Changes outside of the shared group leave the share alone
+    auto* privateEntry = new Entry();
+    privateEntry->setTitle("Private entry");
+    privateEntry->setGroup(db->rootGroup());
+    QVERIFY(db->save());
+    QCOMPARE(messages.size(), 1);
+
+    sharedEntry->beginUpdate();
+    sharedEntry->setPassword("changed");
+    sharedEntry->endUpdate();
+    QVERIFY(db->save());
+    QCOMPARE(messages.size(), 2);
+
+    // A removed container is written again even without changes
+    QVERIFY(QFile::remove(sharePath));
+    db->markAsModified();
+    QVERIFY(db->save());
+    QCOMPARE(messages.size(), 3);
+    QVERIFY(QFile::exists(sharePath));
+
+    KeeShare::setActive(KeeShareSettings::Active());
+}
+
 const QSharedPointer<Botan::RSA_PrivateKey> TestSharing::stubkey(int index)
 {
     static QMap<int, QSharedPointer<Botan::RSA_PrivateKey>> keys;
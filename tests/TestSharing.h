@@ -38,6 +38,7 @@ private slots:
     void testReferenceSerialization_data();
     void testSettingsSerialization();
     void testSettingsSerialization_data();
+    void testExportOnlyChangedShares();
 
 private:
     const QSharedPointer<Botan::RSA_PrivateKey> stubkey(int index = 0);
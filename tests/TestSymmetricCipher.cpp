@@ -455,3 +455,31 @@ void TestSymmetricCipher::testStreamReset()
     writer.close();
     QCOMPARE(buffer.buffer().size(), 16);
 }
+
+void TestSymmetricCipher::testRestart()
+{
+    QByteArray key = QByteArray::fromHex("2b7e151628aed2a6abf7158809cf4f3c");
+    QByteArray iv1 = QByteArray::fromHex("000102030405060708090a0b0c0d0e0f");
+    QByteArray iv2 = QByteArray::fromHex("0f0e0d0c0b0a09080706050403020100");
+
+    // restarting with another IV gives the same result as a newly initialized cipher
+    QByteArray expected1("first message");
+    QByteArray expected2("second message");
+    SymmetricCipher fresh;
+    QVERIFY(fresh.init(SymmetricCipher::Aes128_CBC, SymmetricCipher::Encrypt, key, iv1));
+    QVERIFY(fresh.finish(expected1));
+    QVERIFY(fresh.init(SymmetricCipher::Aes128_CBC, SymmetricCipher::Encrypt, key, iv2));
+    QVERIFY(fresh.finish(expected2));
+
+    QByteArray data1("first message");
+    QByteArray data2("second message");
+    SymmetricCipher cipher;
+    QVERIFY(cipher.init(SymmetricCipher::Aes128_CBC, SymmetricCipher::Encrypt, key, iv1));
+    QVERIFY(cipher.finish(data1));
+    QVERIFY(cipher.restart(iv2));
+    QVERIFY(cipher.finish(data2));
+    QCOMPARE(data1, expected1);
+    QCOMPARE(data2, expected2);
+
+    QVERIFY(!cipher.restart(QByteArray(3, '\0')));
+}
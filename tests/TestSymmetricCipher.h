@@ -39,6 +39,7 @@ private slots:
     void testChaCha20();
     void testPadding();
     void testStreamReset();
+    void testRestart();
 };
 
 #endif // KEEPASSX_TESTSYMMETRICCIPHER_H
@@ -31,6 +31,8 @@
 #include <QToolBar>
 
 #include "config-keepassx-tests.h"
+#include "core/Merger.h"
+#include "core/Metadata.h"
 #include "core/Tools.h"
 #include "crypto/Crypto.h"
 #include "gui/ApplicationSettingsWidget.h"
@@ -979,6 +981,47 @@ void TestGui::testSearch()
     QTRY_COMPARE(m_dbWidget->currentMode(), DatabaseWidget::Mode::ViewMode);
 }
 
+void TestGui::testSearchSurvivesMerge()
+{
+    addCannedEntries();
+
+    auto* toolBar = m_mainWindow->findChild<QToolBar*>("toolBar");
+    auto* searchWidget = toolBar->findChild<SearchWidget*>("SearchWidget");
+    auto* searchTextEdit = searchWidget->findChild<QLineEdit*>("searchEdit");
+    auto* entryView = m_dbWidget->findChild<EntryView*>("entryView");
+
+    QTest::mouseClick(searchTextEdit, Qt::LeftButton);
+    QTRY_VERIFY(searchTextEdit->hasFocus());
+    QTest::keyClicks(searchTextEdit, "some");
+    QTRY_VERIFY(m_dbWidget->isSearchActive());
+    QTRY_COMPARE(entryView->model()->rowCount(), 3);
+    Entry* entry = entryView->entryFromIndex(entryView->model()->index(1, 1));
+    entryView->setCurrentEntry(entry);
+    QCOMPARE(entryView->currentEntry(), entry);
+
+    // Merging an unchanged copy, as KeeShare imports and reloads often do, keeps the view as it is
+    QScopedPointer<Database> dbSource(new Database());
+    dbSource->setRootGroup(m_db->rootGroup()->clone(Entry::CloneIncludeHistory, Group::CloneIncludeEntries));
+    dbSource->metadata()->customData()->copyDataFrom(m_db->metadata()->customData());
+    Merger merger(dbSource.data(), m_db.data());
+    QCOMPARE(merger.merge(), QStringList());
+    QApplication::processEvents();
+    QVERIFY(m_dbWidget->isSearchActive());
+    QCOMPARE(searchTextEdit->text(), QString("some"));
+    QCOMPARE(entryView->model()->rowCount(), 3);
+    QCOMPARE(entryView->currentEntry(), entry);
+
+    // Merging changes does not end the search either
+    auto* mergedEntry = new Entry();
+    mergedEntry->setUuid(QUuid::createUuid());
+    mergedEntry->setTitle("merged");
+    mergedEntry->setGroup(dbSource->rootGroup());
+    QVERIFY(!merger.merge().isEmpty());
+    QApplication::processEvents();
+    QVERIFY(m_dbWidget->isSearchActive());
+    QCOMPARE(searchTextEdit->text(), QString("some"));
+}
+
 void TestGui::testDeleteEntry()
 {
     // Add canned entries for consistent testing
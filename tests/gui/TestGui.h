@@ -49,6 +49,7 @@ private slots:
     void testDicewareEntryEntropy();
     void testTotp();
     void testSearch();
+    void testSearchSurvivesMerge();
     void testDeleteEntry();
     void testCloneEntry();
     void testEntryPlaceholders();
@@ -334,6 +334,71 @@ void TestGuiFdoSecrets::testServiceSearch()
     }
 }
 
+void TestGuiFdoSecrets::testServiceSearchAfterChange()
+{
+    auto service = enableService();
+    VERIFY(service);
+    auto coll = getDefaultCollection(service);
+    VERIFY(coll);
+    auto item = getFirstItem(coll);
+    VERIFY(item);
+    auto itemObj = m_plugin->dbus()->pathToObject<Item>(QDBusObjectPath(item->path()));
+    VERIFY(itemObj);
+    auto entry = itemObj->backend();
+    VERIFY(entry);
+
+    entry->attributes()->set("fdosecrets-test", "1");
+    {
+        DBUS_GET(found, coll->SearchItems({{"fdosecrets-test", "1"}}));
+        COMPARE(found, {QDBusObjectPath(item->path())});
+    }
+
+    // changed and removed attributes are no longer found
+    entry->attributes()->set("fdosecrets-test", "2");
+    {
+        DBUS_GET(found, coll->SearchItems({{"fdosecrets-test", "1"}}));
+        COMPARE(found, {});
+    }
+    {
+        DBUS_GET(found, coll->SearchItems({{"fdosecrets-test", "2"}}));
+        COMPARE(found, {QDBusObjectPath(item->path())});
+    }
+    entry->attributes()->remove("fdosecrets-test");
+    {
+        DBUS_GET(found, coll->SearchItems({{"fdosecrets-test", "2"}}));
+        COMPARE(found, {});
+    }
+
+    // placeholders are resolved before matching
+    entry->setUsername("fdosecrets-user");
+    entry->setTitle("{USERNAME}");
+    {
+        DBUS_GET(found, coll->SearchItems({{"Title", "fdosecrets-user"}}));
+        COMPARE(found, {QDBusObjectPath(item->path())});
+    }
+    {
+        DBUS_GET(found, coll->SearchItems({{"Title", "{USERNAME}"}}));
+        COMPARE(found, {});
+    }
+
+    // results are in tree order, not in the order the items were indexed
+    DBUS_GET(itemPaths, coll->items());
+    QHash<const Entry*, QDBusObjectPath> entryPaths;
+    for (const auto& path : itemPaths) {
+        auto obj = m_plugin->dbus()->pathToObject<Item>(path);
+        VERIFY(obj);
+        entryPaths.insert(obj->backend(), path);
+    }
+    auto entries = m_db->rootGroup()->entriesRecursive(false);
+    VERIFY(entries.size() >= 2);
+    entries[1]->attributes()->set("fdosecrets-order", "1");
+    entries[0]->attributes()->set("fdosecrets-order", "1");
+    {
+        DBUS_GET(found, coll->SearchItems({{"fdosecrets-order", "1"}}));
+        COMPARE(found, QList<QDBusObjectPath>({entryPaths.value(entries[0]), entryPaths.value(entries[1])}));
+    }
+}
+
 void TestGuiFdoSecrets::testServiceUnlock()
 {
     lockDatabaseInBackend();
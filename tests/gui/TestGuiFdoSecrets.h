@@ -64,6 +64,7 @@ private slots:
     void testServiceEnable();
     void testServiceEnableNoExposedDatabase();
     void testServiceSearch();
+    void testServiceSearchAfterChange();
     void testServiceUnlock();
     void testServiceUnlockItems();
     void testServiceLock();
@@ -21,6 +21,7 @@
 
 #include "core/Group.h"
 #include "crypto/Crypto.h"
+#include <QBuffer>
 #include <QTest>
 
 void TestGuiPixmaps::initTestCase()
@@ -81,4 +82,54 @@ void TestGuiPixmaps::testGroupIcons()
     QCOMPARE(pixmap.cacheKey(), db->metadata()->customIconPixmap(iconUuid).cacheKey());
 }
 
+void TestGuiPixmaps::testSharedCustomIcons()
+{
+    QScopedPointer<Database> db1(new Database());
+    QScopedPointer<Database> db2(new Database());
+
+    QImage icon(2, 1, QImage::Format_RGB32);
+    icon.setPixel(0, 0, qRgb(0, 0, 0));
+    icon.setPixel(1, 0, qRgb(0, 50, 0));
+
+    QUuid iconUuid1 = QUuid::createUuid();
+    QUuid iconUuid2 = QUuid::createUuid();
+    QUuid iconUuid3 = QUuid::createUuid();
+    db1->metadata()->addCustomIcon(iconUuid1, icon);
+    db1->metadata()->addCustomIcon(iconUuid2, db1->metadata()->customIconData(iconUuid1));
+    db2->metadata()->addCustomIcon(iconUuid3, icon);
+
+    // Identical icons share their data and are looked up by it
+    QCOMPARE(db1->metadata()->customIconData(iconUuid2).constData(),
+             db1->metadata()->customIconData(iconUuid1).constData());
+    QCOMPARE(db1->metadata()->findCustomIcon(icon), iconUuid2);
+    QCOMPARE(db1->metadata()->customIcon(iconUuid1).pixel(1, 0), qRgb(0, 50, 0));
+
+    // Icons written by other encoders are found by their pixels
+    QImage otherIcon(2, 1, QImage::Format_RGB32);
+    otherIcon.setPixel(0, 0, qRgb(0, 0, 0));
+    otherIcon.setPixel(1, 0, qRgb(50, 0, 0));
+    QImage taggedIcon(otherIcon);
+    taggedIcon.setText("Software", "Other encoder");
+    QByteArray taggedData;
+    QBuffer buffer(&taggedData);
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY(taggedIcon.save(&buffer, "PNG"));
+    buffer.close();
+    QUuid iconUuid4 = QUuid::createUuid();
+    db1->metadata()->addCustomIcon(iconUuid4, taggedData);
+    QCOMPARE(db1->metadata()->findCustomIcon(otherIcon), iconUuid4);
+
+    // The decoded pixmap is shared by all databases
+    auto pixmap = db1->metadata()->customIconPixmap(iconUuid1);
+    QVERIFY(!pixmap.isNull());
+    QCOMPARE(db1->metadata()->customIconPixmap(iconUuid2).cacheKey(), pixmap.cacheKey());
+    QCOMPARE(db2->metadata()->customIconPixmap(iconUuid3).cacheKey(), pixmap.cacheKey());
+    QVERIFY(db1->metadata()->customIconPixmap(iconUuid1, IconSize::Large).cacheKey() != pixmap.cacheKey());
+
+    // Removing one copy keeps the other intact
+    db1->metadata()->removeCustomIcon(iconUuid2);
+    QVERIFY(db1->metadata()->hasCustomIcon(iconUuid1));
+    QCOMPARE(db1->metadata()->customIcon(iconUuid1).pixel(0, 0), qRgb(0, 0, 0));
+}
+
 QTEST_MAIN(TestGuiPixmaps)
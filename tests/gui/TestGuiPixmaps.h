@@ -29,6 +29,7 @@ private slots:
     void testDatabaseIcons();
     void testEntryIcons();
     void testGroupIcons();
+    void testSharedCustomIcons();
 };
 
 #endif // KEEPASSX_TESTGUIPIXMAPS_H